@@ -32,6 +32,8 @@ ATT_Block::ATT_Block()
 
 	BoxComp->SetCollisionResponseToChannel(ECC_Visibility, ECollisionResponse::ECR_Block);
 	BoxComp->SetCollisionResponseToChannel(ECC_Camera, ECollisionResponse::ECR_Overlap);
+
+	blockStats = nullptr;
 	   
 }
 
@@ -49,7 +51,7 @@ void ATT_Block::SetBlockStats(FTT_Struct_Block* inputStats)
 {
 	if (inputStats)
 	{
-		blockStats = *inputStats;
+		blockStats = inputStats;
 	}
 	else
 	{
@@ -59,12 +61,17 @@ void ATT_Block::SetBlockStats(FTT_Struct_Block* inputStats)
 
 FTT_Struct_Block* ATT_Block::GetBlockStats()
 {
-	return &blockStats;
+	return blockStats;
 }
 
 const FTT_Struct_Block ATT_Block::GetBlockData()
 {
-	return blockStats;
+	return blockStats ? *blockStats : FTT_Struct_Block();
+}
+
+UStaticMeshComponent* ATT_Block::GetBlockMesh() const
+{
+	return BlockMesh;
 }
 
 void ATT_Block::SetBlockManager(ATT_BlockManager* BlockManager)
@@ -90,32 +97,56 @@ ATT_GridManager* ATT_Block::GetGridManager()
 	}
 }
 
+void ATT_Block::SetBlockHandle(FTT_BlockHandle handle)
+{
+	blockHandle = handle;
+}
+
+FTT_BlockHandle ATT_Block::GetBlockHandle() const
+{
+	return blockHandle;
+}
+
 void ATT_Block::SetCentralTileID(int tileID)
 {
 	centralTileID = tileID;
 }
 
-void ATT_Block::SetBlockTileIDs(TArray<int> TileIDs)
+void ATT_Block::SetBlockTileRect(const FTT_TileRect& TileRect)
 {
-	blockTileIDs = TileIDs;
+	blockTileRect = TileRect;
+}
+
+FTT_TileRect ATT_Block::GetBlockTileRect() const
+{
+	return blockTileRect;
 }
 
 TArray<int> ATT_Block::GetBlockTileIDs()
 {
+	TArray<int> blockTileIDs;
+	if (ATT_GridManager* gridManager = GetGridManager())
+	{
+		blockTileIDs.Reserve(blockTileRect.GetArea());
+		for (int tileID : FTT_TileRectView(gridManager->GetGridTopology(), blockTileRect))
+		{
+			blockTileIDs.Add(tileID);
+		}
+	}
 	return blockTileIDs;
 }
 
 void ATT_Block::GetOccupiedTileIDs(int32& centralTile, TArray<int32>& tileZone)
 {
 	centralTile = centralTileID;
-	tileZone = blockTileIDs;
+	tileZone = GetBlockTileIDs();
 }
 
 // Block positioning
 
 void ATT_Block::SetBlockPosition()
 {
-	if (&blockStats == nullptr)
+	if (!blockStats)
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Blockstats not valid, cannot adjust AnchorPosition. This check is based on block's name in the data table, if empty this error will always trigger."));
 		return;
@@ -127,6 +158,11 @@ void ATT_Block::SetBlockPosition()
 		return;
 	}
 	
+	blockAnchorLocation = GetBlockAnchorLocation(blockStats->Size_X, blockStats->Size_Y, blockRotation.Yaw, distanceBetweenTiles);
+}
+
+FVector ATT_Block::GetBlockAnchorLocation(int sizeX, int sizeY, float yaw, float tileDistance)
+{
 	/*
 	The blocks have a relative location of 0,0,0 which follows the mouse cursor. This means that: 
 	- If the block has an even XSize and YSize, the block will need to be re-ajusted to appear aligned on the grid.
@@ -136,31 +172,30 @@ void ATT_Block::SetBlockPosition()
 	int newX;
 	int newY;
 
-	if (blockStats.Size_X % 2 == 0)
+	if (sizeX % 2 == 0)
 	{
-		newX = distanceBetweenTiles / 2;
+		newX = tileDistance / 2;
 	}
 	else
 	{
 		newX = 0;
 	}
 
-	if (blockStats.Size_Y % 2 == 0)
+	if (sizeY % 2 == 0)
 	{
-		newY = distanceBetweenTiles / 2;
+		newY = tileDistance / 2;
 	}
 	else
 	{
 		newY = 0;
 	}
 
-	if (FMath::IsNearlyEqual(abs(blockRotation.Yaw), 90, 0.1f))
+	if (FMath::IsNearlyEqual(abs(yaw), 90, 0.1f))
 	{
-		blockAnchorLocation = FVector(newY, newX, 0);
-		return;
+		return FVector(newY, newX, 0);
 	}
 
-	blockAnchorLocation = FVector(newX, newY, 0);
+	return FVector(newX, newY, 0);
 }
 
 void ATT_Block::SetBlockRotation(FRotator Rotation, float blockRotaSpeed)
@@ -206,8 +241,40 @@ void ATT_Block::EditModeTick()
 
 /*---------- Block Actions ----------*/
 
+void ATT_Block::DeactivateBlock()
+{
+	if (isInEditingMode)
+	{
+		StopEditMode();
+	}
+
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+
+	blockStats = nullptr;
+	blockHandle = FTT_BlockHandle();
+	blockTileRect = FTT_TileRect();
+	centralTileID = -1;
+
+	blockRotation = FRotator(0, 0, 0);
+	blockAnchorLocation = FVector(0, 0, 0);
+	UpdateBlockRotationAndLocation();
+}
+
+void ATT_Block::ReactivateBlock(const FTransform& blockTransform)
+{
+	SetActorTransform(blockTransform);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+}
+
 void ATT_Block::OnDestroyBlock_Implementation()
 {
+	if (blockManager && blockManager->ReleaseBlockActor(this))
+	{
+		return;
+	}
+
 	this->Destroy();
 }
 
@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_BlockCatalog.h"
+#include "Engine/DataTable.h"
+
+bool FTT_BlockCatalog::Build(UDataTable* dataTable)
+{
+	Reset();
+
+	if (!dataTable)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Cannot build the block catalog, the data table is not valid."));
+		return false;
+	}
+
+	const FString contextString;
+	for (const FName& name : dataTable->GetRowNames())
+	{
+		const FString rowName = name.ToString();
+		int32 blockID;
+		if (!ParseBlockID(rowName, blockID))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Row %s of the block data table isn't a blockID between 0 and %d, skipping it."), *rowName, GetMaxBlockID());
+			continue;
+		}
+
+		FTT_Struct_Block* row = dataTable->FindRow<FTT_Struct_Block>(name, contextString);
+		if (!row)
+		{
+			continue;
+		}
+
+		if (blockID >= Records.Num())
+		{
+			Records.SetNum(blockID + 1);
+			Stats.SetNumZeroed(blockID + 1);
+		}
+
+		FTT_BlockRecord& record = Records[blockID];
+		if (record.IsValid())
+		{
+			UE_LOG(LogTemp, Warning, TEXT("Row %s of the block data table uses blockID %d twice, skipping it."), *rowName, blockID);
+			continue;
+		}
+
+		record.BlockID = blockID;
+		record.SizeX = row->Size_X;
+		record.SizeY = row->Size_Y;
+		record.Type = row->Block_Type;
+		record.GridColour = row->Grid_Colour;
+		record.BlockClass = row->BlockClass;
+		record.RequiresActor = row->Requires_Actor;
+
+		Stats[blockID] = row;
+		BlockIDs.Add(blockID);
+	}
+
+	BlockIDs.Sort();
+	BuildCandidateIndex();
+	return true;
+}
+
+bool FTT_BlockCatalog::ParseBlockID(const FString& rowName, int32& OutBlockID)
+{
+	OutBlockID = INDEX_NONE;
+	if (rowName.IsEmpty())
+	{
+		return false;
+	}
+
+	// Stops as soon as the ID goes above the limit, long names can't overflow
+	int32 blockID = 0;
+	for (int32 charIndex = 0; charIndex < rowName.Len(); charIndex++)
+	{
+		const TCHAR character = rowName[charIndex];
+		if (!FChar::IsDigit(character))
+		{
+			return false;
+		}
+
+		blockID = blockID * 10 + (character - TEXT('0'));
+		if (blockID > GetMaxBlockID())
+		{
+			return false;
+		}
+	}
+
+	OutBlockID = blockID;
+	return true;
+}
+
+void FTT_BlockCatalog::Reset()
+{
+	Records.Reset();
+	Stats.Reset();
+	BlockIDs.Reset();
+	Candidates.Reset();
+	CandidateGroups.Reset();
+	CategoryGroups.Reset();
+	GroupLookup.Reset();
+}
+
+TArrayView<const int32> FTT_BlockCatalog::FindCandidates(const FString& category, int32 sizeX, int32 sizeY) const
+{
+	const FTT_BlockCandidateGroup* group = FindGroup(category, sizeX, sizeY);
+	return group ? GetGroupCandidates(*group) : TArrayView<const int32>();
+}
+
+int32 FTT_BlockCatalog::PickRandomCandidate(const FString& category, int32 sizeX, int32 sizeY) const
+{
+	const FTT_BlockCandidateGroup* group = FindGroup(category, sizeX, sizeY);
+	if (!group)
+	{
+		return INDEX_NONE;
+	}
+	return Candidates[group->FirstCandidate + FMath::RandRange(0, group->NumCandidates - 1)];
+}
+
+TArrayView<const FTT_BlockCandidateGroup> FTT_BlockCatalog::FindCategoryGroups(const FString& category) const
+{
+	const FIntPoint* groupRange = CategoryGroups.Find(category);
+	if (!groupRange)
+	{
+		return TArrayView<const FTT_BlockCandidateGroup>();
+	}
+	return TArrayView<const FTT_BlockCandidateGroup>(CandidateGroups.GetData() + groupRange->X, groupRange->Y);
+}
+
+void FTT_BlockCatalog::BuildCandidateIndex()
+{
+	Candidates = BlockIDs;
+
+	// Sort by category, then size, so every group ends up in one slice of the array
+	Candidates.Sort([this](int32 blockA, int32 blockB)
+	{
+		const int32 categoryOrder = Stats[blockA]->Category_Name.Compare(Stats[blockB]->Category_Name, ESearchCase::IgnoreCase);
+		if (categoryOrder != 0)
+		{
+			return categoryOrder < 0;
+		}
+
+		const FTT_BlockRecord& recordA = Records[blockA];
+		const FTT_BlockRecord& recordB = Records[blockB];
+		if (recordA.SizeX != recordB.SizeX)
+		{
+			return recordA.SizeX < recordB.SizeX;
+		}
+		if (recordA.SizeY != recordB.SizeY)
+		{
+			return recordA.SizeY < recordB.SizeY;
+		}
+		return blockA < blockB;
+	});
+
+	for (int32 candidateIndex = 0; candidateIndex < Candidates.Num(); candidateIndex++)
+	{
+		const int32 blockID = Candidates[candidateIndex];
+		const FString& category = Stats[blockID]->Category_Name;
+		const FIntPoint size(Records[blockID].SizeX, Records[blockID].SizeY);
+
+		FIntPoint* groupRange = CategoryGroups.Find(category);
+		if (!groupRange)
+		{
+			groupRange = &CategoryGroups.Add(category, FIntPoint(CandidateGroups.Num(), 0));
+		}
+
+		// Start a new group whenever the size changes within the category
+		if (groupRange->Y == 0 || CandidateGroups.Last().Size != size)
+		{
+			CandidateGroups.Add(FTT_BlockCandidateGroup{ size, candidateIndex, 0 });
+			GroupLookup.Add(FIntVector(groupRange->X, size.X, size.Y), CandidateGroups.Num() - 1);
+			groupRange->Y++;
+		}
+		CandidateGroups.Last().NumCandidates++;
+	}
+}
+
+const FTT_BlockCandidateGroup* FTT_BlockCatalog::FindGroup(const FString& category, int32 sizeX, int32 sizeY) const
+{
+	const FIntPoint* groupRange = CategoryGroups.Find(category);
+	if (!groupRange)
+	{
+		return nullptr;
+	}
+
+	const int32* groupIndex = GroupLookup.Find(FIntVector(groupRange->X, sizeX, sizeY));
+	return groupIndex ? &CandidateGroups[*groupIndex] : nullptr;
+}
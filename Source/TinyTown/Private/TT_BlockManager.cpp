@@ -4,15 +4,29 @@
 #include "TT_GridManager.h"
 #include "Kismet/GameplayStatics.h"
 #include "PaperGroupedSpriteComponent.h"
+#include "Components/HierarchicalInstancedStaticMeshComponent.h"
 #include "Engine/DataTable.h"
 #include "TT_Global.h"
 #include "TT_Block.h"
+#include "TT_ZonePacker.h"
 
 /*---------- Primary functions ----------*/
 
 ATT_BlockManager::ATT_BlockManager()
 {
-	PrimaryActorTick.bCanEverTick = false;
+	// Only ticks while the spawn queue has blocks to display
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+
+	Root = CreateDefaultSubobject<USceneComponent>(TEXT("Root"));
+	RootComponent = Root;
+
+	useInstancedBlockRendering = false;
+	spawnQueueBudgetMs = 2.f;
+	spawnQueueHead = 0;
+	useBlockActorPool = true;
+	maxPooledBlocksPerClass = 256;
+	zoneBuildingSizePreference = EZonePackingPreference::ZP_LargestFirst;
 
 
 	// Get the data table holding block's data
@@ -25,6 +39,18 @@ void ATT_BlockManager::BeginPlay()
 	Super::BeginPlay();
 
 	RefreshDataFromDataTable();
+
+	for (const TPair<int, int>& prewarm : blockActorPoolPrewarm)
+	{
+		PrewarmBlockActorPool(prewarm.Key, prewarm.Value);
+	}
+}
+
+void ATT_BlockManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	ProcessSpawnQueue(spawnQueueBudgetMs);
 }
 
 void ATT_BlockManager::SetGridManager(ATT_GridManager* newGridManager)
@@ -37,31 +63,189 @@ void ATT_BlockManager::SetGridManager(ATT_GridManager* newGridManager)
 	// If valid, set the grid manager
 	GridManager = newGridManager;
 
-	// Make sure tile arrays are resized
-	int numberOfTiles = GridManager->GetGridSize().X * GridManager->GetGridSize().Y;
-	SetTileArraysSize(numberOfTiles);
+	// Make sure tile arrays are initialised
+	InitTileArrays();
 }
 
-void ATT_BlockManager::SetTileArraysSize(int newArraySize)
+void ATT_BlockManager::InitTileArrays()
 {
-	spawnedBlockID.SetNum(newArraySize, true);
-	spawnedBlocks.SetNum(newArraySize, true);
-	spawnedZoneID.SetNum(newArraySize, true);
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+
+	blockStore.Reset();
+	spawnQueue.Reset();
+	spawnQueueHead = 0;
+	spawnedBlockHandles.Init(topology, FTT_BlockHandle());
+	spawnedZoneID.Init(topology, 0);
+	blockOccupancy.Init(topology);
+	placementValidityMaps.Reset();
+	OnBlockOccupancyChanged.Broadcast(FTT_TileRect(FIntPoint(0, 0), FIntPoint(topology.SizeX, topology.SizeY)));
+
+	for (UHierarchicalInstancedStaticMeshComponent* instanceComp : blockInstanceComponents)
+	{
+		instanceComp->ClearInstances();
+	}
+	for (TArray<int32>& freeInstances : freeBlockInstances)
+	{
+		freeInstances.Reset();
+	}
 }
 
 TArray<int> ATT_BlockManager::GetSpawnedZoneTileIDs()
 {
-	return spawnedZoneID;
+	return spawnedZoneID.ToArray();
 }
 
 TArray<int> ATT_BlockManager::GetSpawnedBlockIDs()
 {
-	return spawnedBlockID;
+	const TArray<FTT_BlockHandle> blockHandles = spawnedBlockHandles.ToArray();
+	TArray<int> blockIDs;
+	blockIDs.SetNumUninitialized(blockHandles.Num());
+
+	for (int tileID = 0; tileID < blockHandles.Num(); tileID++)
+	{
+		blockIDs[tileID] = blockStore.GetBlockID(blockHandles[tileID]);
+	}
+	return blockIDs;
 }
 
 TArray<ATT_Block*> ATT_BlockManager::GetSpawnedBlocks()
 {
-	return spawnedBlocks;
+	const TArray<FTT_BlockHandle> blockHandles = spawnedBlockHandles.ToArray();
+	TArray<ATT_Block*> blocks;
+	blocks.SetNumUninitialized(blockHandles.Num());
+
+	for (int tileID = 0; tileID < blockHandles.Num(); tileID++)
+	{
+		blocks[tileID] = blockStore.GetActor(blockHandles[tileID]);
+	}
+	return blocks;
+}
+
+int ATT_BlockManager::GetSpawnedZoneIDOnTile(int tileID)
+{
+	return GridManager->IsTileValid(tileID) ? spawnedZoneID.Get(tileID) : 0;
+}
+
+int ATT_BlockManager::GetSpawnedBlockIDOnTile(int tileID)
+{
+	return blockStore.GetBlockID(GetBlockHandleOnTile(tileID));
+}
+
+ATT_Block* ATT_BlockManager::GetSpawnedBlockOnTile(int tileID)
+{
+	return blockStore.GetActor(GetBlockHandleOnTile(tileID));
+}
+
+FTT_BlockHandle ATT_BlockManager::GetBlockHandleOnTile(int tileID) const
+{
+	return spawnedBlockHandles.IsTileValid(tileID) ? spawnedBlockHandles.Get(tileID) : FTT_BlockHandle();
+}
+
+ATT_Block* ATT_BlockManager::GetOrSpawnBlockActorOnTile(int tileID)
+{
+	const FTT_BlockHandle handle = GetBlockHandleOnTile(tileID);
+	if (!blockStore.IsValid(handle))
+	{
+		return nullptr;
+	}
+
+	// Blocks still in the spawn queue are displayed right away
+	if (blockStore.GetState(handle) == ETT_BlockState::Reserved && !DisplayBlock(handle))
+	{
+		return nullptr;
+	}
+
+	if (blockStore.GetState(handle) == ETT_BlockState::Instanced)
+	{
+		RemoveBlockInstance(handle);
+		if (!SpawnBlockActor(handle))
+		{
+			AddBlockInstance(handle);
+		}
+	}
+	return blockStore.GetActor(handle);
+}
+
+void ATT_BlockManager::ReturnBlockToInstance(ATT_Block* block)
+{
+	if (!block || !useInstancedBlockRendering)
+	{
+		return;
+	}
+
+	const FTT_BlockHandle handle = block->GetBlockHandle();
+	if (blockStore.GetActor(handle) != block || !GetBlockInstanceType(blockStore.GetBlockID(handle)))
+	{
+		return;
+	}
+
+	blockStore.SetActor(handle, nullptr);
+	AddBlockInstance(handle);
+
+	if (!ReleaseBlockActor(block))
+	{
+		block->Destroy();
+	}
+}
+
+void ATT_BlockManager::PrewarmBlockActorPool(int blockID, int count)
+{
+	const FTT_BlockRecord* BlockRecord = GetBlockRecordFromBlockID(blockID);
+	if (!BlockRecord || !BlockRecord->BlockClass)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Cannot prewarm the pool of block %d, it isn't in the data table or has no class."), blockID);
+		return;
+	}
+
+	TArray<ATT_Block*>& pooledBlocks = blockActorPools.FindOrAdd(BlockRecord->BlockClass).Blocks;
+	const int numberToSpawn = FMath::Min(count, maxPooledBlocksPerClass) - pooledBlocks.Num();
+
+	for (int i = 0; i < numberToSpawn; i++)
+	{
+		ATT_Block* SpawnedActor = GetWorld()->SpawnActorDeferred<ATT_Block>(BlockRecord->BlockClass, FTransform::Identity);
+		if (!SpawnedActor)
+		{
+			return;
+		}
+
+		SpawnedActor->SetBlockManager(this);
+		UGameplayStatics::FinishSpawningActor(SpawnedActor, FTransform::Identity);
+
+		SpawnedActor->DeactivateBlock();
+		pooledBlocks.Add(SpawnedActor);
+	}
+}
+
+bool ATT_BlockManager::ReleaseBlockActor(ATT_Block* block)
+{
+	if (!useBlockActorPool || !block || block->IsPendingKill())
+	{
+		return false;
+	}
+
+	TArray<ATT_Block*>& pooledBlocks = blockActorPools.FindOrAdd(block->GetClass()).Blocks;
+	if (pooledBlocks.Num() >= maxPooledBlocksPerClass)
+	{
+		return false;
+	}
+
+	block->DeactivateBlock();
+	pooledBlocks.Add(block);
+	return true;
+}
+
+ATT_Block* ATT_BlockManager::AcquirePooledBlockActor(UClass* blockClass)
+{
+	FTT_BlockActorPool* pool = blockActorPools.Find(blockClass);
+	while (pool && pool->Blocks.Num() > 0)
+	{
+		ATT_Block* pooledBlock = pool->Blocks.Pop(false);
+		if (pooledBlock && !pooledBlock->IsPendingKill())
+		{
+			return pooledBlock;
+		}
+	}
+	return nullptr;
 }
 
 
@@ -80,92 +264,352 @@ void ATT_BlockManager::SpawnBlockFromParameters(int tileID, FRotator blockRotati
 	SpawnBlock(blockID, blockRotation, tileID);
 }
 
-void ATT_BlockManager::SpawnBlock(int blockID, FRotator blockRotation, int tileID)
+void ATT_BlockManager::SpawnBlock(int blockID, FRotator blockRotation, int tileID, bool isDisplayDeferred)
 {
-	// Makes block transform based on TileID
-	FTransform BlockTransform = FTransform(FRotator(0, 0, 0), GridManager->GetTileLocation(tileID, true), FVector(1, 1, 1));
-
 	//Get Block Default stats from data table
 	FTT_Struct_Block* BlockStats = GetBlockStatsFromBlockID(blockID);
+	if (!BlockStats)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Cannot spawn block %d, it isn't in the data table."), blockID);
+		return;
+	}
 
 	//Get the block's zone characteristics
 	bool isModuloHalfPi = FMath::IsNearlyEqual(abs(blockRotation.Yaw), 90, 0.1f);
-	TArray<int> BlockZoneTileIDs;
+	FTT_TileRect BlockTileRect;
 	
 
-	if (!CheckIfBlockIsBuildable(tileID, BlockStats->Size_X, BlockStats->Size_Y, isModuloHalfPi, BlockZoneTileIDs))
+	if (!CheckIfBlockIsBuildable(tileID, BlockStats->Size_X, BlockStats->Size_Y, isModuloHalfPi, BlockTileRect))
 	{
 		UE_LOG(LogTemp, Warning, TEXT("A block is already placed on one of these tiles."));
 		return;
 	}
 
+	// The block owns its tiles before it is displayed
+	const FTT_BlockHandle BlockHandle = ReserveBlock(blockID, tileID, blockRotation.Yaw, BlockTileRect);
+	if (!BlockHandle.IsSet())
+	{
+		return;
+	}
+
+	if (isDisplayDeferred)
+	{
+		spawnQueue.Add(BlockHandle);
+		SetActorTickEnabled(true);
+		return;
+	}
+
+	if (!DisplayBlock(BlockHandle))
+	{
+		ReleaseBlock(BlockHandle);
+	}
+}
+
+bool ATT_BlockManager::DisplayBlock(FTT_BlockHandle handle)
+{
+	if (useInstancedBlockRendering && AddBlockInstance(handle))
+	{
+		return true;
+	}
+	return SpawnBlockActor(handle) != nullptr;
+}
+
+void ATT_BlockManager::ProcessSpawnQueue(float budgetMs)
+{
+	if (spawnQueueHead >= spawnQueue.Num())
+	{
+		SetActorTickEnabled(false);
+		return;
+	}
+
+	const double endTime = FPlatformTime::Seconds() + budgetMs / 1000.0;
+	do
+	{
+		const FTT_BlockHandle handle = spawnQueue[spawnQueueHead++];
+
+		// Blocks deleted or displayed (e.g. selected) since they were queued are skipped
+		if (blockStore.IsValid(handle) && blockStore.GetState(handle) == ETT_BlockState::Reserved && !DisplayBlock(handle))
+		{
+			ReleaseBlock(handle);
+		}
+	} while (spawnQueueHead < spawnQueue.Num() && FPlatformTime::Seconds() < endTime);
+
+	OnSpawnQueueProgress.Broadcast(spawnQueueHead, spawnQueue.Num());
+
+	if (spawnQueueHead >= spawnQueue.Num())
+	{
+		spawnQueue.Reset();
+		spawnQueueHead = 0;
+		SetActorTickEnabled(false);
+
+		OnSpawnQueueEmptied.Broadcast();
+	}
+}
+
+void ATT_BlockManager::FlushSpawnQueue()
+{
+	if (spawnQueueHead < spawnQueue.Num())
+	{
+		ProcessSpawnQueue(MAX_flt);
+	}
+}
+
+int ATT_BlockManager::GetNumberOfQueuedBlocks() const
+{
+	return spawnQueue.Num() - spawnQueueHead;
+}
+
+ATT_Block* ATT_BlockManager::SpawnBlockActor(FTT_BlockHandle handle)
+{
+	const int centralTileID = blockStore.GetCentralTileID(handle);
+	FTT_Struct_Block* BlockStats = GetBlockStatsFromBlockID(blockStore.GetBlockID(handle));
+	if (!BlockStats)
+	{
+		return nullptr;
+	}
+
+	// Makes block transform based on TileID
+	FTransform BlockTransform = FTransform(FRotator(0, 0, 0), GridManager->GetTileLocation(centralTileID, true), FVector(1, 1, 1));
+
+	// Pooled blocks already went through their construction & BeginPlay, they are only moved and shown again
+	ATT_Block* PooledActor = AcquirePooledBlockActor(BlockStats->BlockClass);
 	ATT_Block* SpawnedActor;
-	SpawnedActor = GetWorld()->SpawnActorDeferred<ATT_Block>(BlockStats->BlockClass, BlockTransform);
+	if (PooledActor)
+	{
+		SpawnedActor = PooledActor;
+		SpawnedActor->ReactivateBlock(BlockTransform);
+	}
+	else
+	{
+		SpawnedActor = GetWorld()->SpawnActorDeferred<ATT_Block>(BlockStats->BlockClass, BlockTransform);
+	}
+
 	if (SpawnedActor)
 	{
 		SpawnedActor->SetBlockStats(BlockStats);
 		SpawnedActor->SetBlockManager(this);
-		SpawnedActor->SetCentralTileID(tileID);
-		SpawnedActor->SetBlockTileIDs(BlockZoneTileIDs);
-		SpawnedActor->SetBlockRotation(blockRotation, 0.1f);
+		SpawnedActor->SetBlockHandle(handle);
+		SpawnedActor->SetCentralTileID(centralTileID);
+		SpawnedActor->SetBlockTileRect(blockStore.GetTileRect(handle));
+		SpawnedActor->SetBlockRotation(FRotator(0, blockStore.GetYaw(handle), 0), 0.1f);
 		SpawnedActor->SetBlockPosition();
 		SpawnedActor->UpdateBlockRotationAndLocation();
 
-		UGameplayStatics::FinishSpawningActor(SpawnedActor, BlockTransform);
+		if (!PooledActor)
+		{
+			UGameplayStatics::FinishSpawningActor(SpawnedActor, BlockTransform);
+		}
+
+		blockStore.SetActor(handle, SpawnedActor);
+		blockStore.SetState(handle, ETT_BlockState::Spawned);
+
+		if (PooledActor)
+		{
+			PooledActor->OnBlockReused();
+		}
+	}
+	return SpawnedActor;
+}
+
+const FTT_BlockInstanceType* ATT_BlockManager::GetBlockInstanceType(int blockID)
+{
+	if (const FTT_BlockInstanceType* knownType = blockInstanceTypes.Find(blockID))
+	{
+		return knownType->ComponentIndex != INDEX_NONE ? knownType : nullptr;
+	}
+
+	FTT_BlockInstanceType& instanceType = blockInstanceTypes.Add(blockID);
+
+	const FTT_BlockRecord* BlockRecord = GetBlockRecordFromBlockID(blockID);
+	if (!BlockRecord || BlockRecord->RequiresActor || !BlockRecord->BlockClass)
+	{
+		return nullptr;
+	}
+
+	// Instances look like the class' default mesh, a class without one (e.g. made of Blueprint components) needs its actor
+	const UStaticMeshComponent* defaultMesh = BlockRecord->BlockClass->GetDefaultObject<ATT_Block>()->GetBlockMesh();
+	UStaticMesh* mesh = defaultMesh ? defaultMesh->GetStaticMesh() : nullptr;
+	if (!mesh)
+	{
+		return nullptr;
+	}
 
+	instanceType.MeshTransform = defaultMesh->GetRelativeTransform();
 
-		for (int i = 0; i < BlockZoneTileIDs.Num(); i++)
+	for (int componentIndex = 0; componentIndex < blockInstanceComponents.Num(); componentIndex++)
+	{
+		if (blockInstanceComponents[componentIndex]->GetStaticMesh() == mesh)
 		{
-			spawnedBlockID[BlockZoneTileIDs[i]] = blockID;
-			spawnedBlocks[BlockZoneTileIDs[i]] = SpawnedActor;
+			instanceType.ComponentIndex = componentIndex;
+			return &instanceType;
 		}
 	}
+
+	// First block using this mesh, its materials are used for every block sharing the mesh. Blocks are picked from the tiles they use, not from collisions.
+	UHierarchicalInstancedStaticMeshComponent* instanceComp = NewObject<UHierarchicalInstancedStaticMeshComponent>(this);
+	instanceComp->CreationMethod = EComponentCreationMethod::Instance;
+	instanceComp->SetupAttachment(Root);
+	instanceComp->SetStaticMesh(mesh);
+	instanceComp->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	for (int materialIndex = 0; materialIndex < defaultMesh->OverrideMaterials.Num(); materialIndex++)
+	{
+		if (defaultMesh->OverrideMaterials[materialIndex])
+		{
+			instanceComp->SetMaterial(materialIndex, defaultMesh->OverrideMaterials[materialIndex]);
+		}
+	}
+	instanceComp->RegisterComponent();
+	AddInstanceComponent(instanceComp);
+
+	instanceType.ComponentIndex = blockInstanceComponents.Add(instanceComp);
+	freeBlockInstances.AddDefaulted();
+
+	return &instanceType;
+}
+
+bool ATT_BlockManager::AddBlockInstance(FTT_BlockHandle handle)
+{
+	const int blockID = blockStore.GetBlockID(handle);
+	const FTT_BlockInstanceType* instanceType = GetBlockInstanceType(blockID);
+	const FTT_BlockRecord* BlockRecord = GetBlockRecordFromBlockID(blockID);
+	if (!instanceType || !BlockRecord)
+	{
+		return false;
+	}
+
+	// Same transforms as the block's actor: Root on the central tile, BuildingRoot moved to the anchor, RotationRoot turned by the yaw
+	const float yaw = blockStore.GetYaw(handle);
+	const FVector anchorLocation = ATT_Block::GetBlockAnchorLocation(BlockRecord->SizeX, BlockRecord->SizeY, yaw, GridManager->GetDistanceBetweenTiles());
+	const FTransform instanceTransform = instanceType->MeshTransform
+		* FTransform(FRotator(0, yaw, 0))
+		* FTransform(anchorLocation)
+		* FTransform(GridManager->GetTileLocation(blockStore.GetCentralTileID(handle), true));
+
+	UHierarchicalInstancedStaticMeshComponent* instanceComp = blockInstanceComponents[instanceType->ComponentIndex];
+	TArray<int32>& freeInstances = freeBlockInstances[instanceType->ComponentIndex];
+
+	int32 instanceIndex;
+	if (freeInstances.Num() > 0)
+	{
+		instanceIndex = freeInstances.Pop(false);
+		instanceComp->UpdateInstanceTransform(instanceIndex, instanceTransform, true, true);
+	}
+	else
+	{
+		instanceIndex = instanceComp->AddInstanceWorldSpace(instanceTransform);
+	}
+
+	blockStore.SetInstanceIndex(handle, instanceIndex);
+	blockStore.SetState(handle, ETT_BlockState::Instanced);
+	return true;
+}
+
+void ATT_BlockManager::RemoveBlockInstance(FTT_BlockHandle handle)
+{
+	const int32 instanceIndex = blockStore.GetInstanceIndex(handle);
+	const FTT_BlockInstanceType* instanceType = blockInstanceTypes.Find(blockStore.GetBlockID(handle));
+	if (instanceIndex == INDEX_NONE || !instanceType || instanceType->ComponentIndex == INDEX_NONE)
+	{
+		return;
+	}
+
+	// Removing an instance would move the last one in its place and change its index, the instance is hidden & reused instead
+	FTransform hiddenTransform = FTransform::Identity;
+	hiddenTransform.SetScale3D(FVector::ZeroVector);
+	blockInstanceComponents[instanceType->ComponentIndex]->UpdateInstanceTransform(instanceIndex, hiddenTransform, false, true);
+	freeBlockInstances[instanceType->ComponentIndex].Add(instanceIndex);
+
+	blockStore.SetInstanceIndex(handle, INDEX_NONE);
+	blockStore.SetState(handle, ETT_BlockState::Reserved);
+}
+
+FTT_BlockHandle ATT_BlockManager::ReserveBlock(int blockID, int centralTileID, float yaw, const FTT_TileRect& tileRect)
+{
+	const FTT_BlockHandle handle = blockStore.Add(blockID, centralTileID, yaw, tileRect);
+	if (!handle.IsSet())
+	{
+		return handle;
+	}
+
+	for (int blockTileID : FTT_TileRectView(GridManager->GetGridTopology(), tileRect))
+	{
+		spawnedBlockHandles.Set(blockTileID, handle);
+	}
+	SetBlockOccupancy(tileRect, true);
+
+	return handle;
 }
 
-void ATT_BlockManager::SpawnBlockAtStartTile(int blockID, int tileID)
+void ATT_BlockManager::ReleaseBlock(FTT_BlockHandle handle)
+{
+	if (!blockStore.IsValid(handle))
+	{
+		return;
+	}
+
+	const FTT_TileRect tileRect = blockStore.GetTileRect(handle);
+	for (int indexToClear : FTT_TileRectView(GridManager->GetGridTopology(), tileRect))
+	{
+		ClearTileArraysAtIndex(indexToClear);
+	}
+	SetBlockOccupancy(tileRect, false);
+
+	blockStore.Remove(handle);
+}
+
+void ATT_BlockManager::SpawnBlockAtStartTile(int blockID, int tileID, bool isDisplayDeferred)
 {
 	//Get Block Default stats from data table
-	FTT_Struct_Block* BlockStats = GetBlockStatsFromBlockID(blockID);
+	const FTT_BlockRecord* BlockRecord = GetBlockRecordFromBlockID(blockID);
+	if (!BlockRecord)
+	{
+		return;
+	}
 
 	// Get the "Hovered tile" 
-	int hoveredTile = GetHoveredTileFromZoneParameter(tileID, BlockStats->Size_X, BlockStats->Size_Y, false);
+	int hoveredTile = GetHoveredTileFromZoneParameter(tileID, BlockRecord->SizeX, BlockRecord->SizeY, false);
 
-	SpawnBlock(blockID, FRotator(0, 0, 0), hoveredTile);
+	SpawnBlock(blockID, FRotator(0, 0, 0), hoveredTile, isDisplayDeferred);
 }
 
 void ATT_BlockManager::DeleteBlockOnTile(int tileID)
 {
-	if (!spawnedBlocks[tileID])
+	const FTT_BlockHandle handleToDelete = GetBlockHandleOnTile(tileID);
+	if (!blockStore.IsValid(handleToDelete))
 	{
 		DeleteZoneOnTile(tileID);
 		return;
 	}
 
-	ATT_Block* blockToDelete = spawnedBlocks[tileID];
-	for (int i = 0; i < blockToDelete->GetBlockTileIDs().Num(); i++)
+	if (blockStore.GetState(handleToDelete) == ETT_BlockState::Instanced)
 	{
-		int indexToClear = blockToDelete->GetBlockTileIDs()[i];
-		ClearTileArraysAtIndex(indexToClear);
+		RemoveBlockInstance(handleToDelete);
 	}
 
-	blockToDelete->OnDestroyBlock();
+	ATT_Block* blockToDelete = blockStore.GetActor(handleToDelete);
+	ReleaseBlock(handleToDelete);
+
+	if (blockToDelete)
+	{
+		blockToDelete->OnDestroyBlock();
+	}
 }
 
-void ATT_BlockManager::CreateZoneOnTiles(TArray<int> tileIDs, int blockID)
+void ATT_BlockManager::CreateZoneOnTiles(const FTT_TileRect& zone, int blockID)
 {
-	for (int i = 0; i < tileIDs.Num(); i++)
+	for (int zoneTileID : FTT_TileRectView(GridManager->GetGridTopology(), zone))
 	{
-		spawnedZoneID[tileIDs[i]] = blockID;
+		spawnedZoneID.Set(zoneTileID, blockID);
 	}
 
-	SpawnZoneBuildingsInZone(blockID, tileIDs);
+	SpawnZoneBuildingsInZone(blockID, zone);
 }
 
 void ATT_BlockManager::CreatePathOnTiles(TArray<int> tileIDs, int blockID)
 {
 	for (int i = 0; i < tileIDs.Num(); i++)
 	{
-		spawnedZoneID[tileIDs[i]] = blockID;
+		spawnedZoneID.Set(tileIDs[i], blockID);
 	}
 
 	TArray<int> unusedTiles = tileIDs;
@@ -173,7 +617,7 @@ void ATT_BlockManager::CreatePathOnTiles(TArray<int> tileIDs, int blockID)
 
 	for (int i : unusedTiles)
 	{
-		SpawnBlockAtStartTile(blockID, i);
+		SpawnBlockAtStartTile(blockID, i, true);
 	}
 }
 
@@ -185,97 +629,81 @@ void ATT_BlockManager::DeleteZoneOnTile(int tileID)
 		return;
 	}
 
-	spawnedZoneID[tileID] = 0;
+	spawnedZoneID.Reset(tileID);
 
 }
 
 void ATT_BlockManager::ClearTileArraysAtIndex(int index)
 {
-	spawnedBlockID[index] = 0;
-	spawnedBlocks[index] = nullptr;
+	spawnedBlockHandles.Reset(index);
 }
 
-void ATT_BlockManager::SpawnZoneBuildingsInZone(int zoneID, TArray<int> tileIDs)
+void ATT_BlockManager::SpawnZoneBuildingsInZone(int zoneID, const FTT_TileRect& zone)
 {
-	if (tileIDs.Num() == 0)
+	if (zone.IsEmpty())
 	{
 		UE_LOG(LogTemp, Warning, TEXT("Zone array not valid in FindZoneLayout."));
 		return;
 	}
 
-	// Map of all the blockIDs associated with the zone ID and their block sizes
-	TMap<int, FVector2D> blockSizes;
-
-	//Gets the name of the zone
-	TArray<FString> ZoneNames;
-	TArray<int> ZoneIDs;
-	zoneIDMap.GenerateKeyArray(ZoneNames);
-	zoneIDMap.GenerateValueArray(ZoneIDs);
-
-	FString ZoneName = ZoneNames[ZoneIDs.Find(zoneID)];
+	FTT_Struct_Block* zoneStats = GetBlockStatsFromBlockID(zoneID);
+	if (!zoneStats)
+	{
+		return;
+	}
 
-	//Array of all the blockIDs associated with the ZoneID
-	TArray<int> ZoneBuildingIDs;
+	// Zone buildings use the name of their zone as category. Each size gets one of its buildings,
+	// picked from a stream seeded by the zone so that the same zone always gets the same buildings.
+	FRandomStream blockStream(HashCombine(GetTypeHash(zone.Min), GetTypeHash(zone.Size)));
+	TArray<FIntPoint> buildingSizes;
+	TArray<int> buildingIDs;
 
-	//For each zoneBuilding found in the DataBase, get the blockIDs associated with the zone name above
-	for (auto a : zoneBuildingIDMap)
+	for (const FTT_BlockCandidateGroup& group : blockCatalog.FindCategoryGroups(zoneStats->Block_Name.ToString()))
 	{
-		if (a.Key == ZoneName)
+		TArray<int, TInlineAllocator<8>> zoneBuildings;
+		for (int blockID : blockCatalog.GetGroupCandidates(group))
 		{
-			ZoneBuildingIDs.Append(a.Value.BlockIDs);
+			if (blockCatalog.FindRecord(blockID)->Type == EBlockType::BT_ZoneBuilding)
+			{
+				zoneBuildings.Add(blockID);
+			}
 		}
-	}
 
-	// For each blockIDs associated with the zone name above, gets its size and add it to the map
-	for (int blockID : ZoneBuildingIDs)
-	{
-		FTT_Struct_Block* BlockStats = GetBlockStatsFromBlockID(blockID);
-		blockSizes.Add(blockID, FVector2D(BlockStats->Size_X, BlockStats->Size_Y));
+		if (zoneBuildings.Num() > 0)
+		{
+			buildingSizes.Add(group.Size);
+			buildingIDs.Add(zoneBuildings[blockStream.RandRange(0, zoneBuildings.Num() - 1)]);
+		}
 	}
 
-	//Sort TileID array
-	TArray<int> sortedTileIDs = tileIDs;
-	sortedTileIDs.Sort();
-
-	// For each tile in the zone, try to fit the blocks
-	for (int i : sortedTileIDs)
+	if (buildingSizes.Num() == 0)
 	{
-		SpawnBlockInZone(i, sortedTileIDs, blockSizes);
+		return;
 	}
 
-	return;
-}
-
-void ATT_BlockManager::SpawnBlockInZone(int tileA, TArray<int> zoneTiles, TMap<int, FVector2D> blockSizesMap)
-{
-	TArray<int> blockSizesBlockID;
-	TArray<FVector2D> blockSizesArray;
-	blockSizesMap.GenerateKeyArray(blockSizesBlockID);
-	blockSizesMap.GenerateValueArray(blockSizesArray);
+	// Tiles off the grid or already owned by a block can't be used
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	FTT_ZonePacker zonePacker;
+	zonePacker.Init(zone.Size);
 
-	for(auto a : blockSizesArray)
+	for (int row = 0; row < zone.Size.Y; row++)
 	{
-		int tileB = tileA + a.X + a.Y * GridManager->GetGridSize().X;
-		int tileC = GetHoveredTileFromZoneParameter(tileA, a.X, a.Y, false);
-		TArray<int> blockTiles = GetZoneTileIDsFromZoneParameters(tileA, tileB, true);
-		bool isBlockBuildable = true;
-
-		for (int b : blockTiles)
+		for (int column = 0; column < zone.Size.X; column++)
 		{
-			if (!zoneTiles.Contains(b))
+			const int tileID = topology.GetTileID(zone.Min + FIntPoint(column, row));
+			if (tileID == -1 || blockOccupancy.IsTileOccupied(tileID))
 			{
-				isBlockBuildable = false;
+				zonePacker.BlockTile(FIntPoint(column, row));
 			}
 		}
+	}
 
-		if (isBlockBuildable)
-		{
-			if (CheckIfBlockIsBuildable(tileC, a.X, a.Y, false))
-			{
-				int blockID = blockSizesBlockID[blockSizesArray.Find(a)];
-				SpawnBlockAtStartTile(blockID, tileA);
-			}
-		}
+	TArray<FTT_ZonePlacement> placements;
+	zonePacker.Pack(buildingSizes, zoneBuildingSizePreference, placements);
+
+	for (const FTT_ZonePlacement& placement : placements)
+	{
+		SpawnBlockAtStartTile(buildingIDs[placement.SizeIndex], topology.GetTileID(zone.Min + placement.Min), true);
 	}
 }
 
@@ -292,81 +720,98 @@ TArray<int> ATT_BlockManager::GetZoneTileIDsFromZoneParameters(int tileA, int ti
 		return TileIDs;
 	}
 
-	if (tileA != -1 && tileB != -1)
-	{
-		// Convert TileID into polar coordinates
-		int Ay;
-		int Ax;
-		Ay = trunc(tileA / GridManager->GetGridSize().X);
-		Ax = tileA - (Ay * GridManager->GetGridSize().X);
-
-		int By;
-		int Bx;
-		By = trunc(tileB / GridManager->GetGridSize().X);
-		Bx = tileB - (By * GridManager->GetGridSize().X);
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
 
+	if (topology.IsTileValid(tileA) && topology.IsTileValid(tileB))
+	{
 		// Get block size from vector AB>
-		FVector2D blockSize;
+		const FIntPoint startCoordinate = topology.GetTileCoordinate(tileA);
+		const FIntPoint blockSize = topology.GetTileDelta(tileA, tileB);
 
-		//blockSize = FVector2D(By - Ay, Bx - Ax);
-		blockSize = FVector2D(Bx - Ax, By - Ay);
+		const int xSign = blockSize.X < 0 ? -1 : 1;
+		const int ySign = blockSize.Y < 0 ? -1 : 1;
 
-		// Convert polar coordinates into grid of tiles
-		float distance = GridManager->GetDistanceBetweenTiles();
-		FVector startLocation = GridManager->GetTileLocation(tileA, true);
+		// Tile B's row and column are only part of the zone when it is included
+		const int numberOfColumns = FMath::Abs(blockSize.X) + (excludeTileB ? 0 : 1);
+		const int numberOfRows = FMath::Abs(blockSize.Y) + (excludeTileB ? 0 : 1);
 
-		float xSign = 1.0f;
-		float ySign = 1.0f;
+		TileIDs.Reserve(numberOfColumns * numberOfRows);
 
-		if (blockSize.X != 0)
+		for (int i = 0; i < numberOfRows; i++)
 		{
-			xSign = abs(blockSize.X) / blockSize.X;
-		}
-		if (blockSize.Y != 0)
-		{
-			ySign = abs(blockSize.Y) / blockSize.Y;
+			for (int j = 0; j < numberOfColumns; j++)
+			{
+				TileIDs.Add(topology.GetTileID(startCoordinate + FIntPoint(j * xSign, i * ySign)));
+			}
 		}
+	}
+
+	return TileIDs;
+}
 
+FTT_TileRect ATT_BlockManager::GetZoneRectFromZoneParameters(int tileA, int tileB)
+{
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	if (!topology.IsTileValid(tileA) || !topology.IsTileValid(tileB))
+	{
+		return FTT_TileRect();
+	}
+	return FTT_TileRect::FromCorners(topology.GetTileCoordinate(tileA), topology.GetTileCoordinate(tileB));
+}
 
-		if (excludeTileB)
-		{
-			for (int i = 0; i < abs(blockSize.Y); i++)
-			{
+int ATT_BlockManager::GetZoneAnchorOffset(int size)
+{
+	// Even sizes have no central tile, the anchor is the tile just before the middle of the zone
+	return (size - 1) / 2;
+}
 
-				for (int j = 0; j < abs(blockSize.X); j++)
-				{
-					int newTileID = tileA + j * xSign + (i * ySign  * GridManager->GetGridSize().X);
+FTT_PlacementFootprint ATT_BlockManager::GetPlacementFootprint(int sizeX, int sizeY, bool isModuloHalfPi)
+{
+	FTT_PlacementFootprint footprint(FIntPoint(sizeX, sizeY), FIntPoint(GetZoneAnchorOffset(sizeX), GetZoneAnchorOffset(sizeY)));
 
-					if (GridManager->IsTileValid(newTileID))
-					{
-						TileIDs.Add(newTileID);
-					}
-				}
+	// Is the block rotated 90
+	if (isModuloHalfPi)
+	{
+		Swap(footprint.Size.X, footprint.Size.Y);
+		Swap(footprint.AnchorOffset.X, footprint.AnchorOffset.Y);
+	}
+	return footprint;
+}
 
-			}
-		}
-		else
-		{
-			for (int i = 0; i <= abs(blockSize.Y); i++)
-			{
+void ATT_BlockManager::SetBlockOccupancy(const FTT_TileRect& rect, bool isOccupied)
+{
+	blockOccupancy.SetRect(rect, isOccupied);
 
-				for (int j = 0; j <= abs(blockSize.X); j++)
-				{
-					int newTileID = tileA + j * xSign + (i * ySign  * GridManager->GetGridSize().X);
+	for (FTT_PlacementValidityMap& validityMap : placementValidityMaps)
+	{
+		validityMap.Update(blockOccupancy, rect);
+	}
 
-					if (GridManager->IsTileValid(newTileID))
-					{
-						TileIDs.Add(newTileID);
-					}
-				}
+	OnBlockOccupancyChanged.Broadcast(rect);
+}
 
-			}
+const FTT_PlacementValidityMap& ATT_BlockManager::GetPlacementValidityMap(int sizeX, int sizeY, bool isModuloHalfPi)
+{
+	const FTT_PlacementFootprint footprint = GetPlacementFootprint(sizeX, sizeY, isModuloHalfPi);
+
+	for (const FTT_PlacementValidityMap& validityMap : placementValidityMaps)
+	{
+		if (validityMap.GetFootprint() == footprint)
+		{
+			return validityMap;
 		}
+	}
 
-		return TileIDs;
+	// Only a few footprints are in use at once (the build tool's block in both rotations), the oldest map makes room
+	const int maxValidityMaps = 8;
+	if (placementValidityMaps.Num() >= maxValidityMaps)
+	{
+		placementValidityMaps.RemoveAt(0);
 	}
 
-	return TileIDs;
+	FTT_PlacementValidityMap& validityMap = placementValidityMaps[placementValidityMaps.AddDefaulted()];
+	validityMap.Build(blockOccupancy, footprint);
+	return validityMap;
 }
 
 int ATT_BlockManager::GetZoneStartTileFromHoveredTile(int tileC, int sizeX, int sizeY, bool isModuloHalfPi)
@@ -374,44 +819,22 @@ int ATT_BlockManager::GetZoneStartTileFromHoveredTile(int tileC, int sizeX, int
 	/* This function is tightly bound to the way a building is moved and rotated (when being placed down).
 		For any changes to this function, make sure to change EditMode in Block.cpp	*/
 
-	int offsetX;
-	int offsetY;
-
-	if (sizeX % 2 == 0)
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	if (!topology.IsTileValid(tileC))
 	{
-		offsetX = FMath::TruncToInt(sizeX / 2) - 1;
-	}
-	else
-	{
-		offsetX = FMath::TruncToInt(sizeX / 2);
+		return -1;
 	}
 
-	if (sizeY % 2 == 0)
-	{
-		offsetY = FMath::TruncToInt(sizeY / 2) - 1;
-	}
-	else
-	{
-		offsetY = FMath::TruncToInt(sizeY / 2);
-	}
-
-	int ActualTileID;
+	int offsetX = GetZoneAnchorOffset(sizeX);
+	int offsetY = GetZoneAnchorOffset(sizeY);
 
 	// Is the block rotated 90
 	if (isModuloHalfPi)
 	{
-		ActualTileID = tileC - offsetX * GridManager->GetGridSize().X - offsetY;
-	}
-	else
-	{
-		ActualTileID = tileC - offsetY * GridManager->GetGridSize().X - offsetX;
+		Swap(offsetX, offsetY);
 	}
 
-	if (GridManager->IsTileValid(ActualTileID))
-	{
-		return ActualTileID;
-	}
-	return -1;
+	return topology.GetTileID(topology.GetTileCoordinate(tileC) - FIntPoint(offsetX, offsetY));
 }
 
 int ATT_BlockManager::GetHoveredTileFromZoneParameter(int tileA, int sizeX, int sizeY, bool isModuloHalfPi)
@@ -419,233 +842,162 @@ int ATT_BlockManager::GetHoveredTileFromZoneParameter(int tileA, int sizeX, int
 	/* This function is tightly bound to the way a building is moved and rotated (when being placed down).
 		For any changes to this function, make sure to change EditMode in Block.cpp	*/
 
-	int offsetX;
-	int offsetY;
-
-	if (sizeX % 2 == 0)
-	{
-		offsetX = FMath::TruncToInt(sizeX / 2) - 1;
-	}
-	else
-	{
-		offsetX = FMath::TruncToInt(sizeX / 2);
-	}
-
-	if (sizeY % 2 == 0)
-	{
-		offsetY = FMath::TruncToInt(sizeY / 2) - 1;
-	}
-	else
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	if (!topology.IsTileValid(tileA))
 	{
-		offsetY = FMath::TruncToInt(sizeY / 2);
+		return -1;
 	}
 
-	int ActualTileID;
+	int offsetX = GetZoneAnchorOffset(sizeX);
+	int offsetY = GetZoneAnchorOffset(sizeY);
 
 	// Is the block rotated 90
 	if (isModuloHalfPi)
 	{
-		ActualTileID = tileA + offsetX * GridManager->GetGridSize().X + offsetY;
-	}
-	else
-	{
-		ActualTileID = tileA + offsetY * GridManager->GetGridSize().X + offsetX;
-	}
-	
-	if (GridManager->IsTileValid(ActualTileID))
-	{
-		return ActualTileID;
+		Swap(offsetX, offsetY);
 	}
 
-	return -1;
+	return topology.GetTileID(topology.GetTileCoordinate(tileA) + FIntPoint(offsetX, offsetY));
 }
 
 int ATT_BlockManager::GetZoneEndTileFromZoneSize(int tileA, int sizeX, int sizeY, bool isModuloHalfPi)
 {
-	int xSize = sizeX -1;
-	int ySize = sizeY -1;
-
-	if (isModuloHalfPi)
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	if (!topology.IsTileValid(tileA))
 	{
-		int tempXSize = xSize;
-		xSize = ySize;
-		ySize = tempXSize;
+		return -1;
 	}
 
-	int newTileID = tileA + (ySize * GridManager->GetGridSize().X) + xSize;
+	int xSize = sizeX -1;
+	int ySize = sizeY -1;
 
-	if (GridManager->IsTileValid(newTileID))
+	if (isModuloHalfPi)
 	{
-		return newTileID;
+		Swap(xSize, ySize);
 	}
 
-	return -1;
+	return topology.GetTileID(topology.GetTileCoordinate(tileA) + FIntPoint(xSize, ySize));
 }
 
 FVector2D ATT_BlockManager::GetZoneSizeFromTileArray(TArray<int> zone)
 {
-	int gridX = 0;
-	int gridY = 0;
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	FIntPoint minimumCoordinates(MAX_int32, MAX_int32);
+	FIntPoint maximumCoordinates(MIN_int32, MIN_int32);
 
-	int tempTileID = zone[0];
-	gridX++;
-	gridY++;
-
-	for (auto i : zone)
+	for (int i : zone)
 	{
-		bool xDone = false;
-
-		if (!xDone)
-		{
-			if (i == tempTileID + 1 || i == tempTileID - 1)
-			{
-				tempTileID = i;
-				gridX++;
-			}
-		}
-
-		if (i == tempTileID + GridManager->GetGridSize().X || i == tempTileID - GridManager->GetGridSize().X)
+		if (topology.IsTileValid(i))
 		{
-			xDone = true;
-			tempTileID = i;
-			gridY++;
+			const FIntPoint coordinates = topology.GetTileCoordinate(i);
+			minimumCoordinates = minimumCoordinates.ComponentMin(coordinates);
+			maximumCoordinates = maximumCoordinates.ComponentMax(coordinates);
 		}
 	}
 
-	FVector2D Result;
-	Result.X = gridX;
-	Result.Y = gridY;
+	if (minimumCoordinates.X > maximumCoordinates.X)
+	{
+		return FVector2D::ZeroVector;
+	}
 
-	return Result;
+	const FIntPoint zoneSize = maximumCoordinates - minimumCoordinates + FIntPoint(1, 1);
+	return FVector2D(zoneSize.X, zoneSize.Y);
 }
 
-FVector2D ATT_BlockManager::GetTileGridCoordinate(int tileID)
+FIntPoint ATT_BlockManager::GetTileGridCoordinate(int tileID)
 {
-	int X, Y;
-
-	X = FMath::TruncToInt(tileID / GridManager->GetGridSize().X);
-	Y = tileID - (X * GridManager->GetGridSize().X);
-
-	return FVector2D(X, Y);
+	return GridManager->GetGridTopology().GetTileCoordinate(tileID);
 }
 
 bool ATT_BlockManager::CheckZoneTileIDs(TArray<int> zoneTileIDs, int tileA, int tileB)
 {
-	bool isSuccessful = true;
-	FVector2D minimumCoordinates = GetTileGridCoordinate(tileA);
-	FVector2D maximumCoordinates = GetTileGridCoordinate(tileB);
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	if (!topology.IsTileValid(tileA) || !topology.IsTileValid(tileB))
+	{
+		return false;
+	}
+
+	const FIntPoint minimumCoordinates = topology.GetTileCoordinate(tileA);
+	const FIntPoint maximumCoordinates = topology.GetTileCoordinate(tileB);
 
 	for (int i : zoneTileIDs)
 	{
-		FVector2D tileToCheck = GetTileGridCoordinate(i);
-
-		if (!GridManager->IsTileValid(i))
+		if (!topology.IsTileValid(i))
 		{
-			isSuccessful = false;
+			return false;
 		}
 
 		// Check if tileToCheck is in the range of coordinates. 
+		const FIntPoint tileToCheck = topology.GetTileCoordinate(i);
 		if ( !(tileToCheck.X >= minimumCoordinates.X && tileToCheck.X <= maximumCoordinates.X && tileToCheck.Y >= minimumCoordinates.Y && tileToCheck.Y <= maximumCoordinates.Y) )
 		{ 
-			isSuccessful = false;
+			return false;
 		}
 	}
 
-	return isSuccessful;
+	return true;
 }
 
 bool ATT_BlockManager::CheckIfBlockIsBuildable(int tileID, int sizeX, int sizeY, bool isModuloHalfPi)
 {
-	TArray<int> OutZoneTile;
-	bool result = CheckIfBlockIsBuildable(tileID, sizeX, sizeY, isModuloHalfPi, OutZoneTile);
-	return result;
+	return GetPlacementValidityMap(sizeX, sizeY, isModuloHalfPi).IsTileValid(tileID);
 }
 
-bool ATT_BlockManager::CheckIfBlockIsBuildable(int tileID, int sizeX, int sizeY, bool isModuloHalfPi, TArray<int>& OutZoneTileIDs)
+bool ATT_BlockManager::CheckIfBlockIsBuildable(int tileID, int sizeX, int sizeY, bool isModuloHalfPi, FTT_TileRect& OutBlockRect)
 {
-	TArray<int> placingBlockOccupiedTiles;
-	OutZoneTileIDs = placingBlockOccupiedTiles;
-	bool isBlockClearToBePlaced = true;
+	OutBlockRect = FTT_TileRect();
 
 	int tileA = GetZoneStartTileFromHoveredTile(tileID, sizeX, sizeY, isModuloHalfPi);
 	int tileB = GetZoneEndTileFromZoneSize(tileA, sizeX, sizeY, isModuloHalfPi);
 
-	if (tileA != -1 && tileB != -1)
+	// Both corners are on the grid so the whole zone is, only the overlap with other blocks is left to check
+	if (tileA == -1 || tileB == -1)
 	{
-		placingBlockOccupiedTiles = GetZoneTileIDsFromZoneParameters(tileA, tileB, false);
-
-		// Check that the block's zone isn't going over the edge of the grid
-		if (!CheckZoneTileIDs(placingBlockOccupiedTiles, tileA, tileB))
-		{
-			return false;
-		}
+		return false;
+	}
 
-		// Check that the block's zone isn't overlapping another block
-		for (auto i : placingBlockOccupiedTiles)
-		{
-			if (GridManager->IsTileValid(i))
-			{
-				if (GridManager->BlockManager->GetSpawnedBlockIDs()[i] != 0)
-				{
-					return false;
-				}
-			}
+	const FTT_TileRect blockRect = GetZoneRectFromZoneParameters(tileA, tileB);
+	const bool isBlockClearToBePlaced = blockOccupancy.IsRectFree(blockRect);
 
-			else
-			{
-				return false;
-			}
-		}
-	}
-	else
+	if (isBlockClearToBePlaced)
 	{
-		return false;
+		OutBlockRect = blockRect;
 	}
-	OutZoneTileIDs = placingBlockOccupiedTiles;
-	return true;
+	return isBlockClearToBePlaced;
 }
 
 bool ATT_BlockManager::GetNearestBuildableTileID(int& OutTileID, int tileID, int sizeX, int sizeY, bool isModuloHalfPi)
 {
-	TArray<int> Neighbours = GridManager->GetTileNeighbours(tileID, true);
-	TArray<int> ExtraNeighbours;
+	OutTileID = -1;
+	const FTT_PlacementValidityMap& validityMap = GetPlacementValidityMap(sizeX, sizeY, isModuloHalfPi);
 
-	for (int i : Neighbours)
+	// The neighbours first, then the tiles two tiles away from tileID (corners included, unlike the Euclidean radius of the other overload)
+	for (int ring = 1; ring <= 2; ring++)
 	{
-		if (GridManager->IsTileValid(i))
+		GridManager->ForEachTileInRing(tileID, ring, ETT_TileDistance::Chebyshev, [&](int32 ringTileID)
 		{
-			if (CheckIfBlockIsBuildable(i, sizeX, sizeY, isModuloHalfPi))
+			if (validityMap.IsTileValid(ringTileID))
 			{
-				OutTileID = i;
-				return true;
-			}
-
-			for (int j : GridManager->GetTileNeighbours(i, true))
-			{
-				if (!ExtraNeighbours.Contains(j))
-				{
-					ExtraNeighbours.Add(j);
-				}
+				OutTileID = ringTileID;
+				return false;
 			}
-		}
-	}
+			return true;
+		});
 
-	for (int a : ExtraNeighbours)
-	{
-		if (GridManager->IsTileValid(a))
+		if (OutTileID != -1)
 		{
-			if (CheckIfBlockIsBuildable(a, sizeX, sizeY, isModuloHalfPi))
-			{
-				OutTileID = a;
-				return true;
-			}
+			return true;
 		}
 	}
-
-	OutTileID = -1;
 	return false;
 }
 
+bool ATT_BlockManager::GetNearestBuildableTileID(int& OutTileID, int tileID, int sizeX, int sizeY, bool isModuloHalfPi, int maxRadius, const FVector2D& cursorCoordinate)
+{
+	OutTileID = GetPlacementValidityMap(sizeX, sizeY, isModuloHalfPi).FindNearestValidTile(tileID, maxRadius, cursorCoordinate);
+	return OutTileID != -1;
+}
+
 
 /*---------- Data Table functions ----------*/
 
@@ -665,18 +1017,17 @@ UDataTable* ATT_BlockManager::GetBlockDataTable()
 
 void ATT_BlockManager::RefreshDataFromDataTable()
 {
-	if (data_Block)
+	// The data table is only parsed here, everything else reads the catalog
+	if (blockCatalog.Build(data_Block))
 	{
 		blockTypeMap.Empty();
 		zoneIDMap.Empty();
+		zoneBuildingIDMap.Empty();
+		allBlockIDs = blockCatalog.GetBlockIDs();
 
-		FString contextString;
-		TArray<FName> rowNames;
-		rowNames = data_Block->GetRowNames();
-
-		for (auto& name : rowNames)
+		for (int blockID : allBlockIDs)
 		{
-			FTT_Struct_Block* row = data_Block->FindRow<FTT_Struct_Block>(name, contextString);
+			FTT_Struct_Block* row = blockCatalog.FindStats(blockID);
 			if (row)
 			{
 				if ( !(row->Category_Name == "") && row->Block_Type != EBlockType::BT_Nothing)
@@ -690,7 +1041,7 @@ void ATT_BlockManager::RefreshDataFromDataTable()
 						(
 							row->Category_Name,
 							TArray<FString>({ row->Block_Name.ToString() }),
-							TArray<int>({ FCString::Atoi(*name.ToString()) })
+							TArray<int>({ blockID })
 						);
 
 						blockTypeMap.Add(row->Category_Name, tempBlockType);
@@ -701,19 +1052,19 @@ void ATT_BlockManager::RefreshDataFromDataTable()
 					{
 						// Just add block ID and Name to it
 						blockTypeMap.Find(row->Category_Name)->Block_Name.Add(row->Block_Name.ToString());
-						blockTypeMap.Find(row->Category_Name)->BlockIDs.Add(FCString::Atoi(*name.ToString()));
+						blockTypeMap.Find(row->Category_Name)->BlockIDs.Add(blockID);
 					}
 
 					// If row is a zone add it to the zone map
 					if (row->Block_Type == EBlockType::BT_Zone)
 					{
-						zoneIDMap.Add(row->Block_Name.ToString(), FCString::Atoi(*name.ToString()));
+						zoneIDMap.Add(row->Block_Name.ToString(), blockID);
 					}
 
 					// If row is a zone building add it to the zone map
 					if (row->Block_Type == EBlockType::BT_ZoneBuilding)
 					{
-						//zoneBuildingIDMap.Add(row->Category_Name, FCString::Atoi(*name.ToString()));
+						//zoneBuildingIDMap.Add(row->Category_Name, blockID);
 
 						if (!zoneBuildingIDMap.Contains(row->Category_Name))
 						{
@@ -722,7 +1073,7 @@ void ATT_BlockManager::RefreshDataFromDataTable()
 							(
 								row->Category_Name,
 								TArray<FString>({ row->Block_Name.ToString() }),
-								TArray<int>({ FCString::Atoi(*name.ToString()) })
+								TArray<int>({ blockID })
 							);
 
 							zoneBuildingIDMap.Add(row->Category_Name, tempZoneBlockType);
@@ -733,7 +1084,7 @@ void ATT_BlockManager::RefreshDataFromDataTable()
 						{
 							// Just add block ID and Name to it
 							zoneBuildingIDMap.Find(row->Category_Name)->Block_Name.Add(row->Block_Name.ToString());
-							zoneBuildingIDMap.Find(row->Category_Name)->BlockIDs.Add(FCString::Atoi(*name.ToString()));
+							zoneBuildingIDMap.Find(row->Category_Name)->BlockIDs.Add(blockID);
 						}
 					}
 				}
@@ -748,66 +1099,35 @@ void ATT_BlockManager::RefreshDataFromDataTable()
 
 FTT_Struct_Block* ATT_BlockManager::GetBlockStatsFromBlockID(int blockID)
 {
-	if (data_Block)
+	FTT_Struct_Block* blockStats = blockCatalog.FindStats(blockID);
+	if (!blockStats)
 	{
-		FString contextString;
-		TArray<FName> rowNames;
-		rowNames = data_Block->GetRowNames();
+		UE_LOG(LogTemp, Log, TEXT("No block matching blockID %d was found."), blockID);
+	}
+	return blockStats;
+}
 
-		// For all rows of the data table
-		for (auto& name : rowNames)
-		{
-			FTT_Struct_Block* row = data_Block->FindRow<FTT_Struct_Block>(name, contextString);
-			if (row)
-			{
-				// Check if current row is row ID = buildingID
-				if (name == FName(*FString::FromInt(blockID)))
-				{
-					return row;
-				}
-			}
-		}
-		UE_LOG(LogTemp, Log, TEXT("No block matching that buildingID was found."));
-		return nullptr;
+const FTT_BlockRecord* ATT_BlockManager::GetBlockRecordFromBlockID(int blockID) const
+{
+	const FTT_BlockRecord* blockRecord = blockCatalog.FindRecord(blockID);
+	if (!blockRecord)
+	{
+		UE_LOG(LogTemp, Log, TEXT("No block matching blockID %d was found."), blockID);
 	}
-	UE_LOG(LogTemp, Warning, TEXT("Cannot access data_Block in %s , data_Block is not valid."), *GetName());
-	return nullptr;
+	return blockRecord;
 }
 
 const FTT_Struct_Block ATT_BlockManager::GetBlockStatsInDataTable(int blockID)
 {
-	return *GetBlockStatsFromBlockID(blockID);
+	FTT_Struct_Block* blockStats = GetBlockStatsFromBlockID(blockID);
+	return blockStats ? *blockStats : FTT_Struct_Block();
 }
 
 TArray<int> ATT_BlockManager::GetAllBlockIDsFromParameter(FString buildingType, int efficiency, int sizeX, int sizeY)
 {
-	if (!data_Block)
-	{
-		UE_LOG(LogTemp, Warning, TEXT("Cannot access data_Block in /% , data_Block is not valid."), *GetName())
-	}
-
-	FString contextString;
-	TArray<FName> rowNames;
-	TArray<int> matchingBlocks;
-	rowNames = data_Block->GetRowNames();
+	TArray<int> matchingBlocks(blockCatalog.FindCandidates(buildingType, sizeX, sizeY));
 
-	// For all rows of the data table
-	for (auto& name : rowNames)
-	{
-		FTT_Struct_Block* row = data_Block->FindRow<FTT_Struct_Block>(name, contextString);
-		if (row)
-		{
-			// Check if current row matches parameters
-			if (row->Category_Name == buildingType && row->Size_X == sizeX && row->Size_Y == sizeY)
-			{
-				int BlockID = FCString::Atoi(*name.ToString());
-				matchingBlocks.Add(BlockID);
-				UE_LOG(LogTemp, Warning, TEXT("%d"), BlockID);
-			}
-		}
-	}
-
-	if (!(matchingBlocks.Num() == 0))
+	if (matchingBlocks.Num() == 0)
 	{
 		UE_LOG(LogTemp, Log, TEXT("No block matching parameters was found."));
 	}
@@ -817,18 +1137,9 @@ TArray<int> ATT_BlockManager::GetAllBlockIDsFromParameter(FString buildingType,
 
 int  ATT_BlockManager::GetRandomBlockIDFromParameter(FString buildingType, int efficiency, int sizeX, int sizeY)
 {
-	//Get array of matching blocks
-	TArray<int> matchingBlocks;
-	matchingBlocks = GetAllBlockIDsFromParameter(buildingType, efficiency, sizeX, sizeY);
-
-	if (matchingBlocks.Num() > 0)
-	{
-		// Return random index in matchingBlock array
-		int randomIndex = FMath::RandRange(0, (matchingBlocks.Num() - 1));
-		return matchingBlocks[randomIndex];
-	}
-
-	return 0;
+	// Picked straight from the catalog's index, no array is built
+	const int blockID = blockCatalog.PickRandomCandidate(buildingType, sizeX, sizeY);
+	return blockID != INDEX_NONE ? blockID : 0;
 }
 
 
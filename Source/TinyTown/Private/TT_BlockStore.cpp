@@ -0,0 +1,178 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_BlockStore.h"
+
+void FTT_BlockStore::Reset()
+{
+	// Generations are kept so that handles to the removed blocks stay stale
+	FreeSlots.Reset();
+	for (int32 slotIndex = SlotGenerations.Num() - 1; slotIndex >= 0; slotIndex--)
+	{
+		if (SlotDenseIndices[slotIndex] != INDEX_NONE)
+		{
+			SlotDenseIndices[slotIndex] = INDEX_NONE;
+			ReleaseSlot(slotIndex);
+		}
+		else if (SlotGenerations[slotIndex] != GetRetiredGeneration())
+		{
+			FreeSlots.Add(slotIndex);
+		}
+	}
+
+	Handles.Reset();
+	BlockIDs.Reset();
+	CentralTileIDs.Reset();
+	Yaws.Reset();
+	TileRects.Reset();
+	States.Reset();
+	Actors.Reset();
+	InstanceIndices.Reset();
+}
+
+FTT_BlockHandle FTT_BlockStore::Add(int32 blockID, int32 centralTileID, float yaw, const FTT_TileRect& tileRect)
+{
+	int32 slotIndex;
+	if (FreeSlots.Num() > 0)
+	{
+		slotIndex = FreeSlots.Pop(false);
+	}
+	else if (SlotGenerations.Num() < GetMaxBlocks())
+	{
+		slotIndex = SlotGenerations.Add(1);
+		SlotDenseIndices.Add(INDEX_NONE);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("Block store is full (%d blocks), cannot add block %d."), GetMaxBlocks(), blockID);
+		return FTT_BlockHandle();
+	}
+
+	const FTT_BlockHandle handle(slotIndex, SlotGenerations[slotIndex]);
+	SlotDenseIndices[slotIndex] = Handles.Num();
+
+	Handles.Add(handle);
+	BlockIDs.Add(blockID);
+	CentralTileIDs.Add(centralTileID);
+	Yaws.Add(yaw);
+	TileRects.Add(tileRect);
+	States.Add(ETT_BlockState::Reserved);
+	Actors.Add(nullptr);
+	InstanceIndices.Add(INDEX_NONE);
+
+	return handle;
+}
+
+bool FTT_BlockStore::Remove(FTT_BlockHandle handle)
+{
+	const int32 index = GetIndex(handle);
+	if (index == INDEX_NONE)
+	{
+		return false;
+	}
+
+	// The last block takes the removed block's place in the dense arrays
+	const int32 lastIndex = Handles.Num() - 1;
+	if (index != lastIndex)
+	{
+		SlotDenseIndices[Handles[lastIndex].GetSlotIndex()] = index;
+	}
+
+	Handles.RemoveAtSwap(index, 1, false);
+	BlockIDs.RemoveAtSwap(index, 1, false);
+	CentralTileIDs.RemoveAtSwap(index, 1, false);
+	Yaws.RemoveAtSwap(index, 1, false);
+	TileRects.RemoveAtSwap(index, 1, false);
+	States.RemoveAtSwap(index, 1, false);
+	Actors.RemoveAtSwap(index, 1, false);
+	InstanceIndices.RemoveAtSwap(index, 1, false);
+
+	const int32 slotIndex = handle.GetSlotIndex();
+	SlotDenseIndices[slotIndex] = INDEX_NONE;
+	ReleaseSlot(slotIndex);
+
+	return true;
+}
+
+void FTT_BlockStore::ReleaseSlot(int32 slotIndex)
+{
+	// A slot whose generation can't grow anymore is never used again: wrapping around would make the oldest handles to it valid again
+	if (SlotGenerations[slotIndex] == GetRetiredGeneration())
+	{
+		return;
+	}
+
+	SlotGenerations[slotIndex]++;
+	if (SlotGenerations[slotIndex] != GetRetiredGeneration())
+	{
+		FreeSlots.Add(slotIndex);
+	}
+}
+
+int32 FTT_BlockStore::GetBlockID(FTT_BlockHandle handle) const
+{
+	const int32 index = GetIndex(handle);
+	return index != INDEX_NONE ? BlockIDs[index] : 0;
+}
+
+int32 FTT_BlockStore::GetCentralTileID(FTT_BlockHandle handle) const
+{
+	const int32 index = GetIndex(handle);
+	return index != INDEX_NONE ? CentralTileIDs[index] : -1;
+}
+
+float FTT_BlockStore::GetYaw(FTT_BlockHandle handle) const
+{
+	const int32 index = GetIndex(handle);
+	return index != INDEX_NONE ? Yaws[index] : 0.f;
+}
+
+FTT_TileRect FTT_BlockStore::GetTileRect(FTT_BlockHandle handle) const
+{
+	const int32 index = GetIndex(handle);
+	return index != INDEX_NONE ? TileRects[index] : FTT_TileRect();
+}
+
+ATT_Block* FTT_BlockStore::GetActor(FTT_BlockHandle handle) const
+{
+	const int32 index = GetIndex(handle);
+	return index != INDEX_NONE ? Actors[index] : nullptr;
+}
+
+ETT_BlockState FTT_BlockStore::GetState(FTT_BlockHandle handle) const
+{
+	const int32 index = GetIndex(handle);
+	return index != INDEX_NONE ? States[index] : ETT_BlockState::Reserved;
+}
+
+int32 FTT_BlockStore::GetInstanceIndex(FTT_BlockHandle handle) const
+{
+	const int32 index = GetIndex(handle);
+	return index != INDEX_NONE ? InstanceIndices[index] : INDEX_NONE;
+}
+
+void FTT_BlockStore::SetState(FTT_BlockHandle handle, ETT_BlockState state)
+{
+	const int32 index = GetIndex(handle);
+	if (index != INDEX_NONE)
+	{
+		States[index] = state;
+	}
+}
+
+void FTT_BlockStore::SetActor(FTT_BlockHandle handle, ATT_Block* actor)
+{
+	const int32 index = GetIndex(handle);
+	if (index != INDEX_NONE)
+	{
+		Actors[index] = actor;
+	}
+}
+
+void FTT_BlockStore::SetInstanceIndex(FTT_BlockHandle handle, int32 instanceIndex)
+{
+	const int32 index = GetIndex(handle);
+	if (index != INDEX_NONE)
+	{
+		InstanceIndices[index] = instanceIndex;
+	}
+}
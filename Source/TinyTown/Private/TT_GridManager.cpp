@@ -7,6 +7,8 @@
 #include "TimerManager.h"
 #include "Engine/TextRenderActor.h"
 #include "Components/TextRenderComponent.h"
+#include "Math/ScaleMatrix.h"
+#include "Math/TranslationMatrix.h"
 
 /*---------- Primary functions ----------*/
 
@@ -21,7 +23,10 @@ ATT_GridManager::ATT_GridManager()
 	instanceGroupedSpriteComp->SetupAttachment(Root);
 
 	/*---------- Setting defaults ----------*/
-	PrimaryActorTick.bCanEverTick = false;
+	// Only ticks while chunks need their render state rebuilt
+	PrimaryActorTick.bCanEverTick = true;
+	PrimaryActorTick.bStartWithTickEnabled = false;
+	PrimaryActorTick.TickGroup = TG_PostUpdateWork;
 
 }
 
@@ -30,71 +35,107 @@ void ATT_GridManager::OnConstruction(const FTransform& Transform)
 	Super::OnConstruction(Transform);
 
 		// Refresh the grid only when the grid size has been changed. Enables moving the grid with refreshing all instances.
-		instanceGroupedSpriteComp->ClearInstances();
-		tileLocations.Empty();
+		ClearTiles();
 
-		for (ATextRenderActor* i : tileIDActors)
-		{
-			i->Destroy(true, true);
-		}
-		tileIDActors.Empty();
+		RefreshGridTopology();
+		SpawnTiles();
+
+}
 
-		SpawnTiles(gridSizeX, gridSizeY, GetActorLocation(), distanceBetweenTiles);
+void ATT_GridManager::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
 
+	FlushTileVisuals();
 }
 
 void ATT_GridManager::BeginPlay()
 {
 	Super::BeginPlay();
 
+	RefreshGridTopology();
+	tileVisualBuffer.Init(gridTopology);
+	tileOverlays.Init(gridTopology);
 	SpawnBlockManager();
+}
 
-	tileIDs.Empty();
+void ATT_GridManager::SpawnTiles()
+{
+	const FQuat tileRotation = GetActorQuat() * FQuat(FRotator(0, 0, -90));
+
+	// Locations are calculated one chunk at a time (see GetTileLocations), nothing grid sized is kept around
+	tileVisualBuffer.Init(gridTopology);
+	tileOverlays.Init(gridTopology);
+
+	TArray<int> chunkTileIDs;
+	TArray<FVector> chunkLocations;
+	chunkTileIDs.Reserve(FTT_GridTopology::GetChunkSize() * FTT_GridTopology::GetChunkSize());
 
-	for (int i = 0; i < instanceGroupedSpriteComp->GetInstanceCount(); i++)
+	for (int chunkIndex = 0; chunkIndex < gridTopology.GetNumChunks(); chunkIndex++)
 	{
-		tileIDs.Add(i);
+		// The chunk components copy the settings of instanceGroupedSpriteComp
+		UPaperGroupedSpriteComponent* chunkComp = NewObject<UPaperGroupedSpriteComponent>(this, NAME_None, RF_NoFlags, instanceGroupedSpriteComp);
+		chunkComp->CreationMethod = EComponentCreationMethod::Instance;
+		chunkComp->SetupAttachment(Root);
+		chunkComp->RegisterComponent();
+		AddInstanceComponent(chunkComp);
+		tileChunkComps.Add(chunkComp);
+
+		// Instance index = tile index inside the chunk
+		chunkTileIDs.Reset();
+		for (int localIndex = 0; localIndex < gridTopology.GetChunkNumTiles(chunkIndex); localIndex++)
+		{
+			chunkTileIDs.Add(gridTopology.GetChunkTileID(chunkIndex, localIndex));
+		}
+		GetTileLocations(chunkTileIDs, chunkLocations, true);
+
+		for (int i = 0; i < chunkTileIDs.Num(); i++)
+		{
+			SpawnTileInstance(chunkComp, chunkTileIDs[i], chunkLocations[i], tileRotation);
+		}
 	}
 }
 
-void ATT_GridManager::SpawnTiles(int x, int y, FVector center, float distance)
+void ATT_GridManager::SpawnTileInstance(UPaperGroupedSpriteComponent* chunkComp, int tileID, const FVector& newLocation, const FQuat& tileRotation)
 {
-	int tileCounter = -1;
+	FTransform tileTransform = FTransform(tileRotation, newLocation, FVector(1, 1, 1));
+	chunkComp->AddInstance(tileTransform, tileSpriteNormal, true, FLinearColor::White);
 
-	for (int i = 0; i < y; i++)
+	if (displayTileID)
 	{
-		for (int j = 0; j < x; j++)
-		{
-			tileCounter++;
+		ATextRenderActor* Text = GetWorld()->SpawnActor<ATextRenderActor>(ATextRenderActor::StaticClass(), FVector(0.f, 100, 170.f), FRotator(90.f, 180.f, 0.f));
+		Text->GetTextRender()->SetText(FText::AsNumber(tileID));
+		Text->GetTextRender()->SetTextRenderColor(FColor::White);
+		Text->GetTextRender()->SetVerticalAlignment(EVRTA_TextCenter);
+		Text->GetTextRender()->SetHorizontalAlignment(EHTA_Center);
+		Text->SetActorLocation(newLocation);
+		Text->SetActorScale3D(FVector(4.f, 4.f, 4.f));
 
-			//Calculating new location (will spawn around center vector hence the very long expression). Taken from "2D Grid Execution Macro".
-			FVector newLocation = FVector(center + (FVector(distance * 0.5f, distance * 0.5f, 0.0f) + (distance * (FVector((j - (float(x) / 2)), (i - (float(y) / 2)), 0.0f)))));
-			tileLocations.Add(newLocation);
-
-			FTransform tileTransform = FTransform(FRotator(0, 0, -90), newLocation, FVector(1, 1, 1));
-			instanceGroupedSpriteComp->AddInstance(tileTransform, tileSpriteNormal, true, FLinearColor::White);
-
-			if (displayTileID)
-			{
-				int tileID = tileCounter;
-				ATextRenderActor* Text = GetWorld()->SpawnActor<ATextRenderActor>(ATextRenderActor::StaticClass(), FVector(0.f, 100, 170.f), FRotator(90.f, 180.f, 0.f));
-				Text->GetTextRender()->SetText(FText::AsNumber(tileID));
-				Text->GetTextRender()->SetTextRenderColor(FColor::White);
-				Text->GetTextRender()->SetVerticalAlignment(EVRTA_TextCenter);
-				Text->GetTextRender()->SetHorizontalAlignment(EHTA_Center);
-				Text->SetActorLocation(newLocation);
-				Text->SetActorScale3D(FVector(4.f, 4.f, 4.f));
+		tileIDActors.Add(Text);
+	}
+}
 
-				tileIDActors.Add(Text);
-			}
+void ATT_GridManager::ClearTiles()
+{
+	// Tiles used to be instances of this component, levels saved before the chunks may still hold them
+	instanceGroupedSpriteComp->ClearInstances();
 
+	for (UPaperGroupedSpriteComponent* chunkComp : tileChunkComps)
+	{
+		if (chunkComp)
+		{
+			RemoveInstanceComponent(chunkComp);
+			chunkComp->DestroyComponent();
 		}
 	}
+	tileChunkComps.Empty();
+	dirtyTileChunks.Empty();
 
-	for (int i = 0; i < x*y; i++)
+	for (ATextRenderActor* i : tileIDActors)
 	{
-		tileIDs.Add(i);
+		i->Destroy(true, true);
 	}
+	tileIDActors.Empty();
 }
 
 void ATT_GridManager::SpawnBlockManager()
@@ -117,143 +158,149 @@ void ATT_GridManager::SpawnBlockManager()
 }
 
 
+void ATT_GridManager::RefreshGridTopology()
+{
+	gridTopology.SetSize(gridSizeX, gridSizeY);
+}
+
+
 /*---------- Accessor functions ----------*/
 
-FVector ATT_GridManager::GetTileLocation(int tileID, bool WorldSpace)
+FVector ATT_GridManager::GetTileRelativeLocation(int tileID) const
 {
-	FTransform tempTransform;
-	FVector tempVector;
+	// Tiles are laid out around the GridManager's location. Taken from "2D Grid Execution Macro".
+	const FIntPoint coordinate = gridTopology.GetTileCoordinate(tileID);
+	return FVector(distanceBetweenTiles * (coordinate.X + 0.5f - gridSizeX * 0.5f), distanceBetweenTiles * (coordinate.Y + 0.5f - gridSizeY * 0.5f), 0.0f);
+}
 
-	if (IsTileValid(tileID))
+FMatrix ATT_GridManager::GetTileCoordinateMatrix(bool WorldSpace) const
+{
+	// Transforms (column, row, 0, 1) into the location of that tile
+	const FVector firstTileLocation = FVector(distanceBetweenTiles * (0.5f - gridSizeX * 0.5f), distanceBetweenTiles * (0.5f - gridSizeY * 0.5f), 0.0f);
+	FMatrix tileMatrix = FScaleMatrix(FVector(distanceBetweenTiles, distanceBetweenTiles, 1.0f)) * FTranslationMatrix(firstTileLocation);
+
+	if (WorldSpace)
 	{
-		instanceGroupedSpriteComp->GetInstanceTransform(tileID, tempTransform, WorldSpace);
-		tempVector = tempTransform.GetLocation();
+		tileMatrix = tileMatrix * GetActorTransform().ToMatrixWithScale();
+	}
+	return tileMatrix;
+}
+
+FVector ATT_GridManager::GetTileLocation(int tileID, bool WorldSpace)
+{
+	if (!IsTileValid(tileID))
+	{
+		return FVector::ZeroVector;
 	}
 
-	return tempVector;
+	const FVector relativeLocation = GetTileRelativeLocation(tileID);
+	return WorldSpace ? GetActorTransform().TransformPosition(relativeLocation) : relativeLocation;
 }
 
-TArray<int> ATT_GridManager::GetTileNeighbours(int tileID, bool allowDiagonalPaths, TArray<int>& AllNeighboursTileID)
+void ATT_GridManager::GetTileLocations(const TArray<int>& tileIDsToConvert, TArray<FVector>& OutLocations, bool WorldSpace) const
 {
-	TArray<int> neighbours;
-	TArray<int> neighboursAll;
-	FVector2D gridSize = GetGridSize();
-	int currentNeighbour;
-	int tempRow;
+	OutLocations.SetNumUninitialized(tileIDsToConvert.Num());
 
+	const FMatrix tileMatrix = GetTileCoordinateMatrix(WorldSpace);
 
-	// Right tile
-	currentNeighbour = tileID + gridSize.X;
-	if (IsTileValid(currentNeighbour))
-	{
-		neighboursAll.Add(currentNeighbour);
-		neighbours.Add(currentNeighbour);
-	}
-	else
+	for (int i = 0; i < tileIDsToConvert.Num(); i++)
 	{
-		neighboursAll.Add(-1);
-	}
+		const int tileID = tileIDsToConvert[i];
+		if (!gridTopology.IsTileValid(tileID))
+		{
+			OutLocations[i] = FVector::ZeroVector;
+			continue;
+		}
 
-	// Bottom right
-	currentNeighbour = tileID + gridSize.X - 1;
-	tempRow = FMath::TruncToInt(float(tileID / gridSize.X));
-	if (allowDiagonalPaths && tileID % int(gridSize.X) != 0 && tileID != tempRow * gridSize.X && IsTileValid(currentNeighbour))
-	{
-		neighboursAll.Add(currentNeighbour);
-		neighbours.Add(currentNeighbour);
-	}
-	else if (allowDiagonalPaths)
-	{
-		neighboursAll.Add(-1);
+		const FIntPoint coordinate = gridTopology.GetTileCoordinate(tileID);
+		const VectorRegister tileCoordinate = MakeVectorRegister(float(coordinate.X), float(coordinate.Y), 0.0f, 1.0f);
+		VectorStoreFloat3(VectorTransformVector(tileCoordinate, &tileMatrix), &OutLocations[i]);
 	}
+}
 
-	// Bottom tile
-	currentNeighbour = tileID - 1;
-	tempRow = FMath::TruncToInt(float(tileID / gridSize.X));
-	if (tileID % int(gridSize.X) != 0 && IsTileValid(currentNeighbour) && tileID != tempRow * gridSize.X) 
-	{
-		neighboursAll.Add(currentNeighbour);
-		neighbours.Add(currentNeighbour);
-	}
-	else
+int ATT_GridManager::GetTileIDFromLocation(FVector location, bool WorldSpace) const
+{
+	if (distanceBetweenTiles <= 0.0f)
 	{
-		neighboursAll.Add(-1);
+		return -1;
 	}
 
-	// Bottom left
-	currentNeighbour = tileID - gridSize.X - 1;
-	tempRow = FMath::TruncToInt(float(tileID / gridSize.X));
-	if (allowDiagonalPaths && tileID % int(gridSize.X) != 0 && tileID != tempRow * gridSize.X && IsTileValid(currentNeighbour))
-	{
-		neighboursAll.Add(currentNeighbour);
-		neighbours.Add(currentNeighbour);		
-	}
-	else if(allowDiagonalPaths)
-	{
-		neighboursAll.Add(-1);
-	}
+	const FVector2D gridCoordinate = GetGridCoordinateFromLocation(location, WorldSpace);
+	const FIntPoint coordinate(FMath::FloorToInt(gridCoordinate.X), FMath::FloorToInt(gridCoordinate.Y));
 
-	// Left tile
-	currentNeighbour = tileID - gridSize.X;
-	if (IsTileValid(currentNeighbour))
-	{
-		neighboursAll.Add(currentNeighbour);
-		neighbours.Add(currentNeighbour);
-	}
-	else
-	{
-		neighboursAll.Add(-1);
-	}
+	return gridTopology.GetTileID(coordinate);
+}
 
-	// Top left
-	currentNeighbour = tileID - gridSize.X + 1;
-	tempRow = FMath::TruncToInt(float(tileID + 1 / gridSize.X));
-	if (allowDiagonalPaths && (tileID + 1) % int(gridSize.X) != 0 && tileID + 1 != tempRow * gridSize.X && IsTileValid(currentNeighbour))
-	{
-		neighboursAll.Add(currentNeighbour);
-		neighbours.Add(currentNeighbour);
-	}
-	else if (allowDiagonalPaths)
+FVector2D ATT_GridManager::GetGridCoordinateFromLocation(FVector location, bool WorldSpace) const
+{
+	if (distanceBetweenTiles <= 0.0f)
 	{
-		neighboursAll.Add(-1);
+		return FVector2D::ZeroVector;
 	}
 
-	// Top tile
-	currentNeighbour = tileID + 1;
-	tempRow = FMath::TruncToInt(float(tileID + 1 / gridSize.X));
-	if ((tileID + 1) % int(gridSize.X) != 0 && IsTileValid(currentNeighbour) && tileID + 1 != tempRow * gridSize.X) 
-	{
-		neighboursAll.Add(currentNeighbour);
-		neighbours.Add(currentNeighbour);
-	}
-	else
+	const FVector relativeLocation = WorldSpace ? GetActorTransform().InverseTransformPosition(location) : location;
+	return FVector2D
+	(
+		relativeLocation.X / distanceBetweenTiles + gridSizeX * 0.5f,
+		relativeLocation.Y / distanceBetweenTiles + gridSizeY * 0.5f
+	);
+}
+
+int ATT_GridManager::GetTileIDFromRay(FVector rayOrigin, FVector rayDirection) const
+{
+	FVector hitLocation;
+	if (!GetRayGridIntersection(rayOrigin, rayDirection, hitLocation))
 	{
-		neighboursAll.Add(-1);
+		return -1;
 	}
 
-	// Top right tile
-	currentNeighbour = tileID - gridSize.X + 1;
-	tempRow = FMath::TruncToInt(float(tileID + 1 / gridSize.X));
-	if (allowDiagonalPaths && (tileID + 1) % int(gridSize.X) != 0 && tileID + 1 != tempRow * gridSize.X && IsTileValid(currentNeighbour))
+	return GetTileIDFromLocation(hitLocation, true);
+}
+
+bool ATT_GridManager::GetRayGridIntersection(FVector rayOrigin, FVector rayDirection, FVector& OutLocation) const
+{
+	// The tiles lie on the GridManager's XY plane
+	const FVector planeNormal = GetActorUpVector();
+	const float directionDotNormal = FVector::DotProduct(rayDirection, planeNormal);
+
+	if (FMath::IsNearlyZero(directionDotNormal))
 	{
-		neighboursAll.Add(currentNeighbour);
-		neighbours.Add(currentNeighbour);
+		return false;
 	}
-	else if (allowDiagonalPaths)
+
+	const float distance = FVector::DotProduct(GetActorLocation() - rayOrigin, planeNormal) / directionDotNormal;
+	if (distance < 0.0f)
 	{
-		neighboursAll.Add(-1);
+		return false;
 	}
 
-	AllNeighboursTileID = neighboursAll;
-	return neighbours;
+	OutLocation = rayOrigin + rayDirection * distance;
+	return true;
+}
+
+TArray<int> ATT_GridManager::GetTileNeighbours(int tileID, bool allowDiagonalPaths, TArray<int>& AllNeighboursTileID)
+{
+	AllNeighboursTileID = gridTopology.GetAllNeighbours(tileID, allowDiagonalPaths).ToArray();
+	return gridTopology.GetNeighbours(tileID, allowDiagonalPaths).ToArray();
 }
 
 TArray<int> ATT_GridManager::GetTileNeighbours(int tileID, bool allowDiagonalPaths)
 {
-	TArray<int> tempBoolArray;
-	TArray<int> returnArray = GetTileNeighbours(tileID, allowDiagonalPaths, tempBoolArray);
+	return gridTopology.GetNeighbours(tileID, allowDiagonalPaths).ToArray();
+}
 
-	return returnArray;
+FTT_TileRectView ATT_GridManager::GetTileRectView(int tileA, int tileB) const
+{
+	if (!gridTopology.IsTileValid(tileA) || !gridTopology.IsTileValid(tileB))
+	{
+		return FTT_TileRectView();
+	}
+	return FTT_TileRectView(gridTopology, gridTopology.GetTileCoordinate(tileA), gridTopology.GetTileCoordinate(tileB));
+}
+
+FTT_TileNeighbours ATT_GridManager::GetTileNeighboursFast(int tileID, bool allowDiagonalPaths) const
+{
+	return gridTopology.GetNeighbours(tileID, allowDiagonalPaths);
 }
 
 float ATT_GridManager::GetDistanceBetweenTiles()
@@ -266,15 +313,36 @@ FVector2D ATT_GridManager::GetGridSize()
 	return FVector2D(gridSizeX, gridSizeY);
 }
 
+const FTT_GridTopology& ATT_GridManager::GetGridTopology() const
+{
+	return gridTopology;
+}
+
 bool ATT_GridManager::IsTileValid(int tileID)
 {
-	FTransform emptyTransform;
-	return instanceGroupedSpriteComp->GetInstanceTransform(tileID, emptyTransform, false);
+	return gridTopology.IsTileValid(tileID);
+}
+
+int ATT_GridManager::GetTileIDFromInstance(const UPrimitiveComponent* component, int instanceIndex) const
+{
+	const int chunkIndex = tileChunkComps.IndexOfByKey(component);
+	if (chunkIndex == INDEX_NONE || instanceIndex < 0 || instanceIndex >= gridTopology.GetChunkNumTiles(chunkIndex))
+	{
+		return -1;
+	}
+	return gridTopology.GetChunkTileID(chunkIndex, instanceIndex);
 }
 
 TArray<int> ATT_GridManager::GetAllTileIDs()
 {
-	return tileIDs;
+	TArray<int> allTileIDs;
+	allTileIDs.SetNumUninitialized(gridTopology.GetNumTiles());
+
+	for (int i = 0; i < allTileIDs.Num(); i++)
+	{
+		allTileIDs[i] = i;
+	}
+	return allTileIDs;
 }
 
 
@@ -283,19 +351,14 @@ TArray<int> ATT_GridManager::GetAllTileIDs()
 void ATT_GridManager::OnTileHovered_Implementation(int tileID)
 {
 	// Check if the tile is already hovered
-	if (!modifiedTiles.Contains(tileID) || viewModeTiles.Contains(tileID))
+	if (!tileOverlays.IsTileInLayer(ETileOverlay::TO_Hover, tileID))
 	{
-		TileClearState();
+		tileOverlays.ClearLayer(ETileOverlay::TO_Hover);
+		tileOverlays.ClearLayer(ETileOverlay::TO_Click);
 		lastClickedTile = -1;
 
-		FTransform tempTileTransform;
-		instanceGroupedSpriteComp->GetInstanceTransform(tileID, tempTileTransform, true);
-		FTransform newTransform = FTransform(tempTileTransform.GetRotation(), tempTileTransform.GetLocation(), FVector(1.1f, 1.1f, 1.1f));
-
-		instanceGroupedSpriteComp->UpdateInstanceTransform(tileID, newTransform, true);
-
-		//Marks the tile as hovered or "modified"
-		modifiedTiles.Add(tileID);
+		tileOverlays.SetTile(ETileOverlay::TO_Hover, tileID, FTT_TileOverlayValue::MakeScale(1.1f));
+		QueueTileVisualFlush();
 	}
 }
 
@@ -307,19 +370,11 @@ void ATT_GridManager::OnTileUnHovered_Implementation(int tileID)
 void ATT_GridManager::OnTileClicked_Implementation(int tileID)
 {
 	//Check the tile is hovered and hasn't been clicked
-	if (modifiedTiles.Contains(tileID) && (lastClickedTile == -1))
+	if (tileOverlays.IsTileInLayer(ETileOverlay::TO_Hover, tileID) && (lastClickedTile == -1))
 	{
-		TileClearState();
-
-		FTransform tempTileTransform;
-		instanceGroupedSpriteComp->GetInstanceTransform(tileID, tempTileTransform, true);
-		FTransform newTransform = FTransform(tempTileTransform.GetRotation(), tempTileTransform.GetLocation(), FVector(0.8f, 0.8f, 0.8f));
-
-		instanceGroupedSpriteComp->UpdateInstanceTransform(tileID, newTransform, true);
-
-		//Marks the tile as hovered or "modified" and as clicked
-		int32 clickedTile = tileID;
-		modifiedTiles.Add(clickedTile);
+		tileOverlays.ClearLayer(ETileOverlay::TO_Click);
+		tileOverlays.SetTile(ETileOverlay::TO_Click, tileID, FTT_TileOverlayValue::MakeScale(0.8f));
+		QueueTileVisualFlush();
 	}
 }
 
@@ -328,33 +383,50 @@ void ATT_GridManager::OnTileUnClicked_Implementation(int tileID)
 
 }
 
-void ATT_GridManager::SetTileColorToBlockID(TArray<int> tileIDs, int blockID)
+void ATT_GridManager::SetTileColorToBlockID(const TArray<int>& tileIDs, int blockID)
 {
 	if (tileIDs.Num() > 0)
 	{
-		TileClearState();
+		// Replaces the previous preview, only the tiles entering or leaving it are updated
+		SetTileOverlayColour(ETileOverlay::TO_Preview, tileIDs, GetBlockGridColour(blockID));
+	}
+}
 
-		FLinearColor ZoneColour;
-		ZoneColour = FVector(0.1, 0.1, 0.1);
+void ATT_GridManager::SetTileRectColorToBlockID(FTT_TileRect tileRect, int blockID)
+{
+	if (!tileRect.IsEmpty())
+	{
+		tileOverlays.SetLayerTiles(ETileOverlay::TO_Preview, tileRect, FTT_TileOverlayValue::MakeColour(GetBlockGridColour(blockID)));
+		QueueTileVisualFlush();
+	}
+}
 
-		if(blockID != -1)
-		{ 
-			ZoneColour = BlockManager->GetBlockStatsFromBlockID(blockID)->Grid_Colour;
-		}
+FLinearColor ATT_GridManager::GetBlockGridColour(int blockID)
+{
+	FLinearColor ZoneColour;
+	ZoneColour = FVector(0.1, 0.1, 0.1);
 
-		for (int i = 0; i < tileIDs.Num(); ++i)
+	if(blockID != -1)
+	{ 
+		if (const FTT_BlockRecord* BlockRecord = BlockManager->GetBlockRecordFromBlockID(blockID))
 		{
-				SetTileColour(tileIDs[i], ZoneColour);
+			ZoneColour = BlockRecord->GridColour;
 		}
 	}
+	return ZoneColour;
 }
 
 void ATT_GridManager::SetTileColour(int tileID, FLinearColor colour)
 {
 	if (IsTileValid(tileID))
 	{
-		instanceGroupedSpriteComp->UpdateInstanceColor(tileID, colour);
-		modifiedTiles.Add(tileID);
+		const FTT_TileOverlayValue* previewValue = tileOverlays.FindTile(ETileOverlay::TO_Preview, tileID);
+		FTT_TileOverlayValue newValue = previewValue ? *previewValue : FTT_TileOverlayValue();
+		newValue.Colour = colour;
+		newValue.bOverridesColour = true;
+
+		tileOverlays.SetTile(ETileOverlay::TO_Preview, tileID, newValue);
+		QueueTileVisualFlush();
 	}
 	else
 	{
@@ -366,7 +438,9 @@ void ATT_GridManager::SetTileTransform(int tileID, FTransform newTransform, bool
 {
 	if (IsTileValid(tileID))
 	{
-		instanceGroupedSpriteComp->UpdateInstanceTransform(tileID, newTransform, WorldSpace);
+		// Arbitrary transforms can't be described by the visual buffer, they are pushed directly
+		UpdateTileInstanceTransform(tileID, newTransform, WorldSpace);
+		QueueTileVisualFlush();
 	}
 
 	else
@@ -379,12 +453,13 @@ void ATT_GridManager::SetTileScale(int tileID, float scale)
 {
 	if (IsTileValid(tileID))
 	{
-		FTransform tileTransform;
-		instanceGroupedSpriteComp->GetInstanceTransform(tileID, tileTransform, false);
+		const FTT_TileOverlayValue* previewValue = tileOverlays.FindTile(ETileOverlay::TO_Preview, tileID);
+		FTT_TileOverlayValue newValue = previewValue ? *previewValue : FTT_TileOverlayValue();
+		newValue.Scale = scale;
+		newValue.bOverridesScale = true;
 
-		FVector newScale3D =  FVector(scale, scale, scale);
-		FTransform newTileTransform = FTransform(tileTransform.GetRotation(), tileTransform.GetLocation(), newScale3D);
-		instanceGroupedSpriteComp->UpdateInstanceTransform(tileID, newTileTransform, false);
+		tileOverlays.SetTile(ETileOverlay::TO_Preview, tileID, newValue);
+		QueueTileVisualFlush();
 	}
 	else
 	{
@@ -392,60 +467,150 @@ void ATT_GridManager::SetTileScale(int tileID, float scale)
 	}
 }
 
-void ATT_GridManager::TileReset(int tileID)
+void ATT_GridManager::SetTileOverlayColour(ETileOverlay layer, const TArray<int>& tileIDs, FLinearColor colour)
 {
-	FTransform tempTileTransform;
-	instanceGroupedSpriteComp->GetInstanceTransform(tileID, tempTileTransform, true);
-	FTransform newTransform = FTransform(tempTileTransform.GetRotation(), tempTileTransform.GetLocation(), FVector(1.0f, 1.0f, 1.0f));
+	tileOverlays.SetLayerTiles(layer, tileIDs, FTT_TileOverlayValue::MakeColour(colour));
+	QueueTileVisualFlush();
+}
 
-	instanceGroupedSpriteComp->UpdateInstanceTransform(tileID, newTransform, true);
-	instanceGroupedSpriteComp->UpdateInstanceColor(tileID, FLinearColor::White, true);
+void ATT_GridManager::ClearTileOverlay(ETileOverlay layer)
+{
+	tileOverlays.ClearLayer(layer);
+	QueueTileVisualFlush();
+}
+
+void ATT_GridManager::TileReset(int tileID)
+{
+	if (IsTileValid(tileID))
+	{
+		tileOverlays.ResetTile(tileID);
+		QueueTileVisualFlush();
+	}
 }
 
 void ATT_GridManager::TileClearState()
 {
-	if (modifiedTiles.Num() > 0) 
+	// View modes and the player's selection stay until they are explicitly cleared
+	tileOverlays.ClearLayer(ETileOverlay::TO_Hover);
+	tileOverlays.ClearLayer(ETileOverlay::TO_Click);
+	tileOverlays.ClearLayer(ETileOverlay::TO_Preview);
+	tileOverlays.ClearLayer(ETileOverlay::TO_Error);
+	QueueTileVisualFlush();
+}
+
+
+/*---------- Tile instances ----------*/
+
+UPaperGroupedSpriteComponent* ATT_GridManager::GetTileChunkComponent(int tileID, int& OutInstanceIndex) const
+{
+	const int chunkIndex = gridTopology.GetChunkIndex(tileID);
+	if (!gridTopology.IsTileValid(tileID) || !tileChunkComps.IsValidIndex(chunkIndex))
 	{
-			for (int i = 0; i < modifiedTiles.Num(); ++i)
-			{
-				int TileID = modifiedTiles[i];
+		OutInstanceIndex = -1;
+		return nullptr;
+	}
 
-				FTransform tempTileTransform;
-				instanceGroupedSpriteComp->GetInstanceTransform(TileID, tempTileTransform, true);
-				FTransform newTransform = FTransform(tempTileTransform.GetRotation(), tempTileTransform.GetLocation(), FVector(1.0f, 1.0f, 1.0f));
+	OutInstanceIndex = gridTopology.GetChunkLocalIndex(tileID);
+	return tileChunkComps[chunkIndex];
+}
 
-				instanceGroupedSpriteComp->UpdateInstanceTransform(TileID, newTransform, true);
+FTransform ATT_GridManager::GetTileInstanceTransform(int tileID, float scale) const
+{
+	const FVector tileLocation = GetActorTransform().TransformPosition(GetTileRelativeLocation(tileID));
+	return FTransform(GetActorQuat() * FQuat(FRotator(0, 0, -90)), tileLocation, FVector(scale, scale, scale));
+}
 
-				if (!viewModeTiles.Contains(TileID))
-				{
-					instanceGroupedSpriteComp->UpdateInstanceColor(TileID, FLinearColor::White, true);
-				}
-			}
-			modifiedTiles.Empty();
+void ATT_GridManager::UpdateTileInstanceTransform(int tileID, const FTransform& newTransform, bool WorldSpace)
+{
+	int instanceIndex;
+	if (UPaperGroupedSpriteComponent* chunkComp = GetTileChunkComponent(tileID, instanceIndex))
+	{
+		chunkComp->UpdateInstanceTransform(instanceIndex, newTransform, WorldSpace, false);
+		MarkTileChunkDirty(gridTopology.GetChunkIndex(tileID));
 	}
+}
 
-	for (int i = 0; i < viewModeTiles.Num(); i++)
+void ATT_GridManager::UpdateTileInstanceColour(int tileID, const FLinearColor& colour)
+{
+	int instanceIndex;
+	if (UPaperGroupedSpriteComponent* chunkComp = GetTileChunkComponent(tileID, instanceIndex))
+	{
+		chunkComp->UpdateInstanceColor(instanceIndex, colour, false);
+		MarkTileChunkDirty(gridTopology.GetChunkIndex(tileID));
+	}
+}
+
+void ATT_GridManager::MarkTileChunkDirty(int chunkIndex)
+{
+	dirtyTileChunks.AddUnique(chunkIndex);
+}
+
+void ATT_GridManager::QueueTileVisualFlush()
+{
+	// Outside of the game (construction, editor) there is no tick to wait for
+	if (!GetWorld() || !GetWorld()->IsGameWorld())
 	{
-		instanceGroupedSpriteComp->UpdateInstanceColor(viewModeTiles[i], FLinearColor::White, true);
+		FlushTileVisuals();
+		return;
 	}
+	SetActorTickEnabled(true);
+}
+
+void ATT_GridManager::FlushTileVisuals()
+{
+	// Composite the tiles whose overlays changed, then only push the ones that end the frame looking different
+	tileOverlays.Flush(tileVisualBuffer);
+
+	tileVisualBuffer.Flush([this](int32 tileID, const FTT_TileVisual& newVisual, const FTT_TileVisual& previousVisual)
+	{
+		if (newVisual.Colour != previousVisual.Colour)
+		{
+			UpdateTileInstanceColour(tileID, newVisual.Colour);
+		}
+		if (newVisual.Scale != previousVisual.Scale)
+		{
+			UpdateTileInstanceTransform(tileID, GetTileInstanceTransform(tileID, newVisual.Scale), true);
+		}
+	});
+
+	FlushDirtyTileChunks();
+}
+
+void ATT_GridManager::FlushDirtyTileChunks()
+{
+	for (int chunkIndex : dirtyTileChunks)
+	{
+		if (tileChunkComps.IsValidIndex(chunkIndex) && tileChunkComps[chunkIndex])
+		{
+			tileChunkComps[chunkIndex]->MarkRenderStateDirty();
+		}
+	}
+	dirtyTileChunks.Reset();
+
+	SetActorTickEnabled(false);
 }
 
 
 /*---------- TODO: REFACTOR functions ----------*/
 
-void ATT_GridManager::SetPlayerSelection(TArray<int> selectedTileIDs)
+void ATT_GridManager::SetPlayerSelection(const TArray<int>& selectedTileIDs)
+{
+	// The selection layer only remembers the tiles, their colour is set by the previews
+	tileOverlays.SetLayerTiles(ETileOverlay::TO_Selection, selectedTileIDs, FTT_TileOverlayValue());
+}
+
+void ATT_GridManager::SetPlayerSelection(const FTT_TileRect& selectedTiles)
 {
-	playerTileSelection.Empty();
-	playerTileSelection = selectedTileIDs;
+	tileOverlays.SetLayerTiles(ETileOverlay::TO_Selection, selectedTiles, FTT_TileOverlayValue());
 }
 
 void ATT_GridManager::ClearPlayerSelection()
 {
-	for (auto i : playerTileSelection)
+	for (auto i : tileOverlays.GetLayerTiles(ETileOverlay::TO_Selection))
 	{
 		TileReset(i);
 	}
-	playerTileSelection.Empty();
+	tileOverlays.ClearLayer(ETileOverlay::TO_Selection);
 }
 
 
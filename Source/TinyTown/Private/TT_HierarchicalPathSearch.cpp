@@ -0,0 +1,529 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_HierarchicalPathSearch.h"
+
+void FTT_ChunkPathSearch::SetChunk(const FTT_GridTopology& topology, int32 chunkIndex, bool allowDiagonalPaths, const TArray<bool>& walkableTiles)
+{
+	Topology = topology;
+	ChunkIndex = chunkIndex;
+	ChunkOrigin = topology.GetChunkOrigin(chunkIndex);
+	ChunkDimensions = topology.GetChunkDimensions(chunkIndex);
+	AllowDiagonalPaths = allowDiagonalPaths;
+	WalkableTiles = &walkableTiles;
+}
+
+void FTT_ChunkPathSearch::Search(int32 startTile, const int32* targetTiles, int32 numTargets)
+{
+	LocalTargets.Reset();
+	for (int32 targetIndex = 0; targetIndex < numTargets; targetIndex++)
+	{
+		LocalTargets.Add(Topology.GetChunkLocalIndex(targetTiles[targetIndex]));
+	}
+
+	const bool isGuided = numTargets == 1;
+	const FIntPoint goalLocal = isGuided ? Topology.GetTileCoordinate(targetTiles[0]) - ChunkOrigin : FIntPoint(0, 0);
+
+	auto GetEstimate = [&](const FIntPoint& local, int32 cost)
+	{
+		return isGuided ? cost + FTT_AStarSearch::GetHeuristic(goalLocal - local, AllowDiagonalPaths) : cost;
+	};
+
+	// Every chunk fits in the same arrays, they are only allocated once
+	Nodes.BeginSearch(FTT_GridTopology::GetChunkSize() * FTT_GridTopology::GetChunkSize());
+
+	const int32 localStart = Topology.GetChunkLocalIndex(startTile);
+	Nodes.Open(localStart, 0, GetEstimate(Topology.GetTileCoordinate(startTile) - ChunkOrigin, 0), localStart);
+
+	const int32 directionStep = AllowDiagonalPaths ? 1 : 2;
+	int32 numTargetsLeft = numTargets;
+
+	while (Nodes.HasOpenTiles())
+	{
+		const int32 localTile = Nodes.PopBest();
+
+		for (int32 localTarget : LocalTargets)
+		{
+			if (localTarget == localTile)
+			{
+				numTargetsLeft--;
+			}
+		}
+		if (numTargetsLeft <= 0)
+		{
+			return;
+		}
+
+		// Same moves as FTT_AStarSearch, minus the ones leaving the chunk
+		const FIntPoint local(localTile % ChunkDimensions.X, localTile / ChunkDimensions.X);
+		bool isNeighbourWalkable[8];
+		for (int32 direction = 0; direction < 8; direction += directionStep)
+		{
+			const FIntPoint neighbour = local + FIntPoint(FTT_GridTopology::GetDirectionColumn(direction), FTT_GridTopology::GetDirectionRow(direction));
+			isNeighbourWalkable[direction] = neighbour.X >= 0 && neighbour.X < ChunkDimensions.X && neighbour.Y >= 0 && neighbour.Y < ChunkDimensions.Y
+				&& (*WalkableTiles)[neighbour.Y * ChunkDimensions.X + neighbour.X];
+		}
+
+		const int32 currentCost = Nodes.GetCost(localTile);
+		for (int32 direction = 0; direction < 8; direction += directionStep)
+		{
+			if (!isNeighbourWalkable[direction])
+			{
+				continue;
+			}
+
+			const bool isDiagonal = (direction & 1) != 0;
+			if (isDiagonal && (!isNeighbourWalkable[direction - 1] || !isNeighbourWalkable[(direction + 1) & 7]))
+			{
+				continue;
+			}
+
+			const FIntPoint neighbour = local + FIntPoint(FTT_GridTopology::GetDirectionColumn(direction), FTT_GridTopology::GetDirectionRow(direction));
+			const int32 cost = currentCost + (isDiagonal ? FTT_AStarSearch::GetDiagonalCost() : FTT_AStarSearch::GetStraightCost());
+			Nodes.Open(neighbour.Y * ChunkDimensions.X + neighbour.X, cost, GetEstimate(neighbour, cost), localTile);
+		}
+	}
+}
+
+int32 FTT_ChunkPathSearch::GetCost(int32 tileID) const
+{
+	if (!Topology.IsTileValid(tileID) || Topology.GetChunkIndex(tileID) != ChunkIndex)
+	{
+		return MAX_int32;
+	}
+	return Nodes.GetCost(Topology.GetChunkLocalIndex(tileID));
+}
+
+bool FTT_ChunkPathSearch::AppendPath(int32 tileID, TArray<int32>& OutPath) const
+{
+	if (GetCost(tileID) == MAX_int32)
+	{
+		return false;
+	}
+
+	int32 localTile = Topology.GetChunkLocalIndex(tileID);
+	while (Nodes.GetParent(localTile) != localTile)
+	{
+		OutPath.Add(Topology.GetChunkTileID(ChunkIndex, localTile));
+		localTile = Nodes.GetParent(localTile);
+	}
+	return true;
+}
+
+void FTT_HierarchicalPathMap::Init(const FTT_GridTopology& topology, bool allowDiagonalPaths)
+{
+	Topology = topology;
+	AllowDiagonalPaths = allowDiagonalPaths;
+
+	const int32 numChunks = Topology.GetNumChunks();
+	Chunks.Reset();
+	Chunks.SetNum(numChunks);
+	BorderTransitions.Reset();
+	BorderTransitions.SetNum(numChunks * 2);
+
+	DirtyChunks.Init(true, numChunks);
+	NumDirtyChunks = numChunks;
+}
+
+void FTT_HierarchicalPathMap::Invalidate(const FTT_TileRect& changedRect)
+{
+	if (changedRect.IsEmpty() || Topology.GetNumTiles() == 0)
+	{
+		return;
+	}
+
+	const FIntPoint firstTile = changedRect.Min.ComponentMax(FIntPoint(0, 0));
+	const FIntPoint lastTile = changedRect.GetMax().ComponentMin(FIntPoint(Topology.SizeX - 1, Topology.SizeY - 1));
+	if (firstTile.X > lastTile.X || firstTile.Y > lastTile.Y)
+	{
+		return;
+	}
+
+	const int32 numChunksX = Topology.GetNumChunksX();
+	for (int32 chunkY = firstTile.Y >> FTT_GridTopology::GetChunkShift(); chunkY <= lastTile.Y >> FTT_GridTopology::GetChunkShift(); chunkY++)
+	{
+		for (int32 chunkX = firstTile.X >> FTT_GridTopology::GetChunkShift(); chunkX <= lastTile.X >> FTT_GridTopology::GetChunkShift(); chunkX++)
+		{
+			const int32 chunkIndex = chunkY * numChunksX + chunkX;
+			if (!DirtyChunks[chunkIndex])
+			{
+				DirtyChunks[chunkIndex] = true;
+				NumDirtyChunks++;
+			}
+		}
+	}
+}
+
+void FTT_HierarchicalPathMap::Update(TFunctionRef<bool(int32)> isTileWalkable)
+{
+	if (NumDirtyChunks == 0)
+	{
+		return;
+	}
+
+	const int32 numChunks = Topology.GetNumChunks();
+	const int32 numChunksX = Topology.GetNumChunksX();
+	const int32 numChunksY = Topology.GetNumChunksY();
+
+	// The borders of the changed chunks are scanned again, the neighbours on the other side are rebuilt too if their transitions moved
+	TBitArray<> chunksToBuild = DirtyChunks;
+	TBitArray<> scannedBorders(false, numChunks * 2);
+
+	for (int32 chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		if (!DirtyChunks[chunkIndex])
+		{
+			continue;
+		}
+
+		const int32 chunkX = chunkIndex % numChunksX;
+		const int32 chunkY = chunkIndex / numChunksX;
+
+		// A chunk owns its borders with the next chunks on X & Y, its other two borders belong to the previous chunks
+		const FIntPoint borders[4] = {
+			FIntPoint(chunkX + 1 < numChunksX ? chunkIndex : -1, 0),
+			FIntPoint(chunkY + 1 < numChunksY ? chunkIndex : -1, 1),
+			FIntPoint(chunkX > 0 ? chunkIndex - 1 : -1, 0),
+			FIntPoint(chunkY > 0 ? chunkIndex - numChunksX : -1, 1) };
+
+		for (const FIntPoint& border : borders)
+		{
+			const int32 borderIndex = GetBorderIndex(border.X, border.Y);
+			if (border.X == -1 || scannedBorders[borderIndex])
+			{
+				continue;
+			}
+			scannedBorders[borderIndex] = true;
+
+			ScanBorder(border.X, border.Y, isTileWalkable, ScratchTransitions);
+			if (ScratchTransitions != BorderTransitions[borderIndex])
+			{
+				BorderTransitions[borderIndex] = ScratchTransitions;
+				chunksToBuild[border.X] = true;
+				chunksToBuild[border.Y == 0 ? border.X + 1 : border.X + numChunksX] = true;
+			}
+		}
+	}
+
+	for (int32 chunkIndex = 0; chunkIndex < numChunks; chunkIndex++)
+	{
+		if (chunksToBuild[chunkIndex])
+		{
+			BuildChunk(chunkIndex, isTileWalkable);
+		}
+	}
+
+	DirtyChunks.Init(false, numChunks);
+	NumDirtyChunks = 0;
+}
+
+void FTT_HierarchicalPathMap::ScanBorder(int32 chunkIndex, int32 axis, TFunctionRef<bool(int32)> isTileWalkable, TArray<FTransition>& OutTransitions) const
+{
+	OutTransitions.Reset();
+
+	// Tiles of the chunk's last column (X axis) or row (Y axis), each one facing a tile of the next chunk
+	const FIntPoint origin = Topology.GetChunkOrigin(chunkIndex);
+	const FIntPoint dimensions = Topology.GetChunkDimensions(chunkIndex);
+	const FIntPoint along = axis == 0 ? FIntPoint(0, 1) : FIntPoint(1, 0);
+	const FIntPoint across = axis == 0 ? FIntPoint(1, 0) : FIntPoint(0, 1);
+	const FIntPoint firstTile = axis == 0 ? origin + FIntPoint(dimensions.X - 1, 0) : origin + FIntPoint(0, dimensions.Y - 1);
+	const int32 length = axis == 0 ? dimensions.Y : dimensions.X;
+
+	if (!Topology.IsCoordinateValid(firstTile + across))
+	{
+		return;
+	}
+
+	auto AddTransition = [&](int32 position)
+	{
+		const FIntPoint lowTile = firstTile + along * position;
+
+		FTransition transition;
+		transition.LowTileID = Topology.GetTileID(lowTile);
+		transition.HighTileID = Topology.GetTileID(lowTile + across);
+		OutTransitions.Add(transition);
+	};
+
+	// Entrances are the runs of tiles walkable on both sides
+	int32 entranceStart = -1;
+	for (int32 position = 0; position <= length; position++)
+	{
+		const FIntPoint lowTile = firstTile + along * position;
+		const bool isOpen = position < length && isTileWalkable(Topology.GetTileID(lowTile)) && isTileWalkable(Topology.GetTileID(lowTile + across));
+
+		if (isOpen && entranceStart == -1)
+		{
+			entranceStart = position;
+		}
+		else if (!isOpen && entranceStart != -1)
+		{
+			const int32 entranceLength = position - entranceStart;
+			if (entranceLength >= GetWideEntranceLength())
+			{
+				AddTransition(entranceStart);
+				AddTransition(position - 1);
+			}
+			else
+			{
+				AddTransition(entranceStart + entranceLength / 2);
+			}
+			entranceStart = -1;
+		}
+	}
+}
+
+void FTT_HierarchicalPathMap::BuildChunk(int32 chunkIndex, TFunctionRef<bool(int32)> isTileWalkable)
+{
+	FChunk& chunk = Chunks[chunkIndex];
+	chunk.Nodes.Reset();
+
+	chunk.WalkableTiles.SetNumUninitialized(Topology.GetChunkNumTiles(chunkIndex));
+	for (int32 localTile = 0; localTile < chunk.WalkableTiles.Num(); localTile++)
+	{
+		chunk.WalkableTiles[localTile] = isTileWalkable(Topology.GetChunkTileID(chunkIndex, localTile));
+	}
+
+	auto AddLink = [&](int32 tileID, int32 linkedTileID)
+	{
+		int32 nodeIndex = chunk.FindNode(tileID);
+		if (nodeIndex == INDEX_NONE)
+		{
+			nodeIndex = chunk.Nodes.AddDefaulted();
+			chunk.Nodes[nodeIndex].TileID = tileID;
+		}
+		chunk.Nodes[nodeIndex].LinkedTileIDs.Add(linkedTileID);
+	};
+
+	const int32 numChunksX = Topology.GetNumChunksX();
+	const int32 chunkX = chunkIndex % numChunksX;
+	const int32 chunkY = chunkIndex / numChunksX;
+
+	// Corner tiles can be on two borders, they make a single node
+	if (chunkX + 1 < numChunksX)
+	{
+		for (const FTransition& transition : BorderTransitions[GetBorderIndex(chunkIndex, 0)])
+		{
+			AddLink(transition.LowTileID, transition.HighTileID);
+		}
+	}
+	if (chunkY + 1 < Topology.GetNumChunksY())
+	{
+		for (const FTransition& transition : BorderTransitions[GetBorderIndex(chunkIndex, 1)])
+		{
+			AddLink(transition.LowTileID, transition.HighTileID);
+		}
+	}
+	if (chunkX > 0)
+	{
+		for (const FTransition& transition : BorderTransitions[GetBorderIndex(chunkIndex - 1, 0)])
+		{
+			AddLink(transition.HighTileID, transition.LowTileID);
+		}
+	}
+	if (chunkY > 0)
+	{
+		for (const FTransition& transition : BorderTransitions[GetBorderIndex(chunkIndex - numChunksX, 1)])
+		{
+			AddLink(transition.HighTileID, transition.LowTileID);
+		}
+	}
+
+	const int32 numNodes = chunk.Nodes.Num();
+	chunk.Costs.SetNumUninitialized(numNodes * numNodes);
+
+	ScratchTileIDs.Reset();
+	for (const FNode& node : chunk.Nodes)
+	{
+		ScratchTileIDs.Add(node.TileID);
+	}
+
+	// Nodes are walkable, costs are the same both ways: each node only searches for the nodes after it
+	ChunkSearch.SetChunk(Topology, chunkIndex, AllowDiagonalPaths, chunk.WalkableTiles);
+	for (int32 fromNode = 0; fromNode < numNodes; fromNode++)
+	{
+		chunk.Costs[fromNode * numNodes + fromNode] = 0;
+
+		const int32 numTargets = numNodes - fromNode - 1;
+		if (numTargets == 0)
+		{
+			continue;
+		}
+
+		ChunkSearch.Search(ScratchTileIDs[fromNode], ScratchTileIDs.GetData() + fromNode + 1, numTargets);
+		for (int32 toNode = fromNode + 1; toNode < numNodes; toNode++)
+		{
+			const int32 cost = ChunkSearch.GetCost(ScratchTileIDs[toNode]);
+			chunk.Costs[fromNode * numNodes + toNode] = cost;
+			chunk.Costs[toNode * numNodes + fromNode] = cost;
+		}
+	}
+}
+
+bool FTT_HierarchicalPathSearch::FindPath(const FTT_HierarchicalPathMap& hierarchicalMap, int32 startTile, int32 goalTile, TArray<int32>& OutPath)
+{
+	OutPath.Reset();
+	NumExpandedNodes = 0;
+
+	const FTT_GridTopology& topology = hierarchicalMap.GetTopology();
+	if (!hierarchicalMap.IsUpToDate() || !topology.IsTileValid(startTile) || !topology.IsTileValid(goalTile) || !hierarchicalMap.IsTileWalkable(goalTile))
+	{
+		return false;
+	}
+
+	if (startTile == goalTile)
+	{
+		OutPath.Add(goalTile);
+		return true;
+	}
+
+	const bool allowDiagonalPaths = hierarchicalMap.IsDiagonal();
+	const int32 maxNodesPerChunk = FTT_HierarchicalPathMap::GetMaxNodesPerChunk();
+	const int32 startNode = topology.GetNumChunks() * maxNodesPerChunk;
+	const int32 goalNode = startNode + 1;
+	const int32 startChunkIndex = topology.GetChunkIndex(startTile);
+	const int32 goalChunkIndex = topology.GetChunkIndex(goalTile);
+	const FIntPoint goalCoordinate = topology.GetTileCoordinate(goalTile);
+
+	// When both tiles share a chunk, the path inside the chunk is kept unless the abstract graph finds a shorter one around
+	int32 bestCost = MAX_int32;
+	if (startChunkIndex == goalChunkIndex)
+	{
+		ChunkSearch.SetChunk(topology, startChunkIndex, allowDiagonalPaths, hierarchicalMap.GetChunk(startChunkIndex).WalkableTiles);
+		ChunkSearch.Search(startTile, &goalTile, 1);
+		bestCost = ChunkSearch.GetCost(goalTile);
+		if (bestCost != MAX_int32)
+		{
+			ChunkSearch.AppendPath(goalTile, OutPath);
+			OutPath.Add(startTile);
+		}
+	}
+
+	// Connect the start & goal to the nodes of their chunks
+	auto GetChunkCosts = [&](int32 chunkIndex, int32 tileID, TArray<int32>& OutCosts)
+	{
+		const FTT_HierarchicalPathMap::FChunk& chunk = hierarchicalMap.GetChunk(chunkIndex);
+
+		ScratchTileIDs.Reset();
+		for (const FTT_HierarchicalPathMap::FNode& node : chunk.Nodes)
+		{
+			ScratchTileIDs.Add(node.TileID);
+		}
+
+		ChunkSearch.SetChunk(topology, chunkIndex, allowDiagonalPaths, chunk.WalkableTiles);
+		ChunkSearch.Search(tileID, ScratchTileIDs.GetData(), ScratchTileIDs.Num());
+
+		OutCosts.Reset();
+		for (int32 nodeTile : ScratchTileIDs)
+		{
+			OutCosts.Add(ChunkSearch.GetCost(nodeTile));
+		}
+	};
+
+	GetChunkCosts(startChunkIndex, startTile, StartCosts);
+	GetChunkCosts(goalChunkIndex, goalTile, GoalCosts);
+
+	// A* over the abstract graph, nodes that can't beat the path inside the chunk are dropped
+	AbstractNodes.BeginSearch(goalNode + 1);
+	if (AbstractTileIDs.Num() != goalNode + 1)
+	{
+		AbstractTileIDs.SetNumUninitialized(goalNode + 1);
+	}
+
+	auto OpenNode = [&](int32 node, int32 tileID, int32 cost, int32 parentNode)
+	{
+		if (cost < bestCost && AbstractNodes.Open(node, cost, cost + FTT_AStarSearch::GetHeuristic(goalCoordinate - topology.GetTileCoordinate(tileID), allowDiagonalPaths), parentNode))
+		{
+			AbstractTileIDs[node] = tileID;
+		}
+	};
+
+	OpenNode(startNode, startTile, 0, startNode);
+
+	while (AbstractNodes.HasOpenTiles())
+	{
+		const int32 currentNode = AbstractNodes.PopBest();
+		NumExpandedNodes++;
+
+		if (currentNode == goalNode)
+		{
+			break;
+		}
+
+		const int32 currentCost = AbstractNodes.GetCost(currentNode);
+		if (currentNode == startNode)
+		{
+			const FTT_HierarchicalPathMap::FChunk& startChunk = hierarchicalMap.GetChunk(startChunkIndex);
+			for (int32 nodeIndex = 0; nodeIndex < startChunk.Nodes.Num(); nodeIndex++)
+			{
+				if (StartCosts[nodeIndex] != MAX_int32)
+				{
+					OpenNode(startChunkIndex * maxNodesPerChunk + nodeIndex, startChunk.Nodes[nodeIndex].TileID, StartCosts[nodeIndex], currentNode);
+				}
+			}
+			continue;
+		}
+
+		const int32 chunkIndex = currentNode / maxNodesPerChunk;
+		const int32 nodeIndex = currentNode - chunkIndex * maxNodesPerChunk;
+		const FTT_HierarchicalPathMap::FChunk& chunk = hierarchicalMap.GetChunk(chunkIndex);
+
+		// Across the chunk
+		for (int32 otherNodeIndex = 0; otherNodeIndex < chunk.Nodes.Num(); otherNodeIndex++)
+		{
+			const int32 cost = chunk.GetCost(nodeIndex, otherNodeIndex);
+			if (otherNodeIndex != nodeIndex && cost != MAX_int32)
+			{
+				OpenNode(chunkIndex * maxNodesPerChunk + otherNodeIndex, chunk.Nodes[otherNodeIndex].TileID, currentCost + cost, currentNode);
+			}
+		}
+
+		// Into the neighbouring chunks, one straight move away
+		for (int32 linkedTile : chunk.Nodes[nodeIndex].LinkedTileIDs)
+		{
+			const int32 linkedChunkIndex = topology.GetChunkIndex(linkedTile);
+			const int32 linkedNodeIndex = hierarchicalMap.GetChunk(linkedChunkIndex).FindNode(linkedTile);
+			if (linkedNodeIndex != INDEX_NONE)
+			{
+				OpenNode(linkedChunkIndex * maxNodesPerChunk + linkedNodeIndex, linkedTile, currentCost + FTT_AStarSearch::GetStraightCost(), currentNode);
+			}
+		}
+
+		// Out to the goal
+		if (chunkIndex == goalChunkIndex && GoalCosts[nodeIndex] != MAX_int32)
+		{
+			OpenNode(goalNode, goalTile, currentCost + GoalCosts[nodeIndex], currentNode);
+		}
+	}
+
+	if (!AbstractNodes.IsClosed(goalNode))
+	{
+		return OutPath.Num() > 0;
+	}
+
+	// Each step of the abstract path either crosses a border or stays in a chunk, where it is refined
+	AbstractNodes.BuildPath(goalNode, AbstractPath);
+	OutPath.Reset();
+
+	for (int32 pathIndex = 0; pathIndex + 1 < AbstractPath.Num(); pathIndex++)
+	{
+		const int32 toTile = AbstractTileIDs[AbstractPath[pathIndex]];
+		const int32 fromTile = AbstractTileIDs[AbstractPath[pathIndex + 1]];
+		const int32 fromChunkIndex = topology.GetChunkIndex(fromTile);
+
+		if (fromChunkIndex != topology.GetChunkIndex(toTile))
+		{
+			OutPath.Add(toTile);
+			continue;
+		}
+
+		ChunkSearch.SetChunk(topology, fromChunkIndex, allowDiagonalPaths, hierarchicalMap.GetChunk(fromChunkIndex).WalkableTiles);
+		ChunkSearch.Search(fromTile, &toTile, 1);
+		if (!ChunkSearch.AppendPath(toTile, OutPath))
+		{
+			OutPath.Reset();
+			return false;
+		}
+	}
+	OutPath.Add(startTile);
+
+	return true;
+}
@@ -0,0 +1,363 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_JumpPointSearch.h"
+
+void FTT_JumpPointMap::Init(const FTT_GridTopology& topology, bool allowDiagonalPaths)
+{
+	Topology = topology;
+	AllowDiagonalPaths = allowDiagonalPaths;
+	NumDirections = allowDiagonalPaths ? 8 : 4;
+
+	WalkableTiles.Init(false, (Topology.SizeX + 2) * (Topology.SizeY + 2));
+	ChangedRects.Reset();
+	JumpDistances.SetNumUninitialized(Topology.GetNumTiles() * NumDirections);
+	JumpPointAheadMasks.Init(0, Topology.GetNumTiles());
+
+	DirtyRows.Init(false, Topology.SizeY);
+	DirtyColumns.Init(false, Topology.SizeX);
+	DirtyChunks.Init(false, Topology.GetNumChunks());
+	NumDirtyChunks = 0;
+
+	Invalidate(FTT_TileRect(FIntPoint(0, 0), FIntPoint(Topology.SizeX, Topology.SizeY)));
+}
+
+void FTT_JumpPointMap::Invalidate(const FTT_TileRect& changedRect)
+{
+	const FTT_TileRect rect = changedRect.GetIntersection(FTT_TileRect(FIntPoint(0, 0), FIntPoint(Topology.SizeX, Topology.SizeY)));
+	if (rect.IsEmpty())
+	{
+		return;
+	}
+	ChangedRects.Add(rect);
+
+	// Forced neighbours are found from the tiles on each side of a move, the lines & chunks right around the rectangle depend on it too
+	const FIntPoint firstTile = (rect.Min - FIntPoint(1, 1)).ComponentMax(FIntPoint(0, 0));
+	const FIntPoint lastTile = (rect.GetMax() + FIntPoint(1, 1)).ComponentMin(FIntPoint(Topology.SizeX - 1, Topology.SizeY - 1));
+
+	for (int32 row = firstTile.Y; row <= lastTile.Y; row++)
+	{
+		DirtyRows[row] = true;
+	}
+
+	if (AllowDiagonalPaths)
+	{
+		for (int32 column = firstTile.X; column <= lastTile.X; column++)
+		{
+			DirtyColumns[column] = true;
+		}
+	}
+
+	const int32 numChunksX = Topology.GetNumChunksX();
+	for (int32 chunkY = firstTile.Y >> FTT_GridTopology::GetChunkShift(); chunkY <= lastTile.Y >> FTT_GridTopology::GetChunkShift(); chunkY++)
+	{
+		for (int32 chunkX = firstTile.X >> FTT_GridTopology::GetChunkShift(); chunkX <= lastTile.X >> FTT_GridTopology::GetChunkShift(); chunkX++)
+		{
+			FlagChunk(chunkY * numChunksX + chunkX);
+		}
+	}
+}
+
+void FTT_JumpPointMap::FlagChunk(int32 chunkIndex)
+{
+	if (!DirtyChunks[chunkIndex])
+	{
+		DirtyChunks[chunkIndex] = true;
+		NumDirtyChunks++;
+	}
+}
+
+void FTT_JumpPointMap::Update(TFunctionRef<bool(int32)> isTileWalkable)
+{
+	if (NumDirtyChunks == 0)
+	{
+		return;
+	}
+
+	for (const FTT_TileRect& rect : ChangedRects)
+	{
+		const FIntPoint max = rect.GetMax();
+		for (int32 row = rect.Min.Y; row <= max.Y; row++)
+		{
+			for (int32 column = rect.Min.X; column <= max.X; column++)
+			{
+				WalkableTiles[(row + 1) * (Topology.SizeX + 2) + column + 1] = isTileWalkable(Topology.GetTileID(FIntPoint(column, row)));
+			}
+		}
+	}
+	ChangedRects.Reset();
+
+	// Moves along rows are Bottom & Top, moves along columns Right & Left (only jumped straight with diagonals)
+	for (int32 row = 0; row < DirtyRows.Num(); row++)
+	{
+		if (DirtyRows[row])
+		{
+			UpdateJumpPointsAhead(row, int32(ETT_TileDirection::Bottom));
+			UpdateJumpPointsAhead(row, int32(ETT_TileDirection::Top));
+			DirtyRows[row] = false;
+		}
+	}
+
+	for (int32 column = 0; column < DirtyColumns.Num(); column++)
+	{
+		if (DirtyColumns[column])
+		{
+			UpdateJumpPointsAhead(column, int32(ETT_TileDirection::Right));
+			UpdateJumpPointsAhead(column, int32(ETT_TileDirection::Left));
+			DirtyColumns[column] = false;
+		}
+	}
+
+	const int32 directionStep = AllowDiagonalPaths ? 1 : 2;
+	for (int32 chunkIndex = 0; chunkIndex < DirtyChunks.Num(); chunkIndex++)
+	{
+		if (DirtyChunks[chunkIndex])
+		{
+			for (int32 direction = 0; direction < 8; direction += directionStep)
+			{
+				BuildChunkJumps(chunkIndex, direction);
+			}
+			DirtyChunks[chunkIndex] = false;
+		}
+	}
+	NumDirtyChunks = 0;
+}
+
+void FTT_JumpPointMap::UpdateJumpPointsAhead(int32 lineIndex, int32 direction)
+{
+	const FIntPoint step(FTT_GridTopology::GetDirectionColumn(direction), FTT_GridTopology::GetDirectionRow(direction));
+	const bool isAlongRow = step.Y == 0;
+	const int32 length = isAlongRow ? Topology.SizeX : Topology.SizeY;
+	const uint8 bit = GetJumpPointAheadBit(direction);
+
+	// Walked from the end of the line the move goes toward, each tile's bit comes from the tile after it
+	bool isNextJumpPointAhead = false;
+	for (int32 i = 0; i < length; i++)
+	{
+		const int32 position = (step.X + step.Y > 0) ? length - 1 - i : i;
+		const FIntPoint coordinate = isAlongRow ? FIntPoint(position, lineIndex) : FIntPoint(lineIndex, position);
+		const FIntPoint next = coordinate + step;
+
+		const bool isJumpPointAhead = IsWalkable(next) && (isNextJumpPointAhead || HasForcedNeighbour(next, direction));
+		isNextJumpPointAhead = isJumpPointAhead;
+
+		const int32 tileID = Topology.GetTileID(coordinate);
+		if (((JumpPointAheadMasks[tileID] & bit) != 0) != isJumpPointAhead)
+		{
+			JumpPointAheadMasks[tileID] ^= bit;
+			FlagChunk(Topology.GetChunkIndex(tileID));
+		}
+	}
+}
+
+void FTT_JumpPointMap::BuildChunkJumps(int32 chunkIndex, int32 direction)
+{
+	const FIntPoint origin = Topology.GetChunkOrigin(chunkIndex);
+	const FIntPoint dimensions = Topology.GetChunkDimensions(chunkIndex);
+	const FTT_TileRect chunkRect(origin, dimensions);
+
+	const FIntPoint step(FTT_GridTopology::GetDirectionColumn(direction), FTT_GridTopology::GetDirectionRow(direction));
+	const bool isDiagonal = step.X != 0 && step.Y != 0;
+
+	// Tiles are walked from the side of the chunk the move goes toward, the tile after each tile is always done first
+	for (int32 y = 0; y < dimensions.Y; y++)
+	{
+		const int32 localY = step.Y > 0 ? dimensions.Y - 1 - y : y;
+		for (int32 x = 0; x < dimensions.X; x++)
+		{
+			const int32 localX = step.X > 0 ? dimensions.X - 1 - x : x;
+			const FIntPoint coordinate = origin + FIntPoint(localX, localY);
+			const FIntPoint next = coordinate + step;
+
+			// Diagonal moves can't cut corners. Jumps stop on the first tile of the next chunk, that chunk's jumps take over from there.
+			int32 distance;
+			if (!IsWalkable(next) || (isDiagonal && (!IsWalkable(coordinate + FIntPoint(step.X, 0)) || !IsWalkable(coordinate + FIntPoint(0, step.Y)))))
+			{
+				distance = 0;
+			}
+			else if (!chunkRect.Contains(next) || IsJumpPoint(next, direction))
+			{
+				distance = 1;
+			}
+			else
+			{
+				const int32 nextDistance = GetJumpDistance(Topology.GetTileID(next), direction);
+				distance = nextDistance > 0 ? nextDistance + 1 : nextDistance - 1;
+			}
+
+			SetJumpDistance(Topology.GetTileID(coordinate), direction, distance);
+		}
+	}
+}
+
+bool FTT_JumpPointMap::HasForcedNeighbour(const FIntPoint& coordinate, int32 direction) const
+{
+	const FIntPoint parent = coordinate - FIntPoint(FTT_GridTopology::GetDirectionColumn(direction), FTT_GridTopology::GetDirectionRow(direction));
+
+	// A side tile blocked next to the parent but free next to this tile can't be reached any quicker than through this tile
+	const int32 sideDirections[2] = { (direction + 2) & 7, (direction + 6) & 7 };
+	for (int32 sideDirection : sideDirections)
+	{
+		const FIntPoint side(FTT_GridTopology::GetDirectionColumn(sideDirection), FTT_GridTopology::GetDirectionRow(sideDirection));
+		if (!IsWalkable(parent + side) && IsWalkable(coordinate + side))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+bool FTT_JumpPointMap::IsJumpPoint(const FIntPoint& coordinate, int32 direction) const
+{
+	const int32 tileID = Topology.GetTileID(coordinate);
+
+	// Diagonal moves have no forced neighbours, they stop where one of their straight moves finds a jump point
+	if (AllowDiagonalPaths && (direction & 1))
+	{
+		return IsJumpPointAhead(tileID, (direction + 7) & 7) || IsJumpPointAhead(tileID, (direction + 1) & 7);
+	}
+
+	if (HasForcedNeighbour(coordinate, direction))
+	{
+		return true;
+	}
+
+	// Without diagonals, moves across rows also stop where a move along the row finds a jump point
+	return !AllowDiagonalPaths && FTT_GridTopology::GetDirectionColumn(direction) == 0
+		&& (IsJumpPointAhead(tileID, int32(ETT_TileDirection::Bottom)) || IsJumpPointAhead(tileID, int32(ETT_TileDirection::Top)));
+}
+
+bool FTT_JumpPointSearch::FindPath(const FTT_JumpPointMap& jumpPointMap, int32 startTile, int32 goalTile, TFunctionRef<bool(int32)> isTileWalkable, TArray<int32>& OutPath)
+{
+	OutPath.Reset();
+	NumExpandedTiles = 0;
+
+	const FTT_GridTopology& topology = jumpPointMap.GetTopology();
+	if (!jumpPointMap.IsUpToDate() || !topology.IsTileValid(startTile) || !topology.IsTileValid(goalTile) || !isTileWalkable(goalTile))
+	{
+		return false;
+	}
+
+	const bool allowDiagonalPaths = jumpPointMap.IsDiagonal();
+	const FIntPoint goalCoordinate = topology.GetTileCoordinate(goalTile);
+
+	Nodes.BeginSearch(topology.GetNumTiles());
+	if (Directions.Num() != topology.GetNumTiles())
+	{
+		Directions.SetNumUninitialized(topology.GetNumTiles());
+	}
+
+	Nodes.Open(startTile, 0, FTT_AStarSearch::GetHeuristic(goalCoordinate - topology.GetTileCoordinate(startTile), allowDiagonalPaths), startTile);
+	Directions[startTile] = GetNoDirection();
+
+	while (Nodes.HasOpenTiles())
+	{
+		const int32 currentTile = Nodes.PopBest();
+		NumExpandedTiles++;
+
+		if (currentTile == goalTile)
+		{
+			break;
+		}
+
+		// Past the start, only the directions of the jump and the ones it turns into (forced neighbours & diagonals) are searched
+		int32 successorDirections[8];
+		int32 numSuccessorDirections = 0;
+		const int32 directionStep = allowDiagonalPaths ? 1 : 2;
+		const uint8 arrivalDirection = Directions[currentTile];
+
+		if (arrivalDirection == GetNoDirection())
+		{
+			for (int32 direction = 0; direction < 8; direction += directionStep)
+			{
+				successorDirections[numSuccessorDirections++] = direction;
+			}
+		}
+		else
+		{
+			const int32 spread = (arrivalDirection & 1) ? 1 : 2;
+			for (int32 offset = -spread; offset <= spread; offset += directionStep)
+			{
+				successorDirections[numSuccessorDirections++] = (arrivalDirection + offset) & 7;
+			}
+		}
+
+		const FIntPoint coordinate = topology.GetTileCoordinate(currentTile);
+		const FIntPoint toGoal = goalCoordinate - coordinate;
+		const FIntPoint goalDistance(FMath::Abs(toGoal.X), FMath::Abs(toGoal.Y));
+		const FIntPoint goalSign(FMath::Sign(toGoal.X), FMath::Sign(toGoal.Y));
+		const int32 currentCost = Nodes.GetCost(currentTile);
+
+		for (int32 directionIndex = 0; directionIndex < numSuccessorDirections; directionIndex++)
+		{
+			const int32 direction = successorDirections[directionIndex];
+			const FIntPoint step(FTT_GridTopology::GetDirectionColumn(direction), FTT_GridTopology::GetDirectionRow(direction));
+			const int32 jumpDistance = jumpPointMap.GetJumpDistance(currentTile, direction);
+			const int32 reach = FMath::Abs(jumpDistance);
+			const bool isDiagonal = (direction & 1) != 0;
+
+			// Stop short of the jump point when the goal (or the row or column it can be reached from) comes first
+			int32 moves = 0;
+			if (isDiagonal)
+			{
+				if (goalSign == step && (goalDistance.X <= reach || goalDistance.Y <= reach))
+				{
+					moves = FMath::Min(goalDistance.X, goalDistance.Y);
+				}
+			}
+			else if (step.Y == 0)
+			{
+				if (toGoal.Y == 0 && goalSign.X == step.X && goalDistance.X <= reach)
+				{
+					moves = goalDistance.X;
+				}
+			}
+			else if ((toGoal.X == 0 || !allowDiagonalPaths) && goalSign.Y == step.Y && goalDistance.Y <= reach)
+			{
+				moves = goalDistance.Y;
+			}
+
+			if (moves == 0)
+			{
+				moves = FMath::Max(jumpDistance, 0);
+				if (moves == 0)
+				{
+					continue;
+				}
+			}
+
+			const FIntPoint successorCoordinate = coordinate + step * moves;
+			const int32 successorTile = topology.GetTileID(successorCoordinate);
+			const int32 cost = currentCost + moves * (isDiagonal ? FTT_AStarSearch::GetDiagonalCost() : FTT_AStarSearch::GetStraightCost());
+			const int32 heuristic = FTT_AStarSearch::GetHeuristic(goalCoordinate - successorCoordinate, allowDiagonalPaths);
+
+			if (Nodes.Open(successorTile, cost, cost + heuristic, currentTile))
+			{
+				Directions[successorTile] = uint8(direction);
+			}
+		}
+	}
+
+	if (!Nodes.IsClosed(goalTile))
+	{
+		return false;
+	}
+
+	// Jump points are in a straight line (or diagonal) from one another, the tiles in between are added back
+	Nodes.BuildPath(goalTile, JumpPoints);
+	OutPath.Add(JumpPoints[0]);
+
+	for (int32 jumpIndex = 1; jumpIndex < JumpPoints.Num(); jumpIndex++)
+	{
+		const FIntPoint from = topology.GetTileCoordinate(JumpPoints[jumpIndex - 1]);
+		const FIntPoint to = topology.GetTileCoordinate(JumpPoints[jumpIndex]);
+		const FIntPoint step(FMath::Sign(to.X - from.X), FMath::Sign(to.Y - from.Y));
+
+		for (FIntPoint between = from + step; between != to; between += step)
+		{
+			OutPath.Add(topology.GetTileID(between));
+		}
+		OutPath.Add(JumpPoints[jumpIndex]);
+	}
+
+	return true;
+}
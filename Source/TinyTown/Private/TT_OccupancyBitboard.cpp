@@ -0,0 +1,102 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_OccupancyBitboard.h"
+
+void FTT_OccupancyBitboard::Init(const FTT_GridTopology& topology)
+{
+	Topology = topology;
+	WordsPerRow = (topology.SizeX + 63) >> 6;
+	Words.Reset();
+	Words.SetNumZeroed(WordsPerRow * topology.SizeY);
+}
+
+void FTT_OccupancyBitboard::SetTile(int32 tileID, bool isOccupied)
+{
+	if (!Topology.IsTileValid(tileID))
+	{
+		return;
+	}
+
+	const FIntPoint coordinate = Topology.GetTileCoordinate(tileID);
+	uint64& word = GetMutableRow(coordinate.Y)[coordinate.X >> 6];
+	const uint64 bit = uint64(1) << (coordinate.X & 63);
+	word = isOccupied ? (word | bit) : (word & ~bit);
+}
+
+void FTT_OccupancyBitboard::SetRect(const FTT_TileRect& rect, bool isOccupied)
+{
+	if (rect.IsEmpty())
+	{
+		return;
+	}
+
+	const int32 firstColumn = FMath::Max(rect.Min.X, 0);
+	const int32 lastColumn = FMath::Min(rect.GetMax().X, Topology.SizeX - 1);
+	const int32 firstRow = FMath::Max(rect.Min.Y, 0);
+	const int32 lastRow = FMath::Min(rect.GetMax().Y, Topology.SizeY - 1);
+
+	for (int32 row = firstRow; row <= lastRow; row++)
+	{
+		uint64* rowWords = GetMutableRow(row);
+		for (int32 wordIndex = firstColumn >> 6; wordIndex <= lastColumn >> 6; wordIndex++)
+		{
+			const int32 firstBit = wordIndex == (firstColumn >> 6) ? (firstColumn & 63) : 0;
+			const int32 lastBit = wordIndex == (lastColumn >> 6) ? (lastColumn & 63) : 63;
+			const uint64 mask = GetBitMask(firstBit, lastBit);
+
+			rowWords[wordIndex] = isOccupied ? (rowWords[wordIndex] | mask) : (rowWords[wordIndex] & ~mask);
+		}
+	}
+}
+
+bool FTT_OccupancyBitboard::IsRectFree(const FTT_TileRect& rect) const
+{
+	if (rect.IsEmpty())
+	{
+		return true;
+	}
+
+	const FIntPoint rectMax = rect.GetMax();
+	if (rect.Min.X < 0 || rect.Min.Y < 0 || rectMax.X >= Topology.SizeX || rectMax.Y >= Topology.SizeY)
+	{
+		return false;
+	}
+
+	for (int32 row = rect.Min.Y; row <= rectMax.Y; row++)
+	{
+		if (!IsRowSpanFree(row, rect.Min.X, rectMax.X))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+bool FTT_OccupancyBitboard::IsRowSpanFree(int32 row, int32 firstColumn, int32 lastColumn) const
+{
+	const uint64* rowWords = GetRow(row);
+	const int32 firstWord = firstColumn >> 6;
+	const int32 lastWord = lastColumn >> 6;
+
+	// Most footprints fit in a single word
+	if (firstWord == lastWord)
+	{
+		return (rowWords[firstWord] & GetBitMask(firstColumn & 63, lastColumn & 63)) == 0;
+	}
+
+	if (rowWords[firstWord] & GetBitMask(firstColumn & 63, 63))
+	{
+		return false;
+	}
+
+	// Words fully covered by the span only need to be 0
+	for (int32 wordIndex = firstWord + 1; wordIndex < lastWord; wordIndex++)
+	{
+		if (rowWords[wordIndex])
+		{
+			return false;
+		}
+	}
+
+	return (rowWords[lastWord] & GetBitMask(0, lastColumn & 63)) == 0;
+}
@@ -0,0 +1,131 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_PathRequest.h"
+
+void FTT_WalkabilitySnapshot::Init(const FTT_GridTopology& topology)
+{
+	Topology = topology;
+
+	Chunks.Empty(Topology.GetNumChunks());
+	Chunks.SetNum(Topology.GetNumChunks());
+	DirtyChunks.Init(true, Topology.GetNumChunks());
+	NumDirtyChunks = Topology.GetNumChunks();
+}
+
+void FTT_WalkabilitySnapshot::Invalidate(const FTT_TileRect& changedRect)
+{
+	const FTT_TileRect rect = changedRect.GetIntersection(FTT_TileRect(FIntPoint(0, 0), FIntPoint(Topology.SizeX, Topology.SizeY)));
+	if (rect.IsEmpty())
+	{
+		return;
+	}
+
+	const FIntPoint max = rect.GetMax();
+	const int32 numChunksX = Topology.GetNumChunksX();
+	for (int32 chunkY = rect.Min.Y >> FTT_GridTopology::GetChunkShift(); chunkY <= max.Y >> FTT_GridTopology::GetChunkShift(); chunkY++)
+	{
+		for (int32 chunkX = rect.Min.X >> FTT_GridTopology::GetChunkShift(); chunkX <= max.X >> FTT_GridTopology::GetChunkShift(); chunkX++)
+		{
+			const int32 chunkIndex = chunkY * numChunksX + chunkX;
+			if (!DirtyChunks[chunkIndex])
+			{
+				DirtyChunks[chunkIndex] = true;
+				NumDirtyChunks++;
+			}
+		}
+	}
+}
+
+bool FTT_WalkabilitySnapshot::Update(TFunctionRef<bool(int32)> isTileWalkable, float budgetMs)
+{
+	const double endTime = FPlatformTime::Seconds() + budgetMs / 1000.0;
+
+	for (int32 chunkIndex = 0; chunkIndex < DirtyChunks.Num() && NumDirtyChunks > 0; chunkIndex++)
+	{
+		if (!DirtyChunks[chunkIndex])
+		{
+			continue;
+		}
+
+		const int32 numChunkTiles = Topology.GetChunkNumTiles(chunkIndex);
+		TSharedRef<TBitArray<>, ESPMode::ThreadSafe> chunkTiles = MakeShared<TBitArray<>, ESPMode::ThreadSafe>(false, numChunkTiles);
+		for (int32 localIndex = 0; localIndex < numChunkTiles; localIndex++)
+		{
+			(*chunkTiles)[localIndex] = isTileWalkable(Topology.GetChunkTileID(chunkIndex, localIndex));
+		}
+
+		Chunks[chunkIndex] = chunkTiles;
+		DirtyChunks[chunkIndex] = false;
+		NumDirtyChunks--;
+
+		if (FPlatformTime::Seconds() >= endTime)
+		{
+			break;
+		}
+	}
+
+	return NumDirtyChunks == 0;
+}
+
+TUniquePtr<FTT_PathWorkerSearches> FTT_PathWorkerSearchPool::Acquire()
+{
+	{
+		FScopeLock scopeLock(&Lock);
+		if (FreeSearches.Num() > 0)
+		{
+			return FreeSearches.Pop(false);
+		}
+	}
+
+	return MakeUnique<FTT_PathWorkerSearches>();
+}
+
+void FTT_PathWorkerSearchPool::Release(TUniquePtr<FTT_PathWorkerSearches> searches)
+{
+	FScopeLock scopeLock(&Lock);
+	FreeSearches.Add(MoveTemp(searches));
+}
+
+void FTT_PathRequest::Execute(FTT_PathWorkerSearchPool& searchPool)
+{
+	if (IsCancelled)
+	{
+		return;
+	}
+
+	const FTT_WalkabilitySnapshot& snapshot = *Snapshot;
+	const FTT_GridTopology& topology = snapshot.GetTopology();
+	if (!topology.IsTileValid(Query.StartTile) || !topology.IsTileValid(Query.GoalTile))
+	{
+		return;
+	}
+
+	// Once cancelled no tile can be walked on, the search empties its open list and returns
+	auto isTileWalkable = [&](int32 tileID)
+	{
+		return !IsCancelled && snapshot.IsTileWalkable(tileID);
+	};
+
+	TUniquePtr<FTT_PathWorkerSearches> searches = searchPool.Acquire();
+
+	const FTT_TileRect& zone = Query.Zone;
+	bool isPathFound = false;
+	if (zone.GetArea() > 1 && zone.Contains(topology.GetTileCoordinate(Query.StartTile)))
+	{
+		const FIntPoint zoneOrigin = FTT_ZoneDijkstraSearch::GetZoneOrigin(zone, topology.GetTileCoordinate(Query.StartTile));
+		isPathFound = searches->ZoneDijkstraSearch.FindPath(topology, zone, zoneOrigin, nullptr, Query.StartTile, Query.GoalTile,
+			Query.AllowDiagonalPaths, MaxZoneDistance, isTileWalkable, Path) && Path.Num() >= Query.MinZonePathLength;
+	}
+
+	if (!isPathFound && Query.StartTile != Query.GoalTile)
+	{
+		searches->AStarSearch.FindPath(topology, Query.StartTile, Query.GoalTile, Query.AllowDiagonalPaths, isTileWalkable, Path);
+	}
+
+	else if (!isPathFound)
+	{
+		Path.Reset();
+	}
+
+	searchPool.Release(MoveTemp(searches));
+}
@@ -0,0 +1,311 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_PathSearch.h"
+
+void FTT_PathSearchNodes::BeginSearch(int32 numTiles)
+{
+	if (Stamps.Num() != numTiles)
+	{
+		Stamps.Reset();
+		Stamps.SetNumZeroed(numTiles);
+		Costs.SetNumUninitialized(numTiles);
+		Estimates.SetNumUninitialized(numTiles);
+		Parents.SetNumUninitialized(numTiles);
+		HeapIndices.SetNumUninitialized(numTiles);
+		CurrentStamp = 0;
+	}
+
+	Heap.Reset();
+
+	// Once every 4 billion searches the stamps wrap around, they are cleared so that no tile looks reached
+	CurrentStamp++;
+	if (CurrentStamp == 0)
+	{
+		FMemory::Memzero(Stamps.GetData(), Stamps.Num() * sizeof(uint32));
+		CurrentStamp = 1;
+	}
+}
+
+bool FTT_PathSearchNodes::Open(int32 tileID, int32 cost, int32 estimate, int32 parentTileID)
+{
+	if (!IsReached(tileID))
+	{
+		Stamps[tileID] = CurrentStamp;
+		Costs[tileID] = cost;
+		Estimates[tileID] = estimate;
+		Parents[tileID] = parentTileID;
+
+		SiftUp(Heap.Add(tileID));
+		return true;
+	}
+
+	if (HeapIndices[tileID] == GetClosedIndex() || cost >= Costs[tileID])
+	{
+		return false;
+	}
+
+	// Decrease key, the tile can only move up the heap
+	Costs[tileID] = cost;
+	Estimates[tileID] = estimate;
+	Parents[tileID] = parentTileID;
+
+	SiftUp(HeapIndices[tileID]);
+	return true;
+}
+
+int32 FTT_PathSearchNodes::PopBest()
+{
+	const int32 bestTile = Heap[0];
+	const int32 lastTile = Heap.Pop(false);
+
+	if (Heap.Num() > 0)
+	{
+		Heap[0] = lastTile;
+		SiftDown(0);
+	}
+
+	HeapIndices[bestTile] = GetClosedIndex();
+	return bestTile;
+}
+
+void FTT_PathSearchNodes::BuildPath(int32 tileID, TArray<int32>& OutPath) const
+{
+	OutPath.Reset();
+	if (!IsReached(tileID))
+	{
+		return;
+	}
+
+	OutPath.Add(tileID);
+	while (Parents[tileID] != tileID)
+	{
+		tileID = Parents[tileID];
+		OutPath.Add(tileID);
+	}
+}
+
+void FTT_PathSearchNodes::SiftUp(int32 heapIndex)
+{
+	const int32 tileID = Heap[heapIndex];
+
+	while (heapIndex > 0)
+	{
+		const int32 parentIndex = (heapIndex - 1) >> 1;
+		if (!IsBefore(tileID, Heap[parentIndex]))
+		{
+			break;
+		}
+
+		Heap[heapIndex] = Heap[parentIndex];
+		HeapIndices[Heap[heapIndex]] = heapIndex;
+		heapIndex = parentIndex;
+	}
+
+	Heap[heapIndex] = tileID;
+	HeapIndices[tileID] = heapIndex;
+}
+
+void FTT_PathSearchNodes::SiftDown(int32 heapIndex)
+{
+	const int32 tileID = Heap[heapIndex];
+	const int32 heapSize = Heap.Num();
+
+	while (true)
+	{
+		int32 childIndex = 2 * heapIndex + 1;
+		if (childIndex >= heapSize)
+		{
+			break;
+		}
+
+		if (childIndex + 1 < heapSize && IsBefore(Heap[childIndex + 1], Heap[childIndex]))
+		{
+			childIndex++;
+		}
+
+		if (!IsBefore(Heap[childIndex], tileID))
+		{
+			break;
+		}
+
+		Heap[heapIndex] = Heap[childIndex];
+		HeapIndices[Heap[heapIndex]] = heapIndex;
+		heapIndex = childIndex;
+	}
+
+	Heap[heapIndex] = tileID;
+	HeapIndices[tileID] = heapIndex;
+}
+
+bool FTT_AStarSearch::FindPath(const FTT_GridTopology& topology, int32 startTile, int32 goalTile, bool allowDiagonalPaths, TFunctionRef<bool(int32)> isTileWalkable, TArray<int32>& OutPath)
+{
+	OutPath.Reset();
+	NumExpandedTiles = 0;
+
+	if (!topology.IsTileValid(startTile) || !topology.IsTileValid(goalTile) || !isTileWalkable(goalTile))
+	{
+		return false;
+	}
+
+	const FIntPoint goalCoordinate = topology.GetTileCoordinate(goalTile);
+
+	Nodes.BeginSearch(topology.GetNumTiles());
+	Nodes.Open(startTile, 0, GetHeuristic(goalCoordinate - topology.GetTileCoordinate(startTile), allowDiagonalPaths), startTile);
+
+	while (Nodes.HasOpenTiles())
+	{
+		const int32 currentTile = Nodes.PopBest();
+		NumExpandedTiles++;
+
+		if (currentTile == goalTile)
+		{
+			Nodes.BuildPath(goalTile, OutPath);
+			return true;
+		}
+
+		// One slot per direction, so that a diagonal move can check the two tiles it passes between
+		const FTT_TileNeighbours neighbours = topology.GetAllNeighbours(currentTile, allowDiagonalPaths);
+		bool isNeighbourWalkable[FTT_TileNeighbours::MaxNeighbours];
+		for (int32 direction = 0; direction < neighbours.Num; direction++)
+		{
+			isNeighbourWalkable[direction] = neighbours[direction] != -1 && isTileWalkable(neighbours[direction]);
+		}
+
+		const int32 currentCost = Nodes.GetCost(currentTile);
+		for (int32 direction = 0; direction < neighbours.Num; direction++)
+		{
+			const int32 neighbourTile = neighbours[direction];
+			if (!isNeighbourWalkable[direction] || Nodes.IsClosed(neighbourTile))
+			{
+				continue;
+			}
+
+			const bool isDiagonal = allowDiagonalPaths && (direction & 1);
+			if (isDiagonal && (!isNeighbourWalkable[direction - 1] || !isNeighbourWalkable[(direction + 1) & 7]))
+			{
+				continue;
+			}
+
+			const int32 cost = currentCost + (isDiagonal ? GetDiagonalCost() : GetStraightCost());
+			const int32 heuristic = GetHeuristic(goalCoordinate - topology.GetTileCoordinate(neighbourTile), allowDiagonalPaths);
+			Nodes.Open(neighbourTile, cost, cost + heuristic, currentTile);
+		}
+	}
+
+	return false;
+}
+
+FIntPoint FTT_ZoneDijkstraSearch::GetZoneOrigin(const FTT_TileRect& zone, const FIntPoint& coordinate)
+{
+	const FIntPoint zoneMax = zone.GetMax();
+	return FIntPoint(
+		coordinate.X - zone.Min.X <= zoneMax.X - coordinate.X ? zone.Min.X : zoneMax.X,
+		coordinate.Y - zone.Min.Y <= zoneMax.Y - coordinate.Y ? zone.Min.Y : zoneMax.Y);
+}
+
+int32 FTT_ZoneDijkstraSearch::GetZoneIndex(const FTT_TileRect& zone, const FIntPoint& origin, const FIntPoint& coordinate)
+{
+	if (!zone.Contains(coordinate))
+	{
+		return -1;
+	}
+
+	// Columns & rows are counted from the origin, toward the opposite corner
+	const int32 column = FMath::Abs(coordinate.X - origin.X);
+	const int32 row = FMath::Abs(coordinate.Y - origin.Y);
+	return row * zone.Size.X + column;
+}
+
+bool FTT_ZoneDijkstraSearch::FindPath(const FTT_GridTopology& topology, const FTT_TileRect& zone, const FIntPoint& origin, const TBitArray<>* zoneMask, int32 startTile, int32 goalTile,
+	bool allowDiagonalPaths, int32 maxDistance, TFunctionRef<bool(int32)> isTileWalkable, TArray<int32>& OutPath)
+{
+	OutPath.Reset();
+	NumExpandedTiles = 0;
+
+	const bool isOriginACorner = (origin.X == zone.Min.X || origin.X == zone.GetMax().X) && (origin.Y == zone.Min.Y || origin.Y == zone.GetMax().Y);
+	if (zone.IsEmpty() || !isOriginACorner || !topology.IsTileValid(startTile) || !topology.IsTileValid(goalTile))
+	{
+		return false;
+	}
+
+	const int32 startIndex = GetZoneIndex(zone, origin, topology.GetTileCoordinate(startTile));
+	const int32 goalIndex = GetZoneIndex(zone, origin, topology.GetTileCoordinate(goalTile));
+	if (startIndex == -1 || goalIndex == -1 || maxDistance <= 0)
+	{
+		return false;
+	}
+
+	const FIntPoint direction(origin.X == zone.Min.X ? 1 : -1, origin.Y == zone.Min.Y ? 1 : -1);
+	auto GetTileID = [&](int32 zoneIndex)
+	{
+		const int32 row = zoneIndex / zone.Size.X;
+		return topology.GetTileID(origin + FIntPoint((zoneIndex - row * zone.Size.X) * direction.X, row * direction.Y));
+	};
+
+	// Begin the search, the arrays are only cleared when the stamps wrap around
+	const int32 zoneArea = zone.GetArea();
+	if (Stamps.Num() < zoneArea)
+	{
+		Stamps.SetNumZeroed(zoneArea);
+		Parents.SetNumUninitialized(zoneArea);
+	}
+	CurrentStamp++;
+	if (CurrentStamp == 0)
+	{
+		FMemory::Memzero(Stamps.GetData(), Stamps.Num() * sizeof(uint32));
+		CurrentStamp = 1;
+	}
+
+	CurrentBucket.Reset();
+	NextBucket.Reset();
+
+	Stamps[startIndex] = CurrentStamp;
+	Parents[startIndex] = startIndex;
+	CurrentBucket.Add(startIndex);
+
+	for (int32 distance = 0; distance < maxDistance && CurrentBucket.Num() > 0; distance++)
+	{
+		// All the tiles at this distance are known, they are popped in the zone's order
+		CurrentBucket.Sort();
+
+		for (int32 zoneIndex : CurrentBucket)
+		{
+			NumExpandedTiles++;
+
+			if (zoneIndex == goalIndex)
+			{
+				OutPath.Add(goalTile);
+				while (Parents[zoneIndex] != zoneIndex)
+				{
+					zoneIndex = Parents[zoneIndex];
+					OutPath.Add(GetTileID(zoneIndex));
+				}
+				return true;
+			}
+
+			if (distance + 1 >= maxDistance)
+			{
+				continue;
+			}
+
+			// The first tile popped next to a tile is its parent, every move costing the same
+			for (int32 neighbourTile : topology.GetNeighbours(GetTileID(zoneIndex), allowDiagonalPaths))
+			{
+				const int32 neighbourIndex = GetZoneIndex(zone, origin, topology.GetTileCoordinate(neighbourTile));
+				if (neighbourIndex == -1 || IsReached(neighbourIndex) || (zoneMask && !(*zoneMask)[neighbourIndex]) || !isTileWalkable(neighbourTile))
+				{
+					continue;
+				}
+
+				Stamps[neighbourIndex] = CurrentStamp;
+				Parents[neighbourIndex] = zoneIndex;
+				NextBucket.Add(neighbourIndex);
+			}
+		}
+
+		Swap(CurrentBucket, NextBucket);
+		NextBucket.Reset();
+	}
+
+	return false;
+}
@@ -3,13 +3,18 @@
 #include "TT_Pathfinder.h"
 #include "TT_GridManager.h"
 #include "EngineUtils.h"
+#include "Async/Async.h"
 #include "TT_GridManager.h"
 #include "TT_BlockManager.h"
 
 // Sets default values for this component's properties
 UTT_Pathfinder::UTT_Pathfinder()
 {
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+
 	pathfindingMaxDistance = 500;
+	nextPathRequestID = 1;
 }
 
 void UTT_Pathfinder::BeginPlay()
@@ -21,10 +26,26 @@ void UTT_Pathfinder::BeginPlay()
 	{
 		UE_LOG(LogTemp, Error, TEXT("GridManager isn't valid in pathfinder component. Pathfinding won't work."))
 	}
-	else
+}
+
+void UTT_Pathfinder::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// Workers still running finish on their own, their results are dropped
+	for (const TPair<uint32, TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe>>& pendingRequest : pendingPathRequests)
 	{
-		tileArray = GridManager->GetAllTileIDs();
+		pendingRequest.Value->IsCancelled = true;
 	}
+	pendingPathRequests.Empty();
+	waitingPathRequestIDs.Empty();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void UTT_Pathfinder::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
+{
+	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
+
+	DispatchWaitingPathRequests(snapshotBudgetMs);
 }
 
 ATT_GridManager* UTT_Pathfinder::GetGridManager()
@@ -58,7 +79,7 @@ int UTT_Pathfinder::GetTileMoveCost(int tileID, TArray<int> blockToIgnore)
 {
 	if (GridManager)
 	{
-		int tileToCheck = GridManager->BlockManager->GetSpawnedBlockIDs()[tileID];
+		int tileToCheck = GridManager->BlockManager->GetSpawnedBlockIDOnTile(tileID);
 
 		if ( tileToCheck != 0 && !blockToIgnore.Contains(tileToCheck))
 		{
@@ -73,6 +94,17 @@ int UTT_Pathfinder::GetTileMoveCost(int tileID, TArray<int> blockToIgnore)
 	return 1;
 }
 
+bool UTT_Pathfinder::IsTileWalkable(int tileID, const TArray<int>& blockIDsToIgnore) const
+{
+	// Most tiles are free, only the used ones need their block looked up
+	ATT_BlockManager* blockManager = GridManager->BlockManager;
+	if (!blockManager->blockOccupancy.IsTileOccupied(tileID))
+	{
+		return true;
+	}
+	return blockIDsToIgnore.Contains(blockManager->GetSpawnedBlockIDOnTile(tileID));
+}
+
 bool UTT_Pathfinder::IsTileUsed(int tileID)
 {
 	if (GetTileMoveCost(tileID, TArray<int>()) > 10)
@@ -84,245 +116,410 @@ bool UTT_Pathfinder::IsTileUsed(int tileID)
 
 int UTT_Pathfinder::GetDistanceBetweenTwoTile(int tileA, int tileB)
 {
-	int distance;
-	FVector locA = GridManager->GetTileLocation(tileA, true);
-	FVector locB = GridManager->GetTileLocation(tileB, true);
+	// Tiles are evenly spaced, the distance only depends on their row and column difference
+	const FIntPoint delta = GridManager->GetGridTopology().GetTileDelta(tileA, tileB);
+	const float distanceInTiles = FMath::Sqrt(float(delta.X * delta.X + delta.Y * delta.Y));
 
-	distance = abs(FVector::Distance(locA, locB));
-	return distance;
+	return FMath::TruncToInt(distanceInTiles * GridManager->GetDistanceBetweenTiles());
 }
 
 TArray<int> UTT_Pathfinder::FindShortestPathDijkstra(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockToIgnore)
 {
-	return FindShortestPathInZoneDijkstra(startTile, goalTile, tileArray, allowDiagonalPaths, blockToIgnore);
+	// All the tiles in increasing tileID order, i.e. the grid seen as a zone starting from its first tile
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	const FTT_TileRect grid(FIntPoint(0, 0), FIntPoint(topology.SizeX, topology.SizeY));
+
+	return FindShortestPathInZone(startTile, goalTile, grid, grid.Min, nullptr, allowDiagonalPaths, blockToIgnore);
 }
 
 TArray<int> UTT_Pathfinder::FindShortestPathInZoneDijkstra(int startTile, int goalTile, TArray<int> zone, bool allowDiagonalPaths, TArray<int> blockToIgnore)
 {
-	if (zone.Num() > 1)
-	{
-		TArray<int> walkableTiles; // All the tiles the algo is authorised to work on.
-		TArray<int> unexploredTiles; // All the tiles the algo hasn't done yet.
-		TMap<int, int> distances; // Each tile's distance to StartTile (in move cost).
-		TMap<int, int> parentTiles; // Each tile's preferred parent.
-		TArray<int> pathResult; // All the tiles from end to start of the shortest path.
-		TArray<int> EmptyTiles; // Array to return in case no paths were found.
-
-		// Initialisation
-		walkableTiles = zone;
-		int tileIDOffset = startTile;
-		for (int i : walkableTiles)
+	if (zone.Num() <= 1 || !GridManager)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No path was found, returning empty array"));
+		return TArray<int>();
+	}
+
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	FIntPoint zoneMin(MAX_int32, MAX_int32);
+	FIntPoint zoneMax(MIN_int32, MIN_int32);
+	for (int tileID : zone)
+	{
+		if (!topology.IsTileValid(tileID))
 		{
-			unexploredTiles.Add(i);
-			distances.Add(i, pathfindingMaxDistance);
-			parentTiles.Add(i, startTile);
+			UE_LOG(LogTemp, Warning, TEXT("Zone contains invalid tile %d, no path was found."), tileID);
+			return TArray<int>();
 		}
-		distances[startTile] = 0;
+		const FIntPoint coordinate = topology.GetTileCoordinate(tileID);
+		zoneMin = zoneMin.ComponentMin(coordinate);
+		zoneMax = zoneMax.ComponentMax(coordinate);
+	}
 
-		// Main looping body
-		while (unexploredTiles.Num() != 0)
-		{
-			int currentTile = startTile;
-			int minimumDistance = pathfindingMaxDistance + 1;
-			TArray<int> distanceKeys;
-			TArray<int> distancesValues;
-			distances.GenerateValueArray(distancesValues);
-			distances.GenerateKeyArray(distanceKeys);
-
-			// Get the tileID with the shortest distance to the start tile
-			for (int i = 0; i < unexploredTiles.Num(); i++)
-			{
-				int index = distanceKeys.Find(unexploredTiles[i]);
+	// Zones from GetZoneTileIDsFromZoneParameters start at one corner of their rectangle and are ordered from there
+	const FTT_TileRect zoneRect = FTT_TileRect::FromCorners(zoneMin, zoneMax);
+	const FIntPoint zoneOrigin = FTT_ZoneDijkstraSearch::GetZoneOrigin(zoneRect, topology.GetTileCoordinate(zone[0]));
 
-				if (distancesValues[index] < minimumDistance)
-				{
-					minimumDistance = distancesValues[index];
-					currentTile = distanceKeys[index];
-				}
-			}
+	if (zone.Num() >= zoneRect.GetArea())
+	{
+		return FindShortestPathInZone(startTile, goalTile, zoneRect, zoneOrigin, nullptr, allowDiagonalPaths, blockToIgnore);
+	}
 
-			// Remove the tile from unexploredTiles
-			unexploredTiles.Remove(currentTile);
+	TBitArray<> zoneMask(false, zoneRect.GetArea());
+	for (int tileID : zone)
+	{
+		zoneMask[FTT_ZoneDijkstraSearch::GetZoneIndex(zoneRect, zoneOrigin, topology.GetTileCoordinate(tileID))] = true;
+	}
+	return FindShortestPathInZone(startTile, goalTile, zoneRect, zoneOrigin, &zoneMask, allowDiagonalPaths, blockToIgnore);
+}
 
-			// Get tile's neighbours 
-			TArray<int> tileNeighbours = GetTileNeighbours(currentTile, allowDiagonalPaths);
-			for (int i = 0; i < tileNeighbours.Num(); i++)
-			{
-				int neighbourTileID = tileNeighbours[i];
-				if (walkableTiles.Contains(neighbourTileID))
-				{
-					if (distanceKeys.Contains(neighbourTileID))
-					{
-						int dist = 0;
-						dist = distances[currentTile] + GetTileMoveCost(neighbourTileID, blockToIgnore);
-
-						if (dist < distances[neighbourTileID])
-						{
-							distances[neighbourTileID] = dist;
-							parentTiles[neighbourTileID] = currentTile;
-						}
-					}
-				}
-			}
+TArray<int> UTT_Pathfinder::FindShortestPathInRectDijkstra(int startTile, int goalTile, const FTT_TileRect& zone, bool allowDiagonalPaths, TArray<int> blockToIgnore)
+{
+	if (zone.GetArea() <= 1 || !GridManager || !GridManager->IsTileValid(startTile))
+	{
+		UE_LOG(LogTemp, Warning, TEXT("No path was found, returning empty array"));
+		return TArray<int>();
+	}
+
+	const FIntPoint zoneOrigin = FTT_ZoneDijkstraSearch::GetZoneOrigin(zone, GridManager->GetGridTopology().GetTileCoordinate(startTile));
+	return FindShortestPathInZone(startTile, goalTile, zone, zoneOrigin, nullptr, allowDiagonalPaths, blockToIgnore);
+}
+
+TArray<int> UTT_Pathfinder::FindShortestPathInZone(int startTile, int goalTile, const FTT_TileRect& zone, const FIntPoint& zoneOrigin, const TBitArray<>* zoneMask, bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore)
+{
+	TArray<int> pathResult;
+	const bool isPathFound = zoneDijkstraSearch.FindPath(GridManager->GetGridTopology(), zone, zoneOrigin, zoneMask, startTile, goalTile, allowDiagonalPaths, pathfindingMaxDistance, [&](int32 tileID)
+	{
+		return IsTileWalkable(tileID, blockIDsToIgnore);
+	}, pathResult);
 
+	// Unreached tiles kept the start tile as parent in the former implementation, the build tool relies on these short paths to fall back to A*
+	if (!isPathFound || startTile == goalTile)
+	{
+		const FTT_GridTopology& topology = GridManager->GetGridTopology();
+		if (!topology.IsTileValid(startTile) || !topology.IsTileValid(goalTile)
+			|| !zone.Contains(topology.GetTileCoordinate(startTile)) || !zone.Contains(topology.GetTileCoordinate(goalTile)))
+		{
+			UE_LOG(LogTemp, Warning, TEXT("No path was found, returning empty array"));
+			return TArray<int>();
 		}
 
-		// Getting the path from looping result
+		pathResult.Reset();
 		pathResult.Add(goalTile);
-		for (int i = 0; i < parentTiles.Num(); i++)
-		{
-			pathResult.Add(parentTiles[pathResult[i]]);
+		pathResult.Add(startTile);
+	}
 
-			if (parentTiles[pathResult[i]] == startTile)
-			{
-				break;
-			}
-		}
+	return pathResult;
+}
 
-		// Path is valid
-		if (pathResult.Num() > 0)
-		{
-			return pathResult;
-		}
+TArray<int> UTT_Pathfinder::FindShortestPathAStar(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockToIgnore)
+{
+	TArray<int> pathResult;
+	if (!GridManager || startTile == goalTile)
+	{
+		return pathResult;
+	}
 
-		// Path isn't valid
-		else
+	aStarSearch.FindPath(GridManager->GetGridTopology(), startTile, goalTile, allowDiagonalPaths, [&](int32 tileID)
+	{
+		return IsTileWalkable(tileID, blockToIgnore);
+	}, pathResult);
+
+	return pathResult;
+}
+
+TArray<int> UTT_Pathfinder::FindShortestPathJPS(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockToIgnore)
+{
+	TArray<int> pathResult;
+	if (!GridManager || startTile == goalTile)
+	{
+		return pathResult;
+	}
+
+	const FTT_JumpPointMap& jumpPointMap = GetJumpPointMap(allowDiagonalPaths, blockToIgnore);
+	jumpPointSearch.FindPath(jumpPointMap, startTile, goalTile, [&](int32 tileID)
+	{
+		return IsTileWalkable(tileID, blockToIgnore);
+	}, pathResult);
+
+	return pathResult;
+}
+
+TArray<int> UTT_Pathfinder::FindPathHierarchical(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockToIgnore)
+{
+	TArray<int> pathResult;
+	if (!GridManager || startTile == goalTile)
+	{
+		return pathResult;
+	}
+
+	hierarchicalSearch.FindPath(GetHierarchicalMap(allowDiagonalPaths, blockToIgnore), startTile, goalTile, pathResult);
+	return pathResult;
+}
+
+TArray<int> UTT_Pathfinder::FindShortestPath(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockToIgnore)
+{
+	switch (gridPathfinding)
+	{
+	case EGridPathfinding::GP_JumpPointSearch:
+		return FindShortestPathJPS(startTile, goalTile, allowDiagonalPaths, blockToIgnore);
+
+	case EGridPathfinding::GP_Hierarchical:
+		return FindPathHierarchical(startTile, goalTile, allowDiagonalPaths, blockToIgnore);
+
+	default:
+		return FindShortestPathAStar(startTile, goalTile, allowDiagonalPaths, blockToIgnore);
+	}
+}
+
+FTT_PathfinderMaps& UTT_Pathfinder::GetPathfinderMaps(bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore)
+{
+	if (!blockOccupancyChangedHandle.IsValid())
+	{
+		blockOccupancyChangedHandle = GridManager->BlockManager->OnBlockOccupancyChanged.AddUObject(this, &UTT_Pathfinder::OnBlockOccupancyChanged);
+	}
+
+	TArray<int> sortedBlockIDs = blockIDsToIgnore;
+	sortedBlockIDs.Sort();
+
+	FTT_PathfinderMaps* maps = pathfinderMaps.FindByPredicate([&](const FTT_PathfinderMaps& cachedMaps)
+	{
+		return cachedMaps.AllowDiagonalPaths == allowDiagonalPaths && cachedMaps.BlockIDsToIgnore == sortedBlockIDs;
+	});
+
+	if (!maps)
+	{
+		// Only a few sets of blocks are ignored at once (the build tool's path block), the oldest maps make room
+		const int maxPathfinderMaps = 4;
+		if (pathfinderMaps.Num() >= maxPathfinderMaps)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("No path was found, returning empty array"));
-			return EmptyTiles;
+			pathfinderMaps.RemoveAt(0);
 		}
+
+		maps = &pathfinderMaps[pathfinderMaps.AddDefaulted()];
+		maps->BlockIDsToIgnore = sortedBlockIDs;
+		maps->AllowDiagonalPaths = allowDiagonalPaths;
 	}
 
-	else
+	return *maps;
+}
+
+const FTT_JumpPointMap& UTT_Pathfinder::GetJumpPointMap(bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore)
+{
+	FTT_PathfinderMaps& maps = GetPathfinderMaps(allowDiagonalPaths, blockIDsToIgnore);
+
+	// New maps have an empty grid, they are made on their first use
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	if (maps.JumpPointMap.GetTopology().SizeX != topology.SizeX || maps.JumpPointMap.GetTopology().SizeY != topology.SizeY)
 	{
-		UE_LOG(LogTemp, Warning, TEXT("No path was found, returning empty array"));
-		TArray<int> EmptyTiles;
-		return EmptyTiles;
+		maps.JumpPointMap.Init(topology, allowDiagonalPaths);
 	}
+
+	const TArray<int>& ignoredBlockIDs = maps.BlockIDsToIgnore;
+	maps.JumpPointMap.Update([&](int32 tileID)
+	{
+		return IsTileWalkable(tileID, ignoredBlockIDs);
+	});
+
+	return maps.JumpPointMap;
 }
 
-TArray<int> UTT_Pathfinder::FindShortestPathAStar(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockToIgnore)
+const FTT_HierarchicalPathMap& UTT_Pathfinder::GetHierarchicalMap(bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore)
 {
-	if (startTile != goalTile && GetTileMoveCost(goalTile, blockToIgnore) < 500)
-	{
-		TArray<int> indexedTiles;
-		TArray<int> unexploredTiles;
-		TMap<int, int> gCost; // Distance from start node
-		TMap<int, int> hCost; // Distance to goal
-		TMap<int, int> fCost; // g[i] + h[i]
-		TMap<int, int> parentTiles; // Each tiles parent tile.
-		TArray<int> exploredTiles;
-		TArray<int> pathResult; // Final path to return
-		TArray<int> EmptyTiles; // Empty path to return
-		TArray<int> currentTileNeighbours;
-		int currentTile;
-
-		// Initialisation
-		indexedTiles.Add(startTile);
-		unexploredTiles.Add(startTile);
-		parentTiles.Add(startTile, startTile);
-		gCost.Add(startTile, 0);
-		hCost.Add(startTile, GetDistanceBetweenTwoTile(startTile, goalTile));
-		fCost.Add(startTile, gCost[startTile] + hCost[startTile]);
-
-
-		// Main looping body
-		while (unexploredTiles.Num() != 0)
-		{
-			// Get the tileID with the shortest distance to the start tile
-			int lowestFCostTile = INT_MAX;
-			for (int i : unexploredTiles)
-			{
+	FTT_PathfinderMaps& maps = GetPathfinderMaps(allowDiagonalPaths, blockIDsToIgnore);
 
-				if (fCost[i] < lowestFCostTile)
-				{
-					lowestFCostTile = fCost[i];
-					currentTile = i;
-				}
-			}
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	if (maps.HierarchicalMap.GetTopology().SizeX != topology.SizeX || maps.HierarchicalMap.GetTopology().SizeY != topology.SizeY)
+	{
+		maps.HierarchicalMap.Init(topology, allowDiagonalPaths);
+	}
 
-			unexploredTiles.Remove(currentTile);
-			exploredTiles.Add(currentTile);
+	const TArray<int>& ignoredBlockIDs = maps.BlockIDsToIgnore;
+	maps.HierarchicalMap.Update([&](int32 tileID)
+	{
+		return IsTileWalkable(tileID, ignoredBlockIDs);
+	});
 
-			// Has the goal tile been reached
-			if (currentTile == goalTile)
-			{
-				break;
-			}
+	return maps.HierarchicalMap;
+}
 
-			// Get tile's neighbours 
-			currentTileNeighbours = GetTileNeighbours(currentTile, allowDiagonalPaths);
-			for (int i = 0; i < currentTileNeighbours.Num(); i++)
-			{
-				int currentNeighbour = currentTileNeighbours[i];
+void UTT_Pathfinder::OnBlockOccupancyChanged(const FTT_TileRect& changedRect)
+{
+	for (FTT_PathfinderMaps& maps : pathfinderMaps)
+	{
+		maps.JumpPointMap.Invalidate(changedRect);
+		maps.HierarchicalMap.Invalidate(changedRect);
+		maps.WalkabilitySnapshot.Invalidate(changedRect);
+		maps.SharedWalkabilitySnapshot.Reset();
+	}
+}
 
-				if (exploredTiles.Contains(currentNeighbour) || GetTileMoveCost(currentNeighbour, blockToIgnore) > 500)
-				{
-					// Skip to next neighbour
-				}
+TSharedPtr<const FTT_WalkabilitySnapshot, ESPMode::ThreadSafe> UTT_Pathfinder::GetWalkabilitySnapshot(bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore, float budgetMs)
+{
+	FTT_PathfinderMaps& maps = GetPathfinderMaps(allowDiagonalPaths, blockIDsToIgnore);
 
-				else
-				{
-					int gValue = GetDistanceBetweenTwoTile(startTile, currentNeighbour) + gCost[currentTile];
-					int hValue = GetDistanceBetweenTwoTile(currentNeighbour, goalTile);
-					int fValue = gValue + hValue;
-
-					if (fCost.Contains(currentNeighbour))
-					{
-						if (fCost[currentNeighbour] > fValue)
-						{
-							gCost[currentNeighbour] = gValue;
-							hCost[currentNeighbour] = hValue;
-							fCost[currentNeighbour] = fValue;
-
-							parentTiles[currentNeighbour] = currentTile;
-						}
-					}
-
-					else
-					{
-						gCost.Add(currentNeighbour, gValue);
-						hCost.Add(currentNeighbour, hValue);
-						fCost.Add(currentNeighbour, fValue);
-
-						indexedTiles.Add(currentNeighbour);
-						parentTiles.Add(currentNeighbour, currentTile);
-					}
-
-					unexploredTiles.Add(currentNeighbour);
-				}
-			}
-		}
+	// New maps have an empty grid, their snapshot reads every chunk first
+	const FTT_GridTopology& topology = GridManager->GetGridTopology();
+	if (maps.WalkabilitySnapshot.GetTopology().SizeX != topology.SizeX || maps.WalkabilitySnapshot.GetTopology().SizeY != topology.SizeY)
+	{
+		maps.WalkabilitySnapshot.Init(topology);
+		maps.SharedWalkabilitySnapshot.Reset();
+	}
 
-		// Getting the path from looping result
-		pathResult.Add(goalTile);
-		for (int i = 0; i < parentTiles.Num(); i++)
+	if (!maps.SharedWalkabilitySnapshot.IsValid())
+	{
+		const TArray<int>& ignoredBlockIDs = maps.BlockIDsToIgnore;
+		const bool isUpToDate = maps.WalkabilitySnapshot.Update([&](int32 tileID)
 		{
-			if (pathResult[i] == startTile)
-			{
-				break;
-			}
+			return IsTileWalkable(tileID, ignoredBlockIDs);
+		}, budgetMs);
 
-			pathResult.Add(parentTiles[pathResult[i]]);
+		if (!isUpToDate)
+		{
+			return nullptr;
+		}
+
+		// Only copies the chunks' pointers, running requests keep them when the chunks are read again
+		maps.SharedWalkabilitySnapshot = MakeShared<const FTT_WalkabilitySnapshot, ESPMode::ThreadSafe>(maps.WalkabilitySnapshot);
+	}
+
+	return maps.SharedWalkabilitySnapshot;
+}
+
+FTT_PathRequestHandle UTT_Pathfinder::RequestPathAsync(const FTT_PathQuery& query, const TArray<int>& blockIDsToIgnore, FTT_OnPathFound onPathFound)
+{
+	FTT_PathRequestHandle handle;
+	if (!GridManager)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("GridManager not valid in pathfinder component, cannot request a path."));
+		return handle;
+	}
 
+	if (!pathWorkerSearchPool.IsValid())
+	{
+		pathWorkerSearchPool = MakeShared<FTT_PathWorkerSearchPool, ESPMode::ThreadSafe>();
+	}
+
+	TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe> request = MakeShared<FTT_PathRequest, ESPMode::ThreadSafe>();
+	request->Query = query;
+	request->BlockIDsToIgnore = blockIDsToIgnore;
+	request->MaxZoneDistance = pathfindingMaxDistance;
+	request->OnPathFound = onPathFound;
+
+	handle.RequestID = nextPathRequestID;
+	nextPathRequestID = nextPathRequestID == MAX_uint32 ? 1 : nextPathRequestID + 1;
+	pendingPathRequests.Add(handle.RequestID, request);
+	waitingPathRequestIDs.Add(handle.RequestID);
+
+	// Usually dispatched right away, only big changes of the grid leave the request waiting for the next frames
+	DispatchWaitingPathRequests(snapshotBudgetMs);
+
+	return handle;
+}
+
+void UTT_Pathfinder::DispatchWaitingPathRequests(float budgetMs)
+{
+	const double endTime = FPlatformTime::Seconds() + budgetMs / 1000.0;
+
+	int32 numDispatchedRequests = 0;
+	for (; numDispatchedRequests < waitingPathRequestIDs.Num(); numDispatchedRequests++)
+	{
+		// Cancelled requests are skipped
+		const uint32 requestID = waitingPathRequestIDs[numDispatchedRequests];
+		TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe>* pendingRequest = pendingPathRequests.Find(requestID);
+		if (!pendingRequest)
+		{
+			continue;
 		}
 
-		// Path is valid
-		if (pathResult.Num() > 0)
+		const TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe> request = *pendingRequest;
+		const float remainingMs = (float)FMath::Max((endTime - FPlatformTime::Seconds()) * 1000.0, 0.0);
+		request->Snapshot = GetWalkabilitySnapshot(request->Query.AllowDiagonalPaths, request->BlockIDsToIgnore, remainingMs);
+		if (!request->Snapshot.IsValid())
 		{
-			return pathResult;
+			break;
 		}
 
-		// Path isn't valid
-		else
+		DispatchPathRequest(requestID, request);
+	}
+
+	waitingPathRequestIDs.RemoveAt(0, numDispatchedRequests);
+	SetComponentTickEnabled(waitingPathRequestIDs.Num() > 0);
+}
+
+void UTT_Pathfinder::DispatchPathRequest(uint32 requestID, const TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe>& request)
+{
+	// The worker only touches the request & the search pool, the pathfinder may be gone by the time it is done
+	const TSharedRef<FTT_PathWorkerSearchPool, ESPMode::ThreadSafe> searchPool = pathWorkerSearchPool.ToSharedRef();
+	const TWeakObjectPtr<UTT_Pathfinder> weakPathfinder(this);
+
+	request->CompletionEvent = FFunctionGraphTask::CreateAndDispatchWhenReady([request, searchPool, weakPathfinder, requestID]()
+	{
+		request->Execute(*searchPool);
+
+		if (!request->IsCancelled)
 		{
-			UE_LOG(LogTemp, Warning, TEXT("No path was found, returning empty array"));
-			return EmptyTiles;
+			AsyncTask(ENamedThreads::GameThread, [weakPathfinder, requestID]()
+			{
+				if (UTT_Pathfinder* pathfinder = weakPathfinder.Get())
+				{
+					pathfinder->DeliverPathRequest(requestID);
+				}
+			});
 		}
+	}, TStatId(), nullptr, ENamedThreads::AnyBackgroundThreadNormalTask);
+}
+
+void UTT_Pathfinder::DeliverPathRequest(uint32 requestID)
+{
+	TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe>* pendingRequest = pendingPathRequests.Find(requestID);
+	if (!pendingRequest)
+	{
+		return;
 	}
-	else
+
+	const TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe> request = *pendingRequest;
+	pendingPathRequests.Remove(requestID);
+
+	request->OnPathFound.ExecuteIfBound(request->Path);
+}
+
+void UTT_Pathfinder::CancelPathRequest(FTT_PathRequestHandle& handle)
+{
+	if (TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe>* pendingRequest = pendingPathRequests.Find(handle.RequestID))
+	{
+		(*pendingRequest)->IsCancelled = true;
+		pendingPathRequests.Remove(handle.RequestID);
+	}
+
+	handle.Invalidate();
+}
+
+bool UTT_Pathfinder::CompletePathRequest(FTT_PathRequestHandle& handle)
+{
+	const uint32 requestID = handle.RequestID;
+	handle.Invalidate();
+
+	TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe>* pendingRequest = pendingPathRequests.Find(requestID);
+	if (!pendingRequest)
+	{
+		return false;
+	}
+
+	// A request still waiting for its snapshot finishes it now, with the ones made before it
+	if (!(*pendingRequest)->CompletionEvent.IsValid())
 	{
-	TArray<int> EmptyTiles;
-	return EmptyTiles;
- }
+		DispatchWaitingPathRequests(MAX_flt);
+		pendingRequest = pendingPathRequests.Find(requestID);
+	}
+
+	// Only waits for this worker, the game thread's other tasks (deliveries of other requests) run later as usual
+	FTaskGraphInterface::Get().WaitUntilTaskCompletes((*pendingRequest)->CompletionEvent, ENamedThreads::GameThread_Local);
+	DeliverPathRequest(requestID);
+
+	return true;
+}
+
+bool UTT_Pathfinder::IsPathRequestPending(const FTT_PathRequestHandle& handle) const
+{
+	return handle.IsValid() && pendingPathRequests.Contains(handle.RequestID);
 }
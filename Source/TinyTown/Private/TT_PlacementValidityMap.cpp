@@ -0,0 +1,239 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_PlacementValidityMap.h"
+
+void FTT_PlacementValidityMap::Build(const FTT_OccupancyBitboard& occupancy, const FTT_PlacementFootprint& footprint)
+{
+	Topology = occupancy.GetTopology();
+	Footprint = FTT_PlacementFootprint(footprint.Size.ComponentMax(FIntPoint(1, 1)), footprint.AnchorOffset);
+	WordsPerRow = occupancy.GetWordsPerRow();
+
+	if (WordsPerRow == 0 || Topology.SizeY == 0)
+	{
+		ErodedRows.Reset();
+		ValidTiles.Reset();
+		return;
+	}
+
+	const int32 lastWordColumns = Topology.SizeX & 63;
+	LastWordMask = lastWordColumns == 0 ? ~uint64(0) : FTT_OccupancyBitboard::GetBitMask(0, lastWordColumns - 1);
+
+	ErodedRows.SetNumUninitialized(WordsPerRow * Topology.SizeY);
+	ValidTiles.SetNumUninitialized(WordsPerRow * Topology.SizeY);
+	ScratchRow.SetNumUninitialized(WordsPerRow);
+
+	for (int32 row = 0; row < Topology.SizeY; row++)
+	{
+		ErodeRow(occupancy, row);
+	}
+
+	for (int32 row = 0; row < Topology.SizeY; row++)
+	{
+		UpdateValidRow(row);
+	}
+}
+
+void FTT_PlacementValidityMap::Update(const FTT_OccupancyBitboard& occupancy, const FTT_TileRect& changedRect)
+{
+	if (changedRect.IsEmpty() || WordsPerRow == 0)
+	{
+		return;
+	}
+
+	const int32 firstChangedRow = FMath::Max(changedRect.Min.Y, 0);
+	const int32 lastChangedRow = FMath::Min(changedRect.GetMax().Y, Topology.SizeY - 1);
+
+	for (int32 row = firstChangedRow; row <= lastChangedRow; row++)
+	{
+		ErodeRow(occupancy, row);
+	}
+
+	// Blocks whose lowest row is up to a footprint's height below the change cover it, their hovered tile is AnchorOffset.Y above
+	const int32 firstValidRow = FMath::Max(firstChangedRow - (Footprint.Size.Y - 1) + Footprint.AnchorOffset.Y, 0);
+	const int32 lastValidRow = FMath::Min(lastChangedRow + Footprint.AnchorOffset.Y, Topology.SizeY - 1);
+
+	for (int32 row = firstValidRow; row <= lastValidRow; row++)
+	{
+		UpdateValidRow(row);
+	}
+}
+
+int32 FTT_PlacementValidityMap::FindNearestValidTile(int32 tileID, int32 maxRadius, const FVector2D& tieBreakCoordinate) const
+{
+	if (!Topology.IsTileValid(tileID) || maxRadius < 0 || ValidTiles.Num() == 0)
+	{
+		return -1;
+	}
+
+	const FIntPoint centre = Topology.GetTileCoordinate(tileID);
+	const int32 maxSquaredDistance = maxRadius * maxRadius;
+
+	int32 nearestTileID = -1;
+	int32 nearestSquaredDistance = MAX_int32;
+	float nearestTieBreakDistance = MAX_flt;
+
+	auto ConsiderTile = [&](int32 column, int32 row)
+	{
+		const int32 squaredDistance = FMath::Square(column - centre.X) + FMath::Square(row - centre.Y);
+		const float tieBreakDistance = FVector2D::DistSquared(FVector2D(column + 0.5f, row + 0.5f), tieBreakCoordinate);
+
+		if (squaredDistance < nearestSquaredDistance || (squaredDistance == nearestSquaredDistance && tieBreakDistance < nearestTieBreakDistance))
+		{
+			nearestTileID = Topology.GetTileID(FIntPoint(column, row));
+			nearestSquaredDistance = squaredDistance;
+			nearestTieBreakDistance = tieBreakDistance;
+		}
+	};
+
+	// Rows are visited by increasing distance to the centre, none can beat the nearest tile once they are further than it
+	for (int32 rowDistance = 0; rowDistance <= maxRadius && rowDistance * rowDistance <= nearestSquaredDistance; rowDistance++)
+	{
+		const int32 squaredRowDistance = rowDistance * rowDistance;
+		const int32 searchedSquaredDistance = FMath::Min(maxSquaredDistance, nearestSquaredDistance) - squaredRowDistance;
+		const int32 maxColumnDistance = FMath::FloorToInt(FMath::Sqrt(float(searchedSquaredDistance)));
+
+		const int32 rows[2] = { centre.Y - rowDistance, centre.Y + rowDistance };
+		for (int32 rowIndex = 0; rowIndex < (rowDistance == 0 ? 1 : 2); rowIndex++)
+		{
+			const int32 row = rows[rowIndex];
+			if (row < 0 || row >= Topology.SizeY)
+			{
+				continue;
+			}
+
+			const int32 rightColumn = FindFirstValidColumn(row, centre.X, FMath::Min(centre.X + maxColumnDistance, Topology.SizeX - 1));
+			if (rightColumn != -1)
+			{
+				ConsiderTile(rightColumn, row);
+			}
+
+			const int32 leftColumn = FindLastValidColumn(row, FMath::Max(centre.X - maxColumnDistance, 0), centre.X);
+			if (leftColumn != -1 && leftColumn != rightColumn)
+			{
+				ConsiderTile(leftColumn, row);
+			}
+		}
+	}
+
+	return nearestSquaredDistance <= maxSquaredDistance ? nearestTileID : -1;
+}
+
+int32 FTT_PlacementValidityMap::FindFirstValidColumn(int32 row, int32 firstColumn, int32 lastColumn) const
+{
+	const uint64* validWords = GetRow(row);
+
+	for (int32 wordIndex = firstColumn >> 6; wordIndex <= lastColumn >> 6; wordIndex++)
+	{
+		const int32 firstBit = wordIndex == (firstColumn >> 6) ? (firstColumn & 63) : 0;
+		const int32 lastBit = wordIndex == (lastColumn >> 6) ? (lastColumn & 63) : 63;
+		const uint64 bits = validWords[wordIndex] & FTT_OccupancyBitboard::GetBitMask(firstBit, lastBit);
+
+		if (bits)
+		{
+			// Isolate the lowest bit
+			return (wordIndex << 6) + 63 - int32(FPlatformMath::CountLeadingZeros64(bits & (~bits + 1)));
+		}
+	}
+	return -1;
+}
+
+int32 FTT_PlacementValidityMap::FindLastValidColumn(int32 row, int32 firstColumn, int32 lastColumn) const
+{
+	const uint64* validWords = GetRow(row);
+
+	for (int32 wordIndex = lastColumn >> 6; wordIndex >= firstColumn >> 6; wordIndex--)
+	{
+		const int32 firstBit = wordIndex == (firstColumn >> 6) ? (firstColumn & 63) : 0;
+		const int32 lastBit = wordIndex == (lastColumn >> 6) ? (lastColumn & 63) : 63;
+		const uint64 bits = validWords[wordIndex] & FTT_OccupancyBitboard::GetBitMask(firstBit, lastBit);
+
+		if (bits)
+		{
+			return (wordIndex << 6) + 63 - int32(FPlatformMath::CountLeadingZeros64(bits));
+		}
+	}
+	return -1;
+}
+
+void FTT_PlacementValidityMap::ErodeRow(const FTT_OccupancyBitboard& occupancy, int32 row)
+{
+	const uint64* occupiedWords = occupancy.GetRow(row);
+	uint64* erodedWords = ErodedRows.GetData() + row * WordsPerRow;
+
+	for (int32 wordIndex = 0; wordIndex < WordsPerRow; wordIndex++)
+	{
+		erodedWords[wordIndex] = ~occupiedWords[wordIndex];
+	}
+	erodedWords[WordsPerRow - 1] &= LastWordMask;
+
+	// Bits hold runs of "length" free tiles, each pass doubles the length (at most) until it reaches the footprint's width
+	int32 length = 1;
+	while (length < Footprint.Size.X)
+	{
+		const int32 shift = FMath::Min(length, Footprint.Size.X - length);
+		ShiftRowRight(erodedWords, ScratchRow.GetData(), shift);
+
+		for (int32 wordIndex = 0; wordIndex < WordsPerRow; wordIndex++)
+		{
+			erodedWords[wordIndex] &= ScratchRow[wordIndex];
+		}
+		length += shift;
+	}
+}
+
+void FTT_PlacementValidityMap::UpdateValidRow(int32 row)
+{
+	uint64* validWords = ValidTiles.GetData() + row * WordsPerRow;
+
+	// Lowest row of the blocks placed around this row's tiles
+	const int32 firstBlockRow = row - Footprint.AnchorOffset.Y;
+	if (firstBlockRow < 0 || firstBlockRow + Footprint.Size.Y > Topology.SizeY)
+	{
+		FMemory::Memzero(validWords, WordsPerRow * sizeof(uint64));
+		return;
+	}
+
+	FMemory::Memcpy(ScratchRow.GetData(), ErodedRows.GetData() + firstBlockRow * WordsPerRow, WordsPerRow * sizeof(uint64));
+	for (int32 blockRow = firstBlockRow + 1; blockRow < firstBlockRow + Footprint.Size.Y; blockRow++)
+	{
+		const uint64* erodedWords = ErodedRows.GetData() + blockRow * WordsPerRow;
+		for (int32 wordIndex = 0; wordIndex < WordsPerRow; wordIndex++)
+		{
+			ScratchRow[wordIndex] &= erodedWords[wordIndex];
+		}
+	}
+
+	// Move each block from its lowest column to its hovered tile's column
+	ShiftRowLeft(ScratchRow.GetData(), validWords, Footprint.AnchorOffset.X);
+	validWords[WordsPerRow - 1] &= LastWordMask;
+}
+
+void FTT_PlacementValidityMap::ShiftRowRight(const uint64* source, uint64* dest, int32 shift) const
+{
+	const int32 wordShift = shift >> 6;
+	const int32 bitShift = shift & 63;
+
+	for (int32 wordIndex = 0; wordIndex < WordsPerRow; wordIndex++)
+	{
+		const int32 sourceIndex = wordIndex + wordShift;
+		const uint64 lowWord = sourceIndex < WordsPerRow ? source[sourceIndex] : 0;
+		const uint64 highWord = sourceIndex + 1 < WordsPerRow ? source[sourceIndex + 1] : 0;
+
+		dest[wordIndex] = bitShift == 0 ? lowWord : (lowWord >> bitShift) | (highWord << (64 - bitShift));
+	}
+}
+
+void FTT_PlacementValidityMap::ShiftRowLeft(const uint64* source, uint64* dest, int32 shift) const
+{
+	const int32 wordShift = shift >> 6;
+	const int32 bitShift = shift & 63;
+
+	for (int32 wordIndex = WordsPerRow - 1; wordIndex >= 0; wordIndex--)
+	{
+		const int32 sourceIndex = wordIndex - wordShift;
+		const uint64 highWord = sourceIndex >= 0 ? source[sourceIndex] : 0;
+		const uint64 lowWord = sourceIndex - 1 >= 0 ? source[sourceIndex - 1] : 0;
+
+		dest[wordIndex] = bitShift == 0 ? highWord : (highWord << bitShift) | (lowWord >> (64 - bitShift));
+	}
+}
@@ -359,9 +359,14 @@ bool ATT_PlayerGridCamera::SelectBlockFromTileID(int tileID)
 {
 	if (GridManager->IsTileValid(tileID))
 	{
-		if (GetBlockManager()->spawnedBlocks[tileID] != nullptr)
+		// Instanced blocks get their actor while they are selected
+		if (ATT_Block* blockOnTile = GetBlockManager()->GetOrSpawnBlockActorOnTile(tileID))
 		{
-			selectedBlock = GetBlockManager()->spawnedBlocks[tileID];
+			if (selectedBlock != nullptr && selectedBlock != blockOnTile)
+			{
+				GetBlockManager()->ReturnBlockToInstance(selectedBlock);
+			}
+			selectedBlock = blockOnTile;
 
 			isBlockSelected = true;
 
@@ -377,6 +382,11 @@ bool ATT_PlayerGridCamera::SelectBlock(ATT_Block* blockToSelect)
 {
 	if (blockToSelect)
 	{
+		// The previous selection goes back to its instance, if it came from one
+		if (selectedBlock != nullptr && selectedBlock != blockToSelect && GetBlockManager())
+		{
+			GetBlockManager()->ReturnBlockToInstance(selectedBlock);
+		}
 		selectedBlock = blockToSelect;
 		isBlockSelected = true;
 
@@ -390,6 +400,10 @@ void ATT_PlayerGridCamera::DeselectBlock()
 {
 	if (selectedBlock != nullptr)
 	{
+		if (GetBlockManager())
+		{
+			GetBlockManager()->ReturnBlockToInstance(selectedBlock);
+		}
 		selectedBlock = nullptr;
 
 		OnBlockDeselected();
@@ -404,15 +418,27 @@ void ATT_PlayerGridCamera::MouseTrace()
 	{
 		if (!isSelectButtonDown || isSettingBlockSize || isRemoveToolActive)
 		{
-			FHitResult Hit;
-			if (GetWorld()->GetFirstPlayerController()->GetHitResultUnderCursor(ECollisionChannel::ECC_Camera, true, Hit))
+			int hitTileID = -1;
+			bool hitBlock = false;
+			bool hitAnything = false;
+
+			if (useAnalyticPicking)
+			{
+				hitAnything = PickTileUnderCursor(hitTileID, hitBlock);
+			}
+			else
 			{
-				if (Hit.Actor == GridManager)
+				TraceTileUnderCursor(hitTileID, hitBlock, hitAnything);
+			}
+
+			if (hitAnything)
+			{
+				if (hitTileID != -1 && !hitBlock)
 				{
-					if (Hit.Item != currentLinetracedTile)
+					if (hitTileID != currentLinetracedTile)
 					{
 						// Hit a tile
-						currentLinetracedTile = Hit.Item;
+						currentLinetracedTile = hitTileID;
 						int unhoveredTile = lastLinetracedTile;
 						lastLinetracedTile = currentLinetracedTile;
 
@@ -426,9 +452,9 @@ void ATT_PlayerGridCamera::MouseTrace()
 
 				}
 
-				if (Hit.Actor->GetClass()->IsChildOf(ATT_Block::StaticClass()))
+				if (hitBlock)
 				{
-					currentLinetracedTile = Cast<ATT_Block>(Hit.Actor)->centralTileID;
+					currentLinetracedTile = hitTileID;
 					int unhoveredTile = lastLinetracedTile;
 					lastLinetracedTile = currentLinetracedTile;
 
@@ -446,12 +472,84 @@ void ATT_PlayerGridCamera::MouseTrace()
 			{
 				// No tile found
 				GridManager->TileClearState();
+				isZonePreviewShown = false;
 				currentLinetracedTile = -1;
 			}
 		}
 	}
 }
 
+bool ATT_PlayerGridCamera::PickTileUnderCursor(int& OutTileID, bool& OutHitBlock)
+{
+	OutTileID = -1;
+	OutHitBlock = false;
+
+	FVector cursorLocation;
+	FVector cursorDirection;
+	if (!GetWorld()->GetFirstPlayerController()->DeprojectMousePositionToWorld(cursorLocation, cursorDirection))
+	{
+		return false;
+	}
+
+	OutTileID = GridManager->GetTileIDFromRay(cursorLocation, cursorDirection);
+	if (OutTileID == -1)
+	{
+		return false;
+	}
+
+	// Blocks are found from the tiles they use rather than from their collision
+	if (pickBlocksFromOccupancy && GetBlockManager())
+	{
+		const FTT_BlockHandle blockOnTile = GetBlockManager()->GetBlockHandleOnTile(OutTileID);
+		if (GetBlockManager()->GetBlockStore().IsValid(blockOnTile))
+		{
+			OutTileID = GetBlockManager()->GetBlockStore().GetCentralTileID(blockOnTile);
+			OutHitBlock = true;
+		}
+	}
+	return true;
+}
+
+bool ATT_PlayerGridCamera::GetCursorGridCoordinate(FVector2D& OutCoordinate)
+{
+	FVector cursorLocation;
+	FVector cursorDirection;
+	FVector gridLocation;
+	if (!GetWorld()->GetFirstPlayerController()->DeprojectMousePositionToWorld(cursorLocation, cursorDirection)
+		|| !GridManager->GetRayGridIntersection(cursorLocation, cursorDirection, gridLocation))
+	{
+		return false;
+	}
+
+	OutCoordinate = GridManager->GetGridCoordinateFromLocation(gridLocation, true);
+	return true;
+}
+
+bool ATT_PlayerGridCamera::TraceTileUnderCursor(int& OutTileID, bool& OutHitBlock, bool& OutHitAnything)
+{
+	OutTileID = -1;
+	OutHitBlock = false;
+
+	FHitResult Hit;
+	OutHitAnything = GetWorld()->GetFirstPlayerController()->GetHitResultUnderCursor(ECollisionChannel::ECC_Camera, true, Hit);
+	if (!OutHitAnything)
+	{
+		return false;
+	}
+
+	// Tiles are split between chunk components, the hit instance index is local to its chunk
+	if (Hit.Actor == GridManager)
+	{
+		OutTileID = GridManager->GetTileIDFromInstance(Hit.GetComponent(), Hit.Item);
+	}
+	else if (Hit.Actor.IsValid() && Hit.Actor->GetClass()->IsChildOf(ATT_Block::StaticClass()))
+	{
+		OutTileID = Cast<ATT_Block>(Hit.Actor)->centralTileID;
+		OutHitBlock = true;
+	}
+	return OutTileID != -1;
+}
+
 
 /*---------- Build Tool / Building Blocks ----------*/
 
@@ -467,10 +565,16 @@ void ATT_PlayerGridCamera::StartBuildTool(int blockID)
 	}
 
 	// Placing block setting
+	const FTT_BlockRecord* placingBlockRecord = GridManager->BlockManager->GetBlockRecordFromBlockID(blockID);
+	if (!placingBlockRecord)
+	{
+		UE_LOG(LogTemp, Warning, TEXT("Cannot start the build tool, block %d isn't in the data table."), blockID);
+		return;
+	}
 	placingBlockID = blockID;
 	FTT_Struct_Block* placingBlockStats = GridManager->BlockManager->GetBlockStatsFromBlockID(placingBlockID);
-	isPlacingDownAResizableBlock = placingBlockStats->Block_Type == EBlockType::BT_Path || placingBlockStats->Block_Type == EBlockType::BT_Zone;
-	isPlacingDownAPath = placingBlockStats->Block_Type == EBlockType::BT_Path;
+	isPlacingDownAResizableBlock = placingBlockRecord->Type == EBlockType::BT_Path || placingBlockRecord->Type == EBlockType::BT_Zone;
+	isPlacingDownAPath = placingBlockRecord->Type == EBlockType::BT_Path;
 
 	FTransform blockTransform = FTransform(FRotator(0, 0, 0), FVector(0, 0, 0), FVector(1,1,1));
 	placingBlockTargetLocation = FVector(0, 0, 0);
@@ -493,12 +597,15 @@ void ATT_PlayerGridCamera::StartBuildTool(int blockID)
 
 void ATT_PlayerGridCamera::StopBuildTool()
 {
+	PathfinderComp->CancelPathRequest(pathPreviewRequest);
+
 	// Checks if the BuildTool should be reset instead of cancelled
 	if (isZoneBuildingCancelled && isSettingBlockSize)
 	{
 		isSettingBlockSize = false;
 		isMovementEnabled = true;
 		GridManager->TileClearState();
+		isZonePreviewShown = false;
 		return;
 	}
 
@@ -510,6 +617,7 @@ void ATT_PlayerGridCamera::StopBuildTool()
 		isPlacingDownAResizableBlock = false;
 		isZoneBuildingCancelled = false;
 		GridManager->TileClearState();
+		isZonePreviewShown = false;
 
 		currentBuildToolBlock->Destroy();
 		placingBlockID = -1;
@@ -541,6 +649,9 @@ void ATT_PlayerGridCamera::ConfirmBuildTool()
 
 	if (isPlacingDownAPath)
 	{
+		// The path to the last hovered tile may still be searched
+		PathfinderComp->CompletePathRequest(pathPreviewRequest);
+
 		GetBlockManager()->CreatePathOnTiles(placingLastZoneBuilt, placingBlockID);
 		GridManager->ClearPlayerSelection();
 
@@ -553,10 +664,10 @@ void ATT_PlayerGridCamera::ConfirmBuildTool()
 	// Block is a zone / is resizable
 	if (isPlacingDownAResizableBlock && !isPlacingDownAPath)
 	{
-		GridManager->BlockManager->CreateZoneOnTiles(placingLastZoneBuilt, placingBlockID);
+		GridManager->BlockManager->CreateZoneOnTiles(placingLastZoneRect, placingBlockID);
 		GridManager->ClearPlayerSelection();
 
-		for (int i : placingLastZoneBuilt)
+		for (int i : FTT_TileRectView(GridManager->GetGridTopology(), placingLastZoneRect))
 		{
 			GridManager->TileReset(i);
 		}
@@ -571,7 +682,8 @@ void ATT_PlayerGridCamera::TickBuildTool(float deltaTime)
 {
 	if (currentBuildToolBlock)
 	{
-		if (isPlacingDownAResizableBlock)
+		// While resizing, the preview layer holds the zone or path instead
+		if (isPlacingDownAResizableBlock && !isSettingBlockSize)
 		{
 			TArray<int> tempTiles;
 			tempTiles.Add(lastLinetracedTile);
@@ -598,26 +710,33 @@ void ATT_PlayerGridCamera::TickBuildTool(float deltaTime)
 					TArray<int> blocksToIgnore;
 					blocksToIgnore.Add(placingBlockID); 
 
-					placingLastZoneBuilt = PathfinderComp->FindShortestPathInZoneDijkstra(placingBlockTileID, lastLinetracedTile, GridManager->BlockManager->GetZoneTileIDsFromZoneParameters(placingBlockTileID, lastLinetracedTile, false), false, blocksToIgnore);
+					// Searched on a worker, the previous path stays on screen until this one is found. Short paths in the rect fall back to the whole grid.
+					FTT_PathQuery pathQuery;
+					pathQuery.StartTile = placingBlockTileID;
+					pathQuery.GoalTile = lastLinetracedTile;
+					pathQuery.Zone = GridManager->BlockManager->GetZoneRectFromZoneParameters(placingBlockTileID, lastLinetracedTile);
+					pathQuery.MinZonePathLength = 5;
 
-					if (placingLastZoneBuilt.Num() < 5)
-					{
-						placingLastZoneBuilt = PathfinderComp->FindShortestPathAStar(placingBlockTileID, lastLinetracedTile, false, blocksToIgnore);
-					}
+					PathfinderComp->CancelPathRequest(pathPreviewRequest);
+					pathPreviewRequest = PathfinderComp->RequestPathAsync(pathQuery, blocksToIgnore, FTT_OnPathFound::CreateUObject(this, &ATT_PlayerGridCamera::OnPathPreviewFound));
 
 					lastPathGoalTile = lastLinetracedTile;
 				}
+
+				// The path only changes when a request completes
+				if (!isZonePreviewShown)
+				{
 					GridManager->SetPlayerSelection(placingLastZoneBuilt);
 					GridManager->SetTileColorToBlockID(placingLastZoneBuilt, placingBlockID);
+					isZonePreviewShown = true;
+				}
 			}
 
 			else 
 			{
-				placingLastZoneBuilt = GridManager->BlockManager->GetZoneTileIDsFromZoneParameters(placingBlockTileID, lastLinetracedTile, false);
+				placingLastZoneRect = GridManager->BlockManager->GetZoneRectFromZoneParameters(placingBlockTileID, lastLinetracedTile);
 				//@TODO Remove the tiles that are being used already
-				GridManager->SetPlayerSelection(placingLastZoneBuilt);
-				GridManager->SetTileColorToBlockID(placingLastZoneBuilt, placingBlockID);
-
+				ShowZonePreview(placingLastZoneRect, placingBlockID);
 			}
 		}
 
@@ -681,8 +800,13 @@ void ATT_PlayerGridCamera::TickBuildTool(float deltaTime)
 
 		else
 		{
+			// Snap to the nearest tile that can hold the block, equally near tiles are chosen toward the cursor
+			const FTT_GridTopology& topology = GridManager->GetGridTopology();
+			FVector2D cursorCoordinate = topology.IsTileValid(lastLinetracedTile) ? FVector2D(topology.GetTileCoordinate(lastLinetracedTile)) + FVector2D(0.5f, 0.5f) : FVector2D::ZeroVector;
+			GetCursorGridCoordinate(cursorCoordinate);
+
 			int newBuildableTileID;
-			if (GridManager->BlockManager->GetNearestBuildableTileID(newBuildableTileID, lastLinetracedTile, currentBuildToolBlock->GetBlockStats()->Size_X, currentBuildToolBlock->GetBlockStats()->Size_Y, isModuloHalfPi))
+			if (GridManager->BlockManager->GetNearestBuildableTileID(newBuildableTileID, lastLinetracedTile, currentBuildToolBlock->GetBlockStats()->Size_X, currentBuildToolBlock->GetBlockStats()->Size_Y, isModuloHalfPi, buildToolSnapRadius, cursorCoordinate))
 			{
 				if (newBuildableTileID != -1)
 				{
@@ -705,11 +829,38 @@ void ATT_PlayerGridCamera::TickBuildTool(float deltaTime)
 	}
 }
 
+void ATT_PlayerGridCamera::OnPathPreviewFound(const TArray<int32>& path)
+{
+	pathPreviewRequest.Invalidate();
+	placingLastZoneBuilt = path;
+	isZonePreviewShown = false;
+}
+
+void ATT_PlayerGridCamera::ShowZonePreview(const FTT_TileRect& zoneRect, int blockID)
+{
+	// A still cursor keeps the same rect, the overlays have nothing to do
+	if (isZonePreviewShown && zoneRect == shownZonePreviewRect)
+	{
+		return;
+	}
+
+	GridManager->SetPlayerSelection(zoneRect);
+	GridManager->SetTileRectColorToBlockID(zoneRect, blockID);
+
+	shownZonePreviewRect = zoneRect;
+	isZonePreviewShown = true;
+}
+
 void ATT_PlayerGridCamera::ConfirmBuildToolStartTile()
 {
 	// The tile the block is being stretched from
 	placingBlockTileID = lastLinetracedTile;
 
+	// Paths are found a few frames after being requested, the one of a previous drag mustn't show meanwhile
+	placingLastZoneBuilt.Reset();
+	lastPathGoalTile = -1;
+	isZonePreviewShown = false;
+
 	isSettingBlockSize = true;
 	isMovementEnabled = false;
 }
@@ -731,6 +882,7 @@ void ATT_PlayerGridCamera::StopRemoveTool()
 	isRemoveToolSelecting = false;
 	isRemoveToolActive = false;
 	isMovementEnabled = true;
+	isZonePreviewShown = false;
 	GridManager->TileReset(lastLinetracedTile);
 	GetWorldTimerManager().ClearTimer(TimerHandle_RemoveTool);
 }
@@ -739,9 +891,8 @@ void ATT_PlayerGridCamera::TickRemoveTool()
 {
 	if (isRemoveToolSelecting)
 	{
-		tilesToBeRemoved = GridManager->BlockManager->GetZoneTileIDsFromZoneParameters(placingBlockTileID, lastLinetracedTile, false);
-		GridManager->SetPlayerSelection(tilesToBeRemoved);
-		GridManager->SetTileColorToBlockID(tilesToBeRemoved, -1);
+		tilesToBeRemoved = GridManager->BlockManager->GetZoneRectFromZoneParameters(placingBlockTileID, lastLinetracedTile);
+		ShowZonePreview(tilesToBeRemoved, -1);
 		return;
 	}
 	
@@ -754,6 +905,7 @@ void ATT_PlayerGridCamera::ConfirmRemoveToolStartTile()
 {
 	isRemoveToolSelecting = true;
 	isMovementEnabled = false;
+	isZonePreviewShown = false;
 	placingBlockTileID = lastLinetracedTile;
 }
 
@@ -762,11 +914,11 @@ void ATT_PlayerGridCamera::ConfirmRemoveToolEndTile()
 	StopRemoveTool();
 	GridManager->ClearPlayerSelection();
 
-	for (auto i : tilesToBeRemoved)
+	for (int i : FTT_TileRectView(GridManager->GetGridTopology(), tilesToBeRemoved))
 	{
 		DeleteBlockOnTile(i);
 	}
-	tilesToBeRemoved.Empty();
+	tilesToBeRemoved = FTT_TileRect();
 
 }
 
@@ -776,6 +928,7 @@ void ATT_PlayerGridCamera::DeleteBlockOnTile(int tileID)
 	{
 		GridManager->BlockManager->DeleteBlockOnTile(tileID);
 		GridManager->TileClearState();
+		isZonePreviewShown = false;
 		currentLinetracedTile = -1;
 	}
 }
@@ -0,0 +1,234 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_TileOverlay.h"
+#include "TT_GridQuery.h"
+
+/*---------- Overlay layer ----------*/
+
+void FTT_TileOverlayLayer::Init(const FTT_GridTopology& topology)
+{
+	Members.Init(topology, false);
+	Values.Empty();
+	MarkRect(FTT_TileRect(), FTT_TileOverlayValue());
+}
+
+bool FTT_TileOverlayLayer::Set(int32 tileID, const FTT_TileOverlayValue& value)
+{
+	if (Members[tileID])
+	{
+		FTT_TileOverlayValue& currentValue = Values.FindChecked(tileID);
+		if (currentValue == value)
+		{
+			return false;
+		}
+		currentValue = value;
+		bIsRect = false;
+		return true;
+	}
+
+	Members.Set(tileID, true);
+	Values.Add(tileID, value);
+	bIsRect = false;
+	return true;
+}
+
+bool FTT_TileOverlayLayer::Remove(int32 tileID)
+{
+	if (!Members[tileID])
+	{
+		return false;
+	}
+
+	Members.Reset(tileID);
+	Values.Remove(tileID);
+	bIsRect = false;
+	return true;
+}
+
+void FTT_TileOverlayLayer::Clear()
+{
+	for (const TPair<int32, FTT_TileOverlayValue>& tile : Values)
+	{
+		Members.Reset(tile.Key);
+	}
+	Values.Reset();
+	MarkRect(FTT_TileRect(), FTT_TileOverlayValue());
+}
+
+void FTT_TileOverlayLayer::MarkRect(const FTT_TileRect& rect, const FTT_TileOverlayValue& value)
+{
+	Rect = rect;
+	RectValue = value;
+	bIsRect = true;
+}
+
+
+/*---------- Compositor ----------*/
+
+void FTT_TileOverlayCompositor::Init(const FTT_GridTopology& topology)
+{
+	Topology = topology;
+	NumTiles = topology.GetNumTiles();
+
+	for (FTT_TileOverlayLayer& layer : Layers)
+	{
+		layer.Init(topology);
+	}
+
+	DirtyTiles.Empty();
+	ScratchTiles.Empty();
+	ScratchTilesLeaving.Empty();
+}
+
+void FTT_TileOverlayCompositor::SetTile(ETileOverlay layer, int32 tileID, const FTT_TileOverlayValue& value)
+{
+	if (IsTileValid(tileID) && Layers[int32(layer)].Set(tileID, value))
+	{
+		MarkTileDirty(tileID);
+	}
+}
+
+void FTT_TileOverlayCompositor::RemoveTile(ETileOverlay layer, int32 tileID)
+{
+	if (IsTileValid(tileID) && Layers[int32(layer)].Remove(tileID))
+	{
+		MarkTileDirty(tileID);
+	}
+}
+
+void FTT_TileOverlayCompositor::ResetTile(int32 tileID)
+{
+	for (int32 layer = int32(ETileOverlay::TO_ViewMode) + 1; layer < int32(ETileOverlay::TO_Count); layer++)
+	{
+		RemoveTile(ETileOverlay(layer), tileID);
+	}
+}
+
+void FTT_TileOverlayCompositor::SetLayerTiles(ETileOverlay layer, const FTT_TileRect& tileRect, const FTT_TileOverlayValue& value)
+{
+	FTT_TileOverlayLayer& overlayLayer = Layers[int32(layer)];
+	const FTT_TileRect newRect = tileRect.IsEmpty() ? FTT_TileRect() : tileRect.GetIntersection(FTT_TileRect(FIntPoint(0, 0), FIntPoint(Topology.SizeX, Topology.SizeY)));
+
+	if (!overlayLayer.IsRect())
+	{
+		// The layer was changed tile by tile, every tile it holds has to be compared
+		SetLayerTiles(layer, FTT_TileRectView(Topology, newRect), value);
+	}
+	else
+	{
+		const FTT_TileRect oldRect = overlayLayer.GetRect();
+
+		// Tiles shared by both rectangles keep their value, unless it changed
+		const FTT_TileRect keptRect = overlayLayer.GetRectValue() == value ? oldRect : FTT_TileRect();
+
+		ForEachTileOutside(oldRect, newRect, [&](int32 tileID)
+		{
+			overlayLayer.Remove(tileID);
+			MarkTileDirty(tileID);
+		});
+
+		ForEachTileOutside(newRect, keptRect, [&](int32 tileID)
+		{
+			if (overlayLayer.Set(tileID, value))
+			{
+				MarkTileDirty(tileID);
+			}
+		});
+	}
+	overlayLayer.MarkRect(newRect, value);
+}
+
+void FTT_TileOverlayCompositor::ClearLayer(ETileOverlay layer)
+{
+	FTT_TileOverlayLayer& overlayLayer = Layers[int32(layer)];
+	if (overlayLayer.Num() == 0)
+	{
+		return;
+	}
+
+	for (const TPair<int32, FTT_TileOverlayValue>& tile : overlayLayer.GetValues())
+	{
+		MarkTileDirty(tile.Key);
+	}
+	overlayLayer.Clear();
+}
+
+bool FTT_TileOverlayCompositor::IsTileInLayer(ETileOverlay layer, int32 tileID) const
+{
+	return IsTileValid(tileID) && Layers[int32(layer)].Contains(tileID);
+}
+
+const FTT_TileOverlayValue* FTT_TileOverlayCompositor::FindTile(ETileOverlay layer, int32 tileID) const
+{
+	return IsTileValid(tileID) ? Layers[int32(layer)].Find(tileID) : nullptr;
+}
+
+TArray<int> FTT_TileOverlayCompositor::GetLayerTiles(ETileOverlay layer) const
+{
+	TArray<int> tileIDs;
+	Layers[int32(layer)].GetValues().GenerateKeyArray(tileIDs);
+	return tileIDs;
+}
+
+void FTT_TileOverlayCompositor::Flush(FTT_TileVisualBuffer& visualBuffer)
+{
+	for (int32 tileID : DirtyTiles)
+	{
+		visualBuffer.SetVisual(tileID, CompositeTile(tileID));
+	}
+	DirtyTiles.Reset();
+}
+
+void FTT_TileOverlayCompositor::ForEachTileOutside(const FTT_TileRect& rect, const FTT_TileRect& excludedRect, TFunctionRef<void(int32)> visitor) const
+{
+	const FTT_TileRect intersection = rect.GetIntersection(excludedRect);
+	if (intersection.IsEmpty())
+	{
+		for (int32 tileID : FTT_TileRectView(Topology, rect))
+		{
+			visitor(tileID);
+		}
+		return;
+	}
+
+	// Rows below and above the intersection, then the columns on its left and right (empty strips have a size <= 0)
+	const FIntPoint rectEnd = rect.Min + rect.Size;
+	const FIntPoint intersectionEnd = intersection.Min + intersection.Size;
+	const FTT_TileRect strips[4] =
+	{
+		FTT_TileRect(rect.Min, FIntPoint(rect.Size.X, intersection.Min.Y - rect.Min.Y)),
+		FTT_TileRect(FIntPoint(rect.Min.X, intersectionEnd.Y), FIntPoint(rect.Size.X, rectEnd.Y - intersectionEnd.Y)),
+		FTT_TileRect(FIntPoint(rect.Min.X, intersection.Min.Y), FIntPoint(intersection.Min.X - rect.Min.X, intersection.Size.Y)),
+		FTT_TileRect(FIntPoint(intersectionEnd.X, intersection.Min.Y), FIntPoint(rectEnd.X - intersectionEnd.X, intersection.Size.Y))
+	};
+
+	for (const FTT_TileRect& strip : strips)
+	{
+		for (int32 tileID : FTT_TileRectView(Topology, strip))
+		{
+			visitor(tileID);
+		}
+	}
+}
+
+FTT_TileVisual FTT_TileOverlayCompositor::CompositeTile(int32 tileID) const
+{
+	// Layers are applied from the lowest priority to the highest
+	FTT_TileVisual visual;
+
+	for (const FTT_TileOverlayLayer& layer : Layers)
+	{
+		if (const FTT_TileOverlayValue* value = layer.Find(tileID))
+		{
+			if (value->bOverridesColour)
+			{
+				visual.Colour = value->Colour;
+			}
+			if (value->bOverridesScale)
+			{
+				visual.Scale = value->Scale;
+			}
+		}
+	}
+	return visual;
+}
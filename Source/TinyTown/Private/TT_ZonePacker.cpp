@@ -0,0 +1,147 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "TT_ZonePacker.h"
+
+void FTT_ZonePacker::Init(const FIntPoint& zoneSize)
+{
+	ZoneSize = FIntPoint(FMath::Max(zoneSize.X, 0), FMath::Max(zoneSize.Y, 0));
+	FreeRuns.SetNumUninitialized(ZoneSize.X * ZoneSize.Y);
+
+	for (int32 row = 0; row < ZoneSize.Y; row++)
+	{
+		for (int32 column = 0; column < ZoneSize.X; column++)
+		{
+			FreeRuns[GetIndex(column, row)] = ZoneSize.X - column;
+		}
+	}
+}
+
+void FTT_ZonePacker::BlockTile(const FIntPoint& tile)
+{
+	if (IsTileFree(tile))
+	{
+		FreeRuns[GetIndex(tile.X, tile.Y)] = 0;
+		UpdateFreeRuns(tile.Y, tile.X - 1);
+	}
+}
+
+bool FTT_ZonePacker::IsTileFree(const FIntPoint& tile) const
+{
+	return tile.X >= 0 && tile.X < ZoneSize.X && tile.Y >= 0 && tile.Y < ZoneSize.Y && FreeRuns[GetIndex(tile.X, tile.Y)] > 0;
+}
+
+void FTT_ZonePacker::Pack(const TArray<FIntPoint>& sizes, EZonePackingPreference preference, TArray<FTT_ZonePlacement>& OutPlacements)
+{
+	// Order in which the sizes are tried, ties are broken by X, then Y, then index to stay deterministic
+	TArray<int32> sizeOrder;
+	for (int32 sizeIndex = 0; sizeIndex < sizes.Num(); sizeIndex++)
+	{
+		if (sizes[sizeIndex].X > 0 && sizes[sizeIndex].Y > 0)
+		{
+			sizeOrder.Add(sizeIndex);
+		}
+	}
+
+	sizeOrder.Sort([&sizes, preference](int32 indexA, int32 indexB)
+	{
+		const FIntPoint& sizeA = sizes[indexA];
+		const FIntPoint& sizeB = sizes[indexB];
+		const int32 areaA = sizeA.X * sizeA.Y;
+		const int32 areaB = sizeB.X * sizeB.Y;
+
+		if (areaA != areaB)
+		{
+			return preference == EZonePackingPreference::ZP_SmallestFirst ? areaA < areaB : areaA > areaB;
+		}
+		if (sizeA.X != sizeB.X)
+		{
+			return sizeA.X > sizeB.X;
+		}
+		if (sizeA.Y != sizeB.Y)
+		{
+			return sizeA.Y > sizeB.Y;
+		}
+		return indexA < indexB;
+	});
+
+	if (sizeOrder.Num() == 0)
+	{
+		return;
+	}
+
+	for (int32 row = 0; row < ZoneSize.Y; row++)
+	{
+		int32 column = 0;
+		while (column < ZoneSize.X)
+		{
+			const int32 freeRun = FreeRuns[GetIndex(column, row)];
+			if (freeRun == 0)
+			{
+				column++;
+				continue;
+			}
+
+			bool isPlaced = false;
+			for (int32 sizeIndex : sizeOrder)
+			{
+				const FIntPoint& size = sizes[sizeIndex];
+				if (size.X <= freeRun && DoesSizeFit(column, row, size))
+				{
+					BlockRect(column, row, size);
+					OutPlacements.Add(FTT_ZonePlacement{ FIntPoint(column, row), sizeIndex });
+					column += size.X;
+					isPlaced = true;
+					break;
+				}
+			}
+
+			if (!isPlaced)
+			{
+				column++;
+			}
+		}
+	}
+}
+
+bool FTT_ZonePacker::DoesSizeFit(int32 column, int32 row, const FIntPoint& size) const
+{
+	if (row + size.Y > ZoneSize.Y)
+	{
+		return false;
+	}
+
+	for (int32 sizeRow = row; sizeRow < row + size.Y; sizeRow++)
+	{
+		if (FreeRuns[GetIndex(column, sizeRow)] < size.X)
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void FTT_ZonePacker::BlockRect(int32 column, int32 row, const FIntPoint& size)
+{
+	for (int32 sizeRow = row; sizeRow < row + size.Y; sizeRow++)
+	{
+		for (int32 sizeColumn = column; sizeColumn < column + size.X; sizeColumn++)
+		{
+			FreeRuns[GetIndex(sizeColumn, sizeRow)] = 0;
+		}
+		UpdateFreeRuns(sizeRow, column - 1);
+	}
+}
+
+void FTT_ZonePacker::UpdateFreeRuns(int32 row, int32 fromColumn)
+{
+	// Only the free tiles directly before the newly used one see their run shortened
+	for (int32 column = fromColumn; column >= 0; column--)
+	{
+		const int32 index = GetIndex(column, row);
+		if (FreeRuns[index] == 0)
+		{
+			break;
+		}
+		FreeRuns[index] = (column + 1 < ZoneSize.X) ? FreeRuns[index + 1] + 1 : 1;
+	}
+}
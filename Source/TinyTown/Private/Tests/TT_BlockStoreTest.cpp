@@ -0,0 +1,100 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "TT_BlockStore.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTT_BlockStoreHandleTest, "TinyTown.BlockStore.Handles", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTT_BlockStoreHandleTest::RunTest(const FString& Parameters)
+{
+	FTT_BlockStore blockStore;
+
+	TestFalse(TEXT("An unset handle is never valid"), blockStore.IsValid(FTT_BlockHandle()));
+
+	const FTT_BlockHandle handleA = blockStore.Add(1, 10, 0.f, FTT_TileRect(FIntPoint(0, 0), FIntPoint(1, 1)));
+	const FTT_BlockHandle handleB = blockStore.Add(2, 20, 90.f, FTT_TileRect(FIntPoint(5, 5), FIntPoint(2, 2)));
+	const FTT_BlockHandle handleC = blockStore.Add(3, 30, 180.f, FTT_TileRect(FIntPoint(9, 9), FIntPoint(3, 1)));
+
+	TestTrue(TEXT("Added blocks are valid"), blockStore.IsValid(handleA) && blockStore.IsValid(handleB) && blockStore.IsValid(handleC));
+	TestEqual(TEXT("Block count"), blockStore.Num(), 3);
+
+	// Removing A swaps C into its place in the dense arrays, C's handle must still find its own values
+	TestTrue(TEXT("Removing a valid block"), blockStore.Remove(handleA));
+	TestFalse(TEXT("A removed block's handle is stale"), blockStore.IsValid(handleA));
+	TestFalse(TEXT("Removing a stale handle"), blockStore.Remove(handleA));
+	TestEqual(TEXT("Swapped block keeps its block ID"), blockStore.GetBlockID(handleC), 3);
+	TestEqual(TEXT("Swapped block keeps its central tile"), blockStore.GetCentralTileID(handleC), 30);
+	TestEqual(TEXT("Other block keeps its block ID"), blockStore.GetBlockID(handleB), 2);
+	TestEqual(TEXT("Stale handles read the default values"), blockStore.GetCentralTileID(handleA), -1);
+
+	// The freed slot is reused with another generation
+	const FTT_BlockHandle handleD = blockStore.Add(4, 40, 0.f, FTT_TileRect());
+	TestEqual(TEXT("Freed slot is reused"), handleD.GetSlotIndex(), handleA.GetSlotIndex());
+	TestTrue(TEXT("Reused slot gets a new generation"), handleD != handleA);
+	TestFalse(TEXT("The old handle stays stale once its slot is reused"), blockStore.IsValid(handleA));
+	TestTrue(TEXT("The new handle is valid"), blockStore.IsValid(handleD));
+
+	// Reset makes every handle stale
+	blockStore.Reset();
+	TestEqual(TEXT("Reset empties the store"), blockStore.Num(), 0);
+	TestFalse(TEXT("Handles are stale after a reset"), blockStore.IsValid(handleB) || blockStore.IsValid(handleC) || blockStore.IsValid(handleD));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTT_BlockStoreGenerationTest, "TinyTown.BlockStore.GenerationWrap", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTT_BlockStoreGenerationTest::RunTest(const FString& Parameters)
+{
+	FTT_BlockStore blockStore;
+
+	// Cycles one slot through more blocks than its generation can count, every handle it gave must stay stale
+	TArray<FTT_BlockHandle> slotHandles;
+	const int32 numCycles = 2 * MAX_uint8;
+	for (int32 cycle = 0; cycle < numCycles; cycle++)
+	{
+		const FTT_BlockHandle handle = blockStore.Add(cycle, 0, 0.f, FTT_TileRect());
+
+		// A wrapped generation gives out a handle equal to a stale one, which then refers to the new block
+		if (slotHandles.Contains(handle))
+		{
+			AddError(FString::Printf(TEXT("Handle of generation %d given out twice at cycle %d"), handle.GetGeneration(), cycle));
+			return false;
+		}
+
+		if (handle.GetSlotIndex() == 0)
+		{
+			slotHandles.Add(handle);
+		}
+
+		for (const FTT_BlockHandle& slotHandle : slotHandles)
+		{
+			if (slotHandle != handle && blockStore.IsValid(slotHandle))
+			{
+				AddError(FString::Printf(TEXT("Stale handle of generation %d became valid again at cycle %d"), slotHandle.GetGeneration(), cycle));
+				return false;
+			}
+		}
+
+		TestTrue(TEXT("The new block is valid"), blockStore.IsValid(handle));
+		blockStore.Remove(handle);
+	}
+
+	TestEqual(TEXT("A slot gives out every generation but 0 & the retired one"), slotHandles.Num(), int32(FTT_BlockStore::GetRetiredGeneration()) - 1);
+
+	for (const FTT_BlockHandle& slotHandle : slotHandles)
+	{
+		TestTrue(TEXT("No handle uses the retired generation"), slotHandle.GetGeneration() != FTT_BlockStore::GetRetiredGeneration());
+	}
+
+	// Retired slots stay retired after a reset
+	blockStore.Reset();
+	const FTT_BlockHandle handleAfterReset = blockStore.Add(0, 0, 0.f, FTT_TileRect());
+	TestTrue(TEXT("A retired slot isn't reused after a reset"), handleAfterReset.GetSlotIndex() != 0);
+
+	return true;
+}
+
+#endif
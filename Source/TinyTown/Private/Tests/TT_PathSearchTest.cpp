@@ -0,0 +1,268 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "TT_PathSearch.h"
+#include "TT_JumpPointSearch.h"
+#include "TT_HierarchicalPathSearch.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TT_PathSearchTest
+{
+	/**
+	* Returns the cost of a path (from goal to start) with FTT_AStarSearch's move costs, -1 if it isn't a path of the grid:
+	* two of its tiles aren't neighbours, a tile other than the start isn't walkable, or a diagonal move cuts a corner (unless allowed).
+	*/
+	int32 GetPathCost(const FTT_GridTopology& topology, const TArray<int32>& path, bool allowDiagonalPaths, bool allowCornerCutting, const TArray<bool>& walkableTiles)
+	{
+		int32 cost = 0;
+		for (int32 pathIndex = 0; pathIndex + 1 < path.Num(); pathIndex++)
+		{
+			if (!walkableTiles[path[pathIndex]])
+			{
+				return -1;
+			}
+
+			const FIntPoint from = topology.GetTileCoordinate(path[pathIndex + 1]);
+			const FIntPoint delta = topology.GetTileCoordinate(path[pathIndex]) - from;
+			if (FMath::Abs(delta.X) > 1 || FMath::Abs(delta.Y) > 1 || delta == FIntPoint::ZeroValue)
+			{
+				return -1;
+			}
+
+			if (delta.X != 0 && delta.Y != 0)
+			{
+				const bool isCornerFree = walkableTiles[topology.GetTileID(from + FIntPoint(delta.X, 0))] && walkableTiles[topology.GetTileID(from + FIntPoint(0, delta.Y))];
+				if (!allowDiagonalPaths || (!isCornerFree && !allowCornerCutting))
+				{
+					return -1;
+				}
+				cost += FTT_AStarSearch::GetDiagonalCost();
+			}
+			else
+			{
+				cost += FTT_AStarSearch::GetStraightCost();
+			}
+		}
+		return cost;
+	}
+
+	/** Fills a grid with scattered walls and a few blocks of unwalkable tiles, like roads & buildings. */
+	void MakeGrid(FRandomStream& randomStream, const FTT_GridTopology& topology, int32 wallPercentage, TArray<bool>& OutWalkableTiles)
+	{
+		OutWalkableTiles.Init(true, topology.GetNumTiles());
+		for (int32 tileID = 0; tileID < topology.GetNumTiles(); tileID++)
+		{
+			OutWalkableTiles[tileID] = randomStream.RandRange(0, 99) >= wallPercentage;
+		}
+
+		for (int32 blockIndex = 0; blockIndex < 20; blockIndex++)
+		{
+			const FTT_TileRect blockRect(FIntPoint(randomStream.RandRange(0, topology.SizeX - 1), randomStream.RandRange(0, topology.SizeY - 1)),
+				FIntPoint(randomStream.RandRange(1, 20), randomStream.RandRange(1, 20)));
+			for (int32 row = blockRect.Min.Y; row <= FMath::Min(blockRect.GetMax().Y, topology.SizeY - 1); row++)
+			{
+				for (int32 column = blockRect.Min.X; column <= FMath::Min(blockRect.GetMax().X, topology.SizeX - 1); column++)
+				{
+					OutWalkableTiles[topology.GetTileID(FIntPoint(column, row))] = false;
+				}
+			}
+		}
+	}
+
+	int32 GetRandomWalkableTile(FRandomStream& randomStream, const TArray<bool>& walkableTiles)
+	{
+		int32 tileID;
+		do
+		{
+			tileID = randomStream.RandRange(0, walkableTiles.Num() - 1);
+		} while (!walkableTiles[tileID]);
+		return tileID;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTT_PathSearchCostTest, "TinyTown.PathSearch.CostEquivalence", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTT_PathSearchCostTest::RunTest(const FString& Parameters)
+{
+	using namespace TT_PathSearchTest;
+
+	FRandomStream randomStream(1234);
+	FTT_AStarSearch aStarSearch;
+	FTT_ZoneDijkstraSearch zoneDijkstraSearch;
+	FTT_JumpPointSearch jumpPointSearch;
+	FTT_HierarchicalPathSearch hierarchicalSearch;
+
+	// Sizes that aren't multiples of the chunk size, so the last chunks are partial
+	const FIntPoint gridSizes[3] = { FIntPoint(150, 130), FIntPoint(200, 70), FIntPoint(64, 64) };
+	const int32 wallPercentages[3] = { 0, 10, 25 };
+
+	for (int32 gridIndex = 0; gridIndex < 3; gridIndex++)
+	{
+		for (int32 neighbourhood = 0; neighbourhood < 2; neighbourhood++)
+		{
+			const bool allowDiagonalPaths = neighbourhood == 1;
+			const FTT_GridTopology topology(gridSizes[gridIndex].X, gridSizes[gridIndex].Y);
+			const FTT_TileRect grid(FIntPoint(0, 0), FIntPoint(topology.SizeX, topology.SizeY));
+
+			TArray<bool> walkableTiles;
+			MakeGrid(randomStream, topology, wallPercentages[gridIndex], walkableTiles);
+			auto isTileWalkable = [&walkableTiles](int32 tileID) { return walkableTiles[tileID]; };
+
+			FTT_JumpPointMap jumpPointMap;
+			jumpPointMap.Init(topology, allowDiagonalPaths);
+			FTT_HierarchicalPathMap hierarchicalMap;
+			hierarchicalMap.Init(topology, allowDiagonalPaths);
+
+			// Second pass on the same maps after changing tiles, to check what they rebuild
+			for (int32 pass = 0; pass < 2; pass++)
+			{
+				if (pass == 1)
+				{
+					for (int32 changeIndex = 0; changeIndex < 6; changeIndex++)
+					{
+						const FTT_TileRect changedRect(FIntPoint(randomStream.RandRange(0, topology.SizeX - 1), randomStream.RandRange(0, topology.SizeY - 1)),
+							FIntPoint(randomStream.RandRange(1, 8), randomStream.RandRange(1, 8)));
+						const bool isWalkable = randomStream.RandRange(0, 1) == 1;
+						for (int32 row = changedRect.Min.Y; row <= FMath::Min(changedRect.GetMax().Y, topology.SizeY - 1); row++)
+						{
+							for (int32 column = changedRect.Min.X; column <= FMath::Min(changedRect.GetMax().X, topology.SizeX - 1); column++)
+							{
+								walkableTiles[topology.GetTileID(FIntPoint(column, row))] = isWalkable;
+							}
+						}
+						jumpPointMap.Invalidate(changedRect);
+						hierarchicalMap.Invalidate(changedRect);
+					}
+				}
+
+				jumpPointMap.Update(isTileWalkable);
+				hierarchicalMap.Update(isTileWalkable);
+
+				for (int32 queryIndex = 0; queryIndex < 40; queryIndex++)
+				{
+					const int32 startTile = GetRandomWalkableTile(randomStream, walkableTiles);
+					const int32 goalTile = GetRandomWalkableTile(randomStream, walkableTiles);
+					if (startTile == goalTile)
+					{
+						continue;
+					}
+
+					TArray<int32> aStarPath;
+					TArray<int32> jumpPointPath;
+					TArray<int32> hierarchicalPath;
+					TArray<int32> dijkstraPath;
+					const bool isAStarPathFound = aStarSearch.FindPath(topology, startTile, goalTile, allowDiagonalPaths, isTileWalkable, aStarPath);
+					const bool isJumpPointPathFound = jumpPointSearch.FindPath(jumpPointMap, startTile, goalTile, isTileWalkable, jumpPointPath);
+					const bool isHierarchicalPathFound = hierarchicalSearch.FindPath(hierarchicalMap, startTile, goalTile, hierarchicalPath);
+					const bool isDijkstraPathFound = zoneDijkstraSearch.FindPath(topology, grid, grid.Min, nullptr, startTile, goalTile, allowDiagonalPaths,
+						topology.GetNumTiles(), isTileWalkable, dijkstraPath);
+
+					const FString query = FString::Printf(TEXT("grid %dx%d, diagonals %d, pass %d, %d -> %d"), topology.SizeX, topology.SizeY, int32(allowDiagonalPaths), pass, startTile, goalTile);
+
+					if (isJumpPointPathFound != isAStarPathFound || isHierarchicalPathFound != isAStarPathFound || isDijkstraPathFound != isAStarPathFound)
+					{
+						// The zone Dijkstra cuts corners, it can reach goals the other searches can't
+						if (!(allowDiagonalPaths && isDijkstraPathFound && isJumpPointPathFound == isAStarPathFound && isHierarchicalPathFound == isAStarPathFound))
+						{
+							AddError(FString::Printf(TEXT("Searches disagree on whether a path exists (%s)"), *query));
+						}
+						continue;
+					}
+
+					if (!isAStarPathFound)
+					{
+						continue;
+					}
+
+					const int32 aStarCost = GetPathCost(topology, aStarPath, allowDiagonalPaths, false, walkableTiles);
+					const int32 jumpPointCost = GetPathCost(topology, jumpPointPath, allowDiagonalPaths, false, walkableTiles);
+					const int32 hierarchicalCost = GetPathCost(topology, hierarchicalPath, allowDiagonalPaths, false, walkableTiles);
+					const int32 dijkstraCost = GetPathCost(topology, dijkstraPath, allowDiagonalPaths, true, walkableTiles);
+
+					if (aStarCost < 0 || jumpPointCost < 0 || hierarchicalCost < 0 || dijkstraCost < 0)
+					{
+						AddError(FString::Printf(TEXT("A search returned tiles that aren't a path of the grid (%s)"), *query));
+						continue;
+					}
+
+					const bool areEndsRight = aStarPath[0] == goalTile && aStarPath.Last() == startTile && jumpPointPath[0] == goalTile && jumpPointPath.Last() == startTile
+						&& hierarchicalPath[0] == goalTile && hierarchicalPath.Last() == startTile && dijkstraPath[0] == goalTile && dijkstraPath.Last() == startTile;
+					if (!areEndsRight)
+					{
+						AddError(FString::Printf(TEXT("A path doesn't go from the goal to the start (%s)"), *query));
+					}
+
+					if (jumpPointCost != aStarCost)
+					{
+						AddError(FString::Printf(TEXT("Jump point search cost %d, A* cost %d (%s)"), jumpPointCost, aStarCost, *query));
+					}
+
+					if (hierarchicalCost < aStarCost)
+					{
+						AddError(FString::Printf(TEXT("Hierarchical search cost %d is below the shortest path's %d (%s)"), hierarchicalCost, aStarCost, *query));
+					}
+
+					// Every move of the zone Dijkstra costs the same: as few moves as A* without diagonals, no more with them (it can cut corners)
+					const int32 dijkstraMoves = dijkstraPath.Num() - 1;
+					const int32 aStarMoves = aStarPath.Num() - 1;
+					if (allowDiagonalPaths ? dijkstraMoves > aStarMoves : dijkstraMoves * FTT_AStarSearch::GetStraightCost() != aStarCost)
+					{
+						AddError(FString::Printf(TEXT("Zone Dijkstra made %d moves, A* %d (%s)"), dijkstraMoves, aStarMoves, *query));
+					}
+				}
+			}
+		}
+	}
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTT_JumpPointOpenLandTest, "TinyTown.PathSearch.JumpPointOpenLand", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTT_JumpPointOpenLandTest::RunTest(const FString& Parameters)
+{
+	using namespace TT_PathSearchTest;
+
+	// Open land over 5 by 5 chunks: jumps must carry on through the chunk edges instead of stopping on them
+	const FTT_GridTopology topology(300, 300);
+	TArray<bool> walkableTiles;
+	walkableTiles.Init(true, topology.GetNumTiles());
+	auto isTileWalkable = [&walkableTiles](int32 tileID) { return walkableTiles[tileID]; };
+
+	const int32 startTile = topology.GetTileID(FIntPoint(2, 3));
+	const int32 goalTiles[3] = { topology.GetTileID(FIntPoint(297, 296)), topology.GetTileID(FIntPoint(290, 120)), topology.GetTileID(FIntPoint(10, 299)) };
+
+	for (int32 neighbourhood = 0; neighbourhood < 2; neighbourhood++)
+	{
+		const bool allowDiagonalPaths = neighbourhood == 1;
+		FTT_JumpPointMap jumpPointMap;
+		jumpPointMap.Init(topology, allowDiagonalPaths);
+		jumpPointMap.Update(isTileWalkable);
+
+		for (int32 goalTile : goalTiles)
+		{
+			FTT_AStarSearch aStarSearch;
+			FTT_JumpPointSearch jumpPointSearch;
+			TArray<int32> aStarPath;
+			TArray<int32> jumpPointPath;
+			aStarSearch.FindPath(topology, startTile, goalTile, allowDiagonalPaths, isTileWalkable, aStarPath);
+			jumpPointSearch.FindPath(jumpPointMap, startTile, goalTile, isTileWalkable, jumpPointPath);
+
+			TestEqual(TEXT("Jump point search costs the same as A* on open land"), GetPathCost(topology, jumpPointPath, allowDiagonalPaths, false, walkableTiles),
+				GetPathCost(topology, aStarPath, allowDiagonalPaths, false, walkableTiles));
+
+			// Jumps only stop on the chunk edges they cross (a couple per edge), a search stopping after one tile opens one per tile on the way
+			const int32 maxExpandedTiles = 2 + 2 * topology.GetNumChunksX();
+			if (jumpPointSearch.GetNumExpandedTiles() > maxExpandedTiles)
+			{
+				AddError(FString::Printf(TEXT("Jump point search expanded %d tiles to reach %d on open land (diagonals %d), at most %d expected"),
+					jumpPointSearch.GetNumExpandedTiles(), goalTile, int32(allowDiagonalPaths), maxExpandedTiles));
+			}
+		}
+	}
+
+	return true;
+}
+
+#endif
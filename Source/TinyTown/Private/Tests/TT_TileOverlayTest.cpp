@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "TT_TileOverlay.h"
+#include "TT_GridQuery.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTT_TileOverlayCompositingTest, "TinyTown.TileOverlay.Compositing", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTT_TileOverlayCompositingTest::RunTest(const FString& Parameters)
+{
+	const FTT_GridTopology topology(100, 80);
+	FTT_TileOverlayCompositor compositor;
+	compositor.Init(topology);
+	FTT_TileVisualBuffer visualBuffer;
+	visualBuffer.Init(topology);
+
+	const int32 tileID = topology.GetTileID(FIntPoint(70, 70));
+
+	// Scale from the selection, colour from the hover (higher priority) over the selection's
+	compositor.SetTile(ETileOverlay::TO_Selection, tileID, FTT_TileOverlayValue::MakeScale(0.8f));
+	compositor.SetTile(ETileOverlay::TO_Selection, tileID + 1, FTT_TileOverlayValue::MakeColour(FLinearColor::Green));
+	compositor.SetTile(ETileOverlay::TO_Hover, tileID, FTT_TileOverlayValue::MakeColour(FLinearColor::Red));
+	compositor.SetTile(ETileOverlay::TO_ViewMode, tileID, FTT_TileOverlayValue::MakeColour(FLinearColor::Blue));
+	compositor.SetTile(ETileOverlay::TO_Hover, topology.GetNumTiles(), FTT_TileOverlayValue::MakeColour(FLinearColor::Red));
+	compositor.SetTile(ETileOverlay::TO_Hover, -1, FTT_TileOverlayValue::MakeColour(FLinearColor::Red));
+
+	TestTrue(TEXT("Changed tiles are dirty"), compositor.HasDirtyTiles());
+	compositor.Flush(visualBuffer);
+	TestFalse(TEXT("Flushing cleans the tiles"), compositor.HasDirtyTiles());
+
+	TestTrue(TEXT("Higher layers override the colour"), visualBuffer.GetVisual(tileID) == FTT_TileVisual(FLinearColor::Red, 0.8f));
+	TestTrue(TEXT("Neighbour tile only has its own layers"), visualBuffer.GetVisual(tileID + 1) == FTT_TileVisual(FLinearColor::Green, 1.0f));
+	TestEqual(TEXT("Invalid tiles are ignored"), compositor.GetLayerTiles(ETileOverlay::TO_Hover).Num(), 1);
+
+	// Setting a tile to the value it already has changes nothing
+	compositor.SetTile(ETileOverlay::TO_Hover, tileID, FTT_TileOverlayValue::MakeColour(FLinearColor::Red));
+	TestFalse(TEXT("Setting the same value doesn't dirty the tile"), compositor.HasDirtyTiles());
+
+	// Removing the hover shows the layers under it again
+	compositor.RemoveTile(ETileOverlay::TO_Hover, tileID);
+	compositor.Flush(visualBuffer);
+	TestTrue(TEXT("Removing a layer reveals the ones under it"), visualBuffer.GetVisual(tileID) == FTT_TileVisual(FLinearColor::Blue, 0.8f));
+
+	// Resetting a tile keeps its view mode
+	compositor.ResetTile(tileID);
+	compositor.Flush(visualBuffer);
+	TestTrue(TEXT("Resetting a tile keeps the view mode layer"), visualBuffer.GetVisual(tileID) == FTT_TileVisual(FLinearColor::Blue, 1.0f));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTT_TileOverlayLayerTilesTest, "TinyTown.TileOverlay.LayerTiles", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTT_TileOverlayLayerTilesTest::RunTest(const FString& Parameters)
+{
+	const FTT_GridTopology topology(200, 150);
+	FTT_TileOverlayCompositor compositor;
+	compositor.Init(topology);
+	FTT_TileVisualBuffer visualBuffer;
+	visualBuffer.Init(topology);
+
+	const FTT_TileOverlayValue previewValue = FTT_TileOverlayValue::MakeColour(FLinearColor::Green);
+
+	// Tiles spread over several chunks
+	TArray<int> firstTiles;
+	firstTiles.Add(topology.GetTileID(FIntPoint(1, 1)));
+	firstTiles.Add(topology.GetTileID(FIntPoint(70, 2)));
+	firstTiles.Add(topology.GetTileID(FIntPoint(150, 140)));
+	compositor.SetLayerTiles(ETileOverlay::TO_Preview, firstTiles, previewValue);
+	compositor.Flush(visualBuffer);
+	visualBuffer.Flush([](int32 tileID, const FTT_TileVisual& newVisual, const FTT_TileVisual& previousVisual) {});
+
+	// Only the tiles entering or leaving the layer are composited again
+	TArray<int> secondTiles;
+	secondTiles.Add(firstTiles[1]);
+	secondTiles.Add(firstTiles[2]);
+	secondTiles.Add(topology.GetTileID(FIntPoint(199, 149)));
+	compositor.SetLayerTiles(ETileOverlay::TO_Preview, secondTiles, previewValue);
+	compositor.Flush(visualBuffer);
+
+	TArray<int32> appliedTiles;
+	visualBuffer.Flush([&](int32 tileID, const FTT_TileVisual& newVisual, const FTT_TileVisual& previousVisual)
+	{
+		appliedTiles.Add(tileID);
+	});
+
+	TestEqual(TEXT("Only the tiles entering or leaving the layer change"), appliedTiles.Num(), 2);
+	TestTrue(TEXT("The tiles entering and leaving the layer change"), appliedTiles.Contains(firstTiles[0]) && appliedTiles.Contains(secondTiles[2]));
+	TestFalse(TEXT("A tile leaving the layer is removed"), compositor.IsTileInLayer(ETileOverlay::TO_Preview, firstTiles[0]));
+	TestTrue(TEXT("Tiles staying in the layer are kept"), compositor.IsTileInLayer(ETileOverlay::TO_Preview, secondTiles[0]) && compositor.IsTileInLayer(ETileOverlay::TO_Preview, secondTiles[1]));
+	TestTrue(TEXT("A tile entering the layer is added"), compositor.IsTileInLayer(ETileOverlay::TO_Preview, secondTiles[2]));
+	TestEqual(TEXT("Layer holds the new tiles"), compositor.GetLayerTiles(ETileOverlay::TO_Preview).Num(), 3);
+	TestTrue(TEXT("The tile that left is back to the default visual"), visualBuffer.GetVisual(firstTiles[0]) == FTT_TileVisual());
+	TestTrue(TEXT("The tile that entered is coloured"), visualBuffer.GetVisual(secondTiles[2]) == FTT_TileVisual(FLinearColor::Green, 1.0f));
+
+	// Clearing a layer only touches its tiles, and leaves it reusable
+	compositor.ClearLayer(ETileOverlay::TO_Preview);
+	TestEqual(TEXT("Cleared layer is empty"), compositor.GetLayerTiles(ETileOverlay::TO_Preview).Num(), 0);
+	for (int32 tileID : secondTiles)
+	{
+		TestFalse(TEXT("Cleared tiles aren't part of the layer"), compositor.IsTileInLayer(ETileOverlay::TO_Preview, tileID));
+		TestTrue(TEXT("Cleared tiles have no value"), compositor.FindTile(ETileOverlay::TO_Preview, tileID) == nullptr);
+	}
+
+	compositor.Flush(visualBuffer);
+	for (int32 tileID : secondTiles)
+	{
+		TestTrue(TEXT("Cleared tiles are back to the default visual"), visualBuffer.GetVisual(tileID) == FTT_TileVisual());
+	}
+
+	compositor.ClearLayer(ETileOverlay::TO_Preview);
+	TestFalse(TEXT("Clearing an empty layer dirties nothing"), compositor.HasDirtyTiles());
+
+	compositor.SetTile(ETileOverlay::TO_Preview, firstTiles[0], previewValue);
+	TestTrue(TEXT("A cleared layer can be filled again"), compositor.IsTileInLayer(ETileOverlay::TO_Preview, firstTiles[0]));
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTT_TileOverlayLayerRectTest, "TinyTown.TileOverlay.LayerRect", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTT_TileOverlayLayerRectTest::RunTest(const FString& Parameters)
+{
+	const FTT_GridTopology topology(150, 100);
+	FTT_TileOverlayCompositor compositor;
+	compositor.Init(topology);
+	FTT_TileVisualBuffer visualBuffer;
+	visualBuffer.Init(topology);
+
+	const FTT_TileOverlayValue previewValue = FTT_TileOverlayValue::MakeColour(FLinearColor::Green);
+	const FTT_TileOverlayValue otherValue = FTT_TileOverlayValue::MakeColour(FLinearColor::Red);
+
+	FRandomStream randomStream(7);
+	FTT_TileRect previousRect;
+	FTT_TileOverlayValue previousValue = previewValue;
+	bool hasPreviousRect = false;
+
+	for (int32 step = 0; step < 200; step++)
+	{
+		// Rects moving a corner like a drag, jumping elsewhere, going past the grid's edges, or set tile by tile in between
+		FTT_TileRect rect;
+		const int32 kind = randomStream.RandRange(0, 9);
+		if (kind < 6 && hasPreviousRect)
+		{
+			rect = previousRect;
+			rect.Size += FIntPoint(randomStream.RandRange(-3, 3), randomStream.RandRange(-3, 3));
+		}
+		else
+		{
+			rect = FTT_TileRect(FIntPoint(randomStream.RandRange(-20, 160), randomStream.RandRange(-20, 110)), FIntPoint(randomStream.RandRange(0, 40), randomStream.RandRange(0, 40)));
+		}
+		const FTT_TileOverlayValue& value = randomStream.RandRange(0, 4) == 0 ? otherValue : previewValue;
+
+		if (kind == 9)
+		{
+			compositor.SetLayerTiles(ETileOverlay::TO_Preview, FTT_TileRectView(topology, rect), value);
+		}
+		else
+		{
+			compositor.SetLayerTiles(ETileOverlay::TO_Preview, rect, value);
+		}
+
+		if (randomStream.RandRange(0, 9) == 0)
+		{
+			// Changes made to single tiles are undone by the next rect
+			compositor.SetTile(ETileOverlay::TO_Preview, randomStream.RandRange(0, topology.GetNumTiles() - 1), otherValue);
+			compositor.RemoveTile(ETileOverlay::TO_Preview, topology.GetTileID(FIntPoint(FMath::Clamp(rect.Min.X, 0, 149), FMath::Clamp(rect.Min.Y, 0, 99))));
+			hasPreviousRect = false;
+			continue;
+		}
+
+		// The layer holds the tiles of the rect (clipped to the grid) with the new value, nothing else
+		const FTT_TileRectView rectView(topology, rect);
+		bool isLayerRight = compositor.GetLayerTiles(ETileOverlay::TO_Preview).Num() == rectView.Num();
+		for (int32 tileID : rectView)
+		{
+			const FTT_TileOverlayValue* tileValue = compositor.FindTile(ETileOverlay::TO_Preview, tileID);
+			isLayerRight &= tileValue && *tileValue == value;
+		}
+
+		if (!isLayerRight)
+		{
+			AddError(FString::Printf(TEXT("Layer doesn't hold the rect (%d, %d) of size (%d, %d) at step %d"), rect.Min.X, rect.Min.Y, rect.Size.X, rect.Size.Y, step));
+			return false;
+		}
+
+		// Only the tiles entering, leaving or changing value are composited again
+		if (hasPreviousRect)
+		{
+			const FTT_TileRectView previousView(topology, previousRect);
+			int32 numChangedTiles = 0;
+			for (int32 tileID : previousView)
+			{
+				numChangedTiles += (!rectView.Contains(topology.GetTileCoordinate(tileID)) || value != previousValue) ? 1 : 0;
+			}
+			for (int32 tileID : rectView)
+			{
+				numChangedTiles += !previousView.Contains(topology.GetTileCoordinate(tileID)) ? 1 : 0;
+			}
+
+			int32 numDirtyTiles = 0;
+			compositor.Flush(visualBuffer);
+			visualBuffer.Flush([&](int32 tileID, const FTT_TileVisual& newVisual, const FTT_TileVisual& previousVisual)
+			{
+				numDirtyTiles++;
+			});
+			TestEqual(TEXT("Only the tiles entering, leaving or changing value are composited"), numDirtyTiles, numChangedTiles);
+		}
+		else
+		{
+			compositor.Flush(visualBuffer);
+			visualBuffer.Flush([](int32 tileID, const FTT_TileVisual& newVisual, const FTT_TileVisual& previousVisual) {});
+		}
+
+		previousRect = rect;
+		previousValue = value;
+		hasPreviousRect = true;
+	}
+
+	// An unchanged rect dirties nothing
+	compositor.SetLayerTiles(ETileOverlay::TO_Preview, previousRect, previousValue);
+	TestFalse(TEXT("Setting the same rect again dirties nothing"), compositor.HasDirtyTiles());
+
+	return true;
+}
+
+#endif
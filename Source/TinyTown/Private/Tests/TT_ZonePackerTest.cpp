@@ -0,0 +1,185 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "Misc/AutomationTest.h"
+#include "TT_ZonePacker.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+namespace TT_ZonePackerTest
+{
+	/** Returns true if the placements stay in the zone, only cover free tiles and never overlap. Blocked tiles are the ones not free before packing. */
+	bool ArePlacementsValid(const FIntPoint& zoneSize, const TArray<bool>& blockedTiles, const TArray<FIntPoint>& sizes, const TArray<FTT_ZonePlacement>& placements)
+	{
+		TArray<bool> usedTiles = blockedTiles;
+		for (const FTT_ZonePlacement& placement : placements)
+		{
+			const FIntPoint& size = sizes[placement.SizeIndex];
+			if (placement.Min.X < 0 || placement.Min.Y < 0 || placement.Min.X + size.X > zoneSize.X || placement.Min.Y + size.Y > zoneSize.Y)
+			{
+				return false;
+			}
+
+			for (int32 row = placement.Min.Y; row < placement.Min.Y + size.Y; row++)
+			{
+				for (int32 column = placement.Min.X; column < placement.Min.X + size.X; column++)
+				{
+					bool& isTileUsed = usedTiles[row * zoneSize.X + column];
+					if (isTileUsed)
+					{
+						return false;
+					}
+					isTileUsed = true;
+				}
+			}
+		}
+		return true;
+	}
+
+	int32 GetPackedArea(const TArray<FIntPoint>& sizes, const TArray<FTT_ZonePlacement>& placements)
+	{
+		int32 packedArea = 0;
+		for (const FTT_ZonePlacement& placement : placements)
+		{
+			packedArea += sizes[placement.SizeIndex].X * sizes[placement.SizeIndex].Y;
+		}
+		return packedArea;
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTT_ZonePackerPreferenceTest, "TinyTown.ZonePacker.Preference", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTT_ZonePackerPreferenceTest::RunTest(const FString& Parameters)
+{
+	using namespace TT_ZonePackerTest;
+
+	TArray<FIntPoint> sizes;
+	sizes.Add(FIntPoint(1, 1));
+	sizes.Add(FIntPoint(2, 2));
+	sizes.Add(FIntPoint(3, 2));
+
+	const FIntPoint zoneSize(6, 4);
+	TArray<bool> blockedTiles;
+	blockedTiles.Init(false, zoneSize.X * zoneSize.Y);
+
+	FTT_ZonePacker zonePacker;
+	TArray<FTT_ZonePlacement> placements;
+
+	// Largest first: four 3x2 fill the zone
+	zonePacker.Init(zoneSize);
+	zonePacker.Pack(sizes, EZonePackingPreference::ZP_LargestFirst, placements);
+	TestEqual(TEXT("Largest first uses the fewest buildings"), placements.Num(), 4);
+	TestTrue(TEXT("Largest first places the largest size"), placements.Num() > 0 && placements[0].SizeIndex == 2 && placements[0].Min == FIntPoint(0, 0));
+	TestTrue(TEXT("Largest first placements are valid"), ArePlacementsValid(zoneSize, blockedTiles, sizes, placements));
+	TestEqual(TEXT("Largest first fills the zone"), GetPackedArea(sizes, placements), zoneSize.X * zoneSize.Y);
+
+	// Smallest first: one building per tile
+	placements.Reset();
+	zonePacker.Init(zoneSize);
+	zonePacker.Pack(sizes, EZonePackingPreference::ZP_SmallestFirst, placements);
+	TestEqual(TEXT("Smallest first uses the most buildings"), placements.Num(), zoneSize.X * zoneSize.Y);
+	TestTrue(TEXT("Smallest first placements are valid"), ArePlacementsValid(zoneSize, blockedTiles, sizes, placements));
+
+	// Placements are in increasing row then column order
+	bool isOrdered = true;
+	for (int32 placementIndex = 1; placementIndex < placements.Num(); placementIndex++)
+	{
+		const FIntPoint& previous = placements[placementIndex - 1].Min;
+		const FIntPoint& current = placements[placementIndex].Min;
+		isOrdered &= previous.Y < current.Y || (previous.Y == current.Y && previous.X < current.X);
+	}
+	TestTrue(TEXT("Placements are in row then column order"), isOrdered);
+
+	// Sizes that can't be placed
+	placements.Reset();
+	TArray<FIntPoint> invalidSizes;
+	invalidSizes.Add(FIntPoint(0, 3));
+	invalidSizes.Add(FIntPoint(7, 1));
+	zonePacker.Init(zoneSize);
+	zonePacker.Pack(invalidSizes, EZonePackingPreference::ZP_LargestFirst, placements);
+	TestEqual(TEXT("Empty or too wide sizes are never placed"), placements.Num(), 0);
+
+	return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FTT_ZonePackerBlockedTilesTest, "TinyTown.ZonePacker.BlockedTiles", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FTT_ZonePackerBlockedTilesTest::RunTest(const FString& Parameters)
+{
+	using namespace TT_ZonePackerTest;
+
+	TArray<FIntPoint> sizes;
+	sizes.Add(FIntPoint(2, 2));
+	sizes.Add(FIntPoint(1, 1));
+	sizes.Add(FIntPoint(3, 1));
+	sizes.Add(FIntPoint(1, 3));
+
+	FRandomStream randomStream(42);
+	FTT_ZonePacker zonePacker;
+
+	for (int32 zoneIndex = 0; zoneIndex < 20; zoneIndex++)
+	{
+		const FIntPoint zoneSize(randomStream.RandRange(1, 40), randomStream.RandRange(1, 40));
+		TArray<bool> blockedTiles;
+		blockedTiles.Init(false, zoneSize.X * zoneSize.Y);
+
+		// Roads crossing the zone and scattered tiles already used
+		zonePacker.Init(zoneSize);
+		for (int32 tileIndex = 0; tileIndex < blockedTiles.Num(); tileIndex++)
+		{
+			const FIntPoint tile(tileIndex % zoneSize.X, tileIndex / zoneSize.X);
+			if (tile.X == zoneSize.X / 2 || tile.Y == zoneSize.Y / 3 || randomStream.RandRange(0, 9) == 0)
+			{
+				blockedTiles[tileIndex] = true;
+				zonePacker.BlockTile(tile);
+			}
+		}
+
+		int32 numFreeTiles = 0;
+		bool areFreeTilesRight = true;
+		for (int32 tileIndex = 0; tileIndex < blockedTiles.Num(); tileIndex++)
+		{
+			numFreeTiles += blockedTiles[tileIndex] ? 0 : 1;
+			areFreeTilesRight &= zonePacker.IsTileFree(FIntPoint(tileIndex % zoneSize.X, tileIndex / zoneSize.X)) != blockedTiles[tileIndex];
+		}
+		TestTrue(TEXT("Blocked tiles aren't free"), areFreeTilesRight);
+		TestFalse(TEXT("Tiles off the zone aren't free"), zonePacker.IsTileFree(FIntPoint(-1, 0)) || zonePacker.IsTileFree(zoneSize));
+
+		TArray<FTT_ZonePlacement> placements;
+		zonePacker.Pack(sizes, EZonePackingPreference::ZP_LargestFirst, placements);
+
+		TestTrue(TEXT("Placements avoid the blocked tiles and each other"), ArePlacementsValid(zoneSize, blockedTiles, sizes, placements));
+
+		// With a 1x1 size, every free tile ends up covered
+		TestEqual(TEXT("Every free tile is packed"), GetPackedArea(sizes, placements), numFreeTiles);
+
+		// The same zone is always packed the same way
+		FTT_ZonePacker otherZonePacker;
+		otherZonePacker.Init(zoneSize);
+		for (int32 tileIndex = 0; tileIndex < blockedTiles.Num(); tileIndex++)
+		{
+			if (blockedTiles[tileIndex])
+			{
+				otherZonePacker.BlockTile(FIntPoint(tileIndex % zoneSize.X, tileIndex / zoneSize.X));
+			}
+		}
+
+		TArray<FTT_ZonePlacement> otherPlacements;
+		otherZonePacker.Pack(sizes, EZonePackingPreference::ZP_LargestFirst, otherPlacements);
+
+		bool areSamePlacements = placements.Num() == otherPlacements.Num();
+		for (int32 placementIndex = 0; areSamePlacements && placementIndex < placements.Num(); placementIndex++)
+		{
+			areSamePlacements = placements[placementIndex].Min == otherPlacements[placementIndex].Min && placements[placementIndex].SizeIndex == otherPlacements[placementIndex].SizeIndex;
+		}
+		TestTrue(TEXT("Packing is deterministic"), areSamePlacements);
+
+		// Packed tiles are used, a second pack finds no room
+		TArray<FTT_ZonePlacement> secondPlacements;
+		zonePacker.Pack(sizes, EZonePackingPreference::ZP_LargestFirst, secondPlacements);
+		TestEqual(TEXT("A packed zone has no room left"), secondPlacements.Num(), 0);
+	}
+
+	return true;
+}
+
+#endif
@@ -5,6 +5,7 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "TT_Global.h"
+#include "TT_BlockStore.h"
 #include "TT_Block.generated.h"
 
 
@@ -47,14 +48,18 @@ protected:
 
 /*---------- Variables -----------*/
 
-	/** This struct contains all the information that characterise this block (both block building as well a gameplay variables). */
-	FTT_Struct_Block blockStats;
+	/** This struct contains all the information that characterise this block (both block building as well a gameplay variables).
+	* Points to the block's row in the data table, shared by all the blocks with the same BlockID. */
+	FTT_Struct_Block* blockStats;
+
+	/** Handle of this block in the BlockManager's block store, unset for blocks that aren't on the grid (e.g. build tool preview). */
+	FTT_BlockHandle blockHandle;
 
 	/** Reference to BlockManager, set on spawn. */
 	ATT_BlockManager* blockManager;
 
-	/** This array contains all the tile the block owns. If a block is owned, no other block can be spawned on it. */
-	TArray<int> blockTileIDs;
+	/** Rectangle of all the tiles the block owns. If a block is owned, no other block can be spawned on it. */
+	FTT_TileRect blockTileRect;
 
 
 	/**
@@ -88,6 +93,9 @@ public:
 	UFUNCTION(BlueprintPure)
 	const FTT_Struct_Block GetBlockData();
 
+	/* Returns the mesh component drawing the block, its mesh & relative transform are used when the block is drawn as an instance. */
+	UStaticMeshComponent* GetBlockMesh() const;
+
 	void SetBlockManager(ATT_BlockManager* BlockManager);
 	UFUNCTION(BlueprintPure)
 	ATT_BlockManager* GetBlockManager();
@@ -96,9 +104,18 @@ public:
 	UFUNCTION(BlueprintPure)
 		ATT_GridManager* GetGridManager();
 
+	void SetBlockHandle(FTT_BlockHandle handle);
+	FTT_BlockHandle GetBlockHandle() const;
+
 	void SetCentralTileID(int tileID);
 
-	void SetBlockTileIDs(TArray<int> TileIDs);
+	void SetBlockTileRect(const FTT_TileRect& TileRect);
+
+	/* Returns the rectangle of tiles owned by the block. */
+	UFUNCTION(BlueprintPure)
+		FTT_TileRect GetBlockTileRect() const;
+
+	/* Returns all the tiles owned by the block, built from its tile rectangle. */
 	TArray<int> GetBlockTileIDs();
 
 	UFUNCTION(BlueprintPure)
@@ -106,6 +123,7 @@ public:
 
 	// The two following functions only set variables, use UpdateBlockRotationAndLocation to actually confirm the move. 
 	void SetBlockPosition(); // Set the block's position to fit neatly on the grid and to be centered around its anchor point. 
+	static FVector GetBlockAnchorLocation(int sizeX, int sizeY, float yaw, float tileDistance); // Offset applied by SetBlockPosition, also used for instanced blocks.
 	void SetBlockRotation(FRotator Rotation, float blockRotaSpeed); // Set the rotator variable of the RotationRoot
 
 	// Updates a block's rotation and location based of 
@@ -120,11 +138,21 @@ public:
 	// Block functions
 	
 
+	/* Hides the block, disables its collision and clears its stats, tiles & transform so that the block manager can pool it. */
+	void DeactivateBlock();
+
+	/* Moves a pooled block to its new transform and shows it again. It still needs to be initialised like a newly spawned block. */
+	void ReactivateBlock(const FTransform& blockTransform);
+
+	/* Called when a pooled block is reused for a new block, once it is initialised. BeginPlay is only called when the block is first spawned. */
+	UFUNCTION(BlueprintImplementableEvent)
+		void OnBlockReused();
+
 	/* Called when this block is about to be destroyed. */
 	UFUNCTION(BlueprintNativeEvent)
 		void OnDestroyBlock();
 
-	/* Destroys the block. */
+	/* Gives the block back to the block manager's pool, destroys it if it isn't pooled. */
 	void OnDestroyBlock_Implementation();
 
 /*---------- Variables -----------*/
@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Compiled view of the block data table, built once when the block manager starts.
+	Blocks are stored in dense arrays indexed by blockID, so getting a block's stats is a single indexed load
+	instead of a walk through the data table's rows. The records only hold what the grid needs every frame
+	(size, type, colour, class), the full row is still reachable through FindStats.
+	Blocks are also indexed by category & size: every block sharing both has its ID stored next to the others,
+	so "all the 2x3 Residential buildings" is a view over a slice of one array. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/ArrayView.h"
+#include "TT_Global.h"
+
+class UDataTable;
+
+/** Immutable, compact copy of the data a block needs while placing it on the grid. */
+struct FTT_BlockRecord
+{
+	int32 BlockID;
+	int32 SizeX;
+	int32 SizeY;
+	EBlockType Type;
+	FLinearColor GridColour;
+	TSubclassOf<ATT_Block> BlockClass;
+	bool RequiresActor;
+
+	FTT_BlockRecord()
+		: BlockID(INDEX_NONE)
+		, SizeX(0)
+		, SizeY(0)
+		, Type(EBlockType::BT_Nothing)
+		, GridColour(FLinearColor::Black)
+		, BlockClass(nullptr)
+		, RequiresActor(false)
+	{
+	}
+
+	FORCEINLINE bool IsValid() const { return BlockID != INDEX_NONE; }
+};
+
+/** Blocks sharing a category and a size, their IDs are contiguous in the catalog's candidate array. */
+struct FTT_BlockCandidateGroup
+{
+	FIntPoint Size;
+	int32 FirstCandidate;
+	int32 NumCandidates;
+};
+
+class FTT_BlockCatalog
+{
+public:
+
+	/** Highest blockID a row can use. Records are indexed by blockID, this bounds the catalog's arrays whatever the data table holds. */
+	static FORCEINLINE int32 GetMaxBlockID() { return MAX_uint16; }
+
+	/**
+	* Parses every row of the data table, rows must be named after their blockID (positive integer, at most GetMaxBlockID()).
+	* Rows with any other name are skipped with a warning.
+	* @return False if the table isn't valid, the catalog is then empty.
+	*/
+	bool Build(UDataTable* dataTable);
+
+	void Reset();
+
+	bool IsBuilt() const { return BlockIDs.Num() > 0; }
+
+	FORCEINLINE bool IsBlockValid(int32 blockID) const
+	{
+		return Records.IsValidIndex(blockID) && Records[blockID].IsValid();
+	}
+
+	/** Returns the block's record, nullptr if no row of the data table has that blockID. */
+	FORCEINLINE const FTT_BlockRecord* FindRecord(int32 blockID) const
+	{
+		return IsBlockValid(blockID) ? &Records[blockID] : nullptr;
+	}
+
+	/** Returns the block's data table row, nullptr if no row has that blockID. */
+	FORCEINLINE FTT_Struct_Block* FindStats(int32 blockID) const
+	{
+		return IsBlockValid(blockID) ? Stats[blockID] : nullptr;
+	}
+
+	/** All the blockIDs found in the data table, in increasing order. */
+	const TArray<int>& GetBlockIDs() const { return BlockIDs; }
+
+	/** Returns the blockIDs of a category (Category_Name) with a size, in increasing order. Empty if there are none. */
+	TArrayView<const int32> FindCandidates(const FString& category, int32 sizeX, int32 sizeY) const;
+
+	/** Returns one of the blocks FindCandidates would return, picked at random. INDEX_NONE if there are none. */
+	int32 PickRandomCandidate(const FString& category, int32 sizeX, int32 sizeY) const;
+
+	/** Returns every size available in a category alongside its blocks, sorted by size (X, then Y). */
+	TArrayView<const FTT_BlockCandidateGroup> FindCategoryGroups(const FString& category) const;
+
+	/** Returns the blockIDs of one of the groups returned by FindCategoryGroups. */
+	FORCEINLINE TArrayView<const int32> GetGroupCandidates(const FTT_BlockCandidateGroup& group) const
+	{
+		return TArrayView<const int32>(Candidates.GetData() + group.FirstCandidate, group.NumCandidates);
+	}
+
+private:
+
+	/** Index = blockID, invalid records fill the gaps between IDs. */
+	TArray<FTT_BlockRecord> Records;
+
+	/** Index = blockID, points to the data table's rows (owned by the table). */
+	TArray<FTT_Struct_Block*> Stats;
+
+	TArray<int> BlockIDs;
+
+	/** Reads a row name made of digits only, returns false if it isn't one or if the blockID is above GetMaxBlockID(). */
+	static bool ParseBlockID(const FString& rowName, int32& OutBlockID);
+
+	/** Builds the category & size index from the records. */
+	void BuildCandidateIndex();
+
+	const FTT_BlockCandidateGroup* FindGroup(const FString& category, int32 sizeX, int32 sizeY) const;
+
+	/** BlockIDs sorted by category, then size, then ID. */
+	TArray<int32> Candidates;
+
+	/** One group per category & size, the groups of a category are contiguous. */
+	TArray<FTT_BlockCandidateGroup> CandidateGroups;
+
+	/** Category name -> range of its groups in CandidateGroups (X = first group, Y = number of groups). */
+	TMap<FString, FIntPoint> CategoryGroups;
+
+	/** (First group of the category, size X, size Y) -> index of the group in CandidateGroups. */
+	TMap<FIntVector, int32> GroupLookup;
+};
@@ -14,14 +14,55 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
 #include "TT_Global.h"
+#include "TT_ChunkedTileLayer.h"
+#include "TT_BlockCatalog.h"
+#include "TT_OccupancyBitboard.h"
+#include "TT_PlacementValidityMap.h"
+#include "TT_BlockStore.h"
 #include "TT_BlockManager.generated.h"
 
 class ATT_GridManager;
 class UDataTable;
 class ATT_Block;
+class UHierarchicalInstancedStaticMeshComponent;
 struct FTT_Struct_Block;
 struct FTT_Struct_BlockType;
 
+/** Broadcast each frame the spawn queue displays blocks: how many of the queued blocks were handled so far, out of how many. */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FTT_OnSpawnQueueProgress, int, handledBlocks, int, queuedBlocks);
+
+/** Broadcast once every queued block is displayed. */
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FTT_OnSpawnQueueEmptied);
+
+/** Broadcast once blockOccupancy is up to date after blocks were spawned on or removed from a rectangle of tiles (the whole grid when the tile arrays are reset). */
+DECLARE_MULTICAST_DELEGATE_OneParam(FTT_OnBlockOccupancyChanged, const FTT_TileRect&);
+
+/** How the blocks of a blockID are drawn when instanced. */
+struct FTT_BlockInstanceType
+{
+	/** Index of the component drawing the block's mesh in blockInstanceComponents, INDEX_NONE if the block needs its actor. */
+	int32 ComponentIndex;
+
+	/** Transform of the block's mesh relative to its RotationRoot, taken from the block class. */
+	FTransform MeshTransform;
+
+	FTT_BlockInstanceType()
+		: ComponentIndex(INDEX_NONE)
+	{
+	}
+};
+
+/** Deactivated blocks of one class, waiting to be reused. */
+USTRUCT()
+struct FTT_BlockActorPool
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Blocks destroyed by the level while pooled are nulled by the garbage collector. */
+	UPROPERTY()
+		TArray<ATT_Block*> Blocks;
+};
+
 UCLASS()
 class TINYTOWN_API ATT_BlockManager : public AActor
 {
@@ -43,17 +84,16 @@ protected:
 	UDataTable* GetBlockDataTable();
 
 	/**
-	* This function sorts the data base into a FMap. It separates all different block types and gather all blockIDs from the 
+	* Compiles the data table into the block catalog, then sorts it into a FMap. It separates all different block types and gather all blockIDs from the 
 	* same type in the same place.
 	*/
 	void RefreshDataFromDataTable();
 
 	/**
-	 * Resize all the tile arrays (responsible of holding tile information, such as if it is used, what is it used by etc ...)
-	 * to the number of tiles there are in the level.
-	 * @param NumberOfTiles Number to resize the arrays to.
+	 * Initialise all the tile arrays (responsible of holding tile information, such as if it is used, what is it used by etc ...)
+	 * to the GridManager's grid. Tile arrays are chunked, chunks without any block or zone are not allocated.
 	 */
-	void SetTileArraysSize(int newArraySize);
+	void InitTileArrays();
 
 	/**
 	 * Clear any value in tile arrays at the specified index.
@@ -62,18 +102,115 @@ protected:
 	void ClearTileArraysAtIndex(int index);
 
 
-	void SpawnZoneBuildingsInZone(int zoneID, TArray<int> tileIDs);
+	/**
+	* Fills the free tiles of a zone with the zone buildings associated to it (see FTT_ZonePacker).
+	* @param zoneID BlockID of the zone.
+	* @param zone Tiles of the zone.
+	*/
+	void SpawnZoneBuildingsInZone(int zoneID, const FTT_TileRect& zone);
+
+	/**
+	 * Returns how many tiles separate a zone's StartTile from the tile it is placed around (its hovered tile), along one axis.
+	 * @param size Size in tiles of the zone on that axis.
+	 */
+	static int GetZoneAnchorOffset(int size);
+
+	/** Returns the rotated size & anchor of a block, as used by GetZoneStartTileFromHoveredTile and GetZoneEndTileFromZoneSize. */
+	static FTT_PlacementFootprint GetPlacementFootprint(int sizeX, int sizeY, bool isModuloHalfPi);
+
+	/** Updates the occupancy bitboard and the placement validity maps after blocks were spawned on or removed from a rectangle, then broadcasts OnBlockOccupancyChanged. */
+	void SetBlockOccupancy(const FTT_TileRect& rect, bool isOccupied);
+
+	/** Adds a block to the block store and gives it its tiles. Returns an unset handle if the store is full. */
+	FTT_BlockHandle ReserveBlock(int blockID, int centralTileID, float yaw, const FTT_TileRect& tileRect);
+
+	/** Frees the tiles of a block and removes it from the block store, its actor is left untouched. */
+	void ReleaseBlock(FTT_BlockHandle handle);
+
+	/** Displays a reserved block, as an instance if possible, with its actor otherwise. Returns false if it couldn't be displayed. */
+	bool DisplayBlock(FTT_BlockHandle handle);
 
-	void SpawnBlockInZone(int tileA, TArray<int> zoneTiles, TMap<int, FVector2D> blockSizesMap);
+	/**
+	* Displays the queued blocks, in the order they were queued, until the budget is spent. At least one block is displayed per call.
+	* @param budgetMs Time in milliseconds the queue can take.
+	*/
+	void ProcessSpawnQueue(float budgetMs);
+
+	/** Spawns & initialises the actor of a reserved block from its values in the block store. A pooled actor of the block's class is reused if there is one. */
+	ATT_Block* SpawnBlockActor(FTT_BlockHandle handle);
+
+	/** Takes a deactivated block of that class out of the pool, nullptr if the pool is empty. */
+	ATT_Block* AcquirePooledBlockActor(UClass* blockClass);
+
+	/**
+	* Returns how the blocks of a blockID are instanced, nullptr if they need their actor (see FTT_Struct_Block::Requires_Actor).
+	* The component drawing their mesh is created the first time it is needed.
+	*/
+	const FTT_BlockInstanceType* GetBlockInstanceType(int blockID);
+
+	/** Draws a reserved block as an instance of its mesh. Returns false if the block needs its actor. */
+	bool AddBlockInstance(FTT_BlockHandle handle);
+
+	/** Hides the instance of an Instanced block, the instance is reused by the next block drawn with the same mesh. */
+	void RemoveBlockInstance(FTT_BlockHandle handle);
 
 
 	/*---------- Variables -----------*/
 
+	UPROPERTY(VisibleAnywhere)
+		USceneComponent* Root;
+
+	/** If true, the blocks that don't require an actor are drawn as instances of their mesh (one component per mesh) rather than by one actor each.
+	* Their actor is only spawned when needed, e.g. when the block is selected (see GetOrSpawnBlockActorOnTile). */
+	UPROPERTY(EditAnywhere, Category = "BlockManager")
+		bool useInstancedBlockRendering;
+
+	/** Time in milliseconds the spawn queue can take each frame to display the blocks spawned with isDisplayDeferred. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "BlockManager")
+		float spawnQueueBudgetMs;
 
+	/** Reserved blocks waiting to be displayed, from spawnQueueHead on. */
+	TArray<FTT_BlockHandle> spawnQueue;
+
+	/** Index of the next block of spawnQueue to display. */
+	int spawnQueueHead;
+
+	/** If true, deleted blocks are deactivated and reused by the next block of their class instead of being destroyed (see ReleaseBlockActor). */
+	UPROPERTY(EditAnywhere, Category = "BlockManager")
+		bool useBlockActorPool;
+
+	/** Most deactivated blocks kept per block class, the blocks deleted past that are destroyed. */
+	UPROPERTY(EditAnywhere, Category = "BlockManager")
+		int maxPooledBlocksPerClass;
+
+	/** Pools filled when the game starts, blockID -> number of blocks (see PrewarmBlockActorPool). */
+	UPROPERTY(EditAnywhere, Category = "BlockManager")
+		TMap<int, int> blockActorPoolPrewarm;
+
+	/** Deactivated blocks per block class. */
+	UPROPERTY()
+		TMap<UClass*, FTT_BlockActorPool> blockActorPools;
+
+	/** One component per block mesh, drawing all the instanced blocks using that mesh. */
+	UPROPERTY()
+		TArray<UHierarchicalInstancedStaticMeshComponent*> blockInstanceComponents;
+
+	/** Per component of blockInstanceComponents, the hidden instances left by deleted blocks. */
+	TArray<TArray<int32>> freeBlockInstances;
+
+	/** How each blockID is instanced, filled the first time a block of that blockID is spawned. */
+	TMap<int, FTT_BlockInstanceType> blockInstanceTypes;
 
 	/** Data table holding data of all the blocks.*/
 	UDataTable* data_Block;
 
+	/** Which zone building sizes are placed first when a zone is filled. */
+	UPROPERTY(EditAnywhere, Category = "BlockManager")
+		EZonePackingPreference zoneBuildingSizePreference;
+
+	/** Blocks of the data table indexed by blockID, built once in RefreshDataFromDataTable. */
+	FTT_BlockCatalog blockCatalog;
+
 	/** This map sorts all blocks by types, each key is a type (string) containing an array of BlockID (int). */
 	TMap<FString, FTT_Struct_BlockType> blockTypeMap;
 	
@@ -81,6 +218,8 @@ public:
 
 	/*---------- Functions -----------*/
 
+	virtual void Tick(float DeltaTime) override;
+
 	/** Sets the GridManager variable and sets the size of all tile arrays.
 	* @param newGridManager New value of GridManager
 	*/
@@ -92,8 +231,9 @@ public:
 	* @param blockID Data table index of the row corresponding to the block to spawn.
 	* @param blockRotation Orientation of the block. (Can only be % Pi/2 (0, 90, 180)).
 	 * @param tileID Index of the tile to spawn the block around.
+	 * @param isDisplayDeferred If true, the block owns its tiles right away but is displayed later by the spawn queue (see spawnQueueBudgetMs).
 	 */
-	void SpawnBlock(int blockID, FRotator blockRotation, int tileID);
+	void SpawnBlock(int blockID, FRotator blockRotation, int tileID, bool isDisplayDeferred = false);
 
 	/**
 	* Calculate the zone used by the block & assign the tile arrays to the block.
@@ -101,8 +241,9 @@ public:
 	* The block will be spawn from its zone's StartTile rather than around the tile. Doesn't support block rotation.
 	* @param blockID Data table index of the row corresponding to the block to spawn.
 	* @param tileID Index of the tile to be set as the block's zone's StartTile.
+	* @param isDisplayDeferred If true, the block owns its tiles right away but is displayed later by the spawn queue (see spawnQueueBudgetMs).
  */
-	void SpawnBlockAtStartTile(int blockID, int tileID);
+	void SpawnBlockAtStartTile(int blockID, int tileID, bool isDisplayDeferred = false);
 
 	/**
 	* Gets a random blockID corresponding to parameters in the data table.
@@ -110,7 +251,7 @@ public:
 	* @param tileID Data table index of the row corresponding to the block.
 	* @param blockRotation Orientation of the block. (Can only be % Pi/2 (0, 90, 180)).
 	* @param buildingType Type of building to look for (should be replaced by EBuildingType).
-	* @param efficiency Level of the building to look for (1-3)
+	* @param efficiency Level of the building to look for (1-3). Not in the data table yet, ignored.
 	* @param sizeX X size of block's zone (how big is the block in tiles)
 	* @param sizeY Y size of block's zone (how big is the block in tiles)
 	*/
@@ -125,11 +266,13 @@ public:
 
 	/**
 * Assigns elements of the spawnedZoneID array to a certain ZoneID.
-* @param tileIDs TileIDs of the zone's tiles.
+* The zone buildings own their tiles right away and are displayed by the spawn queue.
+* @param zone Rectangle of the zone's tiles.
 * @param zoneID ID of the zone to assign the tiles to.
 */
-	void CreateZoneOnTiles(TArray<int> tileIDs, int zoneID);
+	void CreateZoneOnTiles(const FTT_TileRect& zone, int zoneID);
 
+	/** Spawns a path block on each tile. The blocks own their tiles right away and are displayed by the spawn queue. */
 	void CreatePathOnTiles(TArray<int> tileIDs, int blockID);
 
 	/**
@@ -147,6 +290,13 @@ public:
 	 */
 	TArray<int> GetZoneTileIDsFromZoneParameters(int tileA, int tileB, bool excludeTileB);
 
+	/**
+	 * Returns the rectangle of tiles delimited by tileA & tileB (opposing corners, both included). Empty if either tile is invalid.
+	 * @param tileA Corner A / StartTile of the zone.
+	 * @param tileB Opposite corner to A.
+	 */
+	FTT_TileRect GetZoneRectFromZoneParameters(int tileA, int tileB);
+
 	/**
 	 * Returns the TileID of the StartTile associated with the zone defined by parameters (see top of page for zone explanation).
 	 * @param tileC Tile currently hovered by the mouse.
@@ -163,7 +313,7 @@ public:
 	int GetHoveredTileFromZoneParameter(int tileC, int sizeX, int sizeY, bool isModuloHalfPi);
 	/**
 	 * Returns the TileID of the corner tile opposite to tileA in a zone defined by parameters (see top of page for zone explanation).
-	 * Caution, this functions doesn't take in account the edges of the grid.
+	 * Returns -1 if the zone would go over the edge of the grid.
 	 * @param tileA Corner A / StartTile of the zone.
 	 * @param sizeX X size of block's zone (how big is the block in tiles).
 	 * @param sizeY Y size of block's zone (how big is the block in tiles).
@@ -177,25 +327,47 @@ public:
 	FVector2D GetZoneSizeFromTileArray(TArray<int> zone);
 
 
-	/* Returns the tile's column and row. This is usefulf when checking if a zone is going over the edge of the grid. */
-	FVector2D GetTileGridCoordinate(int tileID);
+	/* Returns the tile's column (X) and row (Y). This is useful when checking if a zone is going over the edge of the grid. */
+	FIntPoint GetTileGridCoordinate(int tileID);
 
 	/* Returns true if the zone is on the grid and not crossing over the edge of the grid. */
 	bool CheckZoneTileIDs(TArray<int> zoneTileIDs, int tileA, int tileB);
 
+	/* Returns true if a block of that size and rotation can be placed around tileC, looked up in its placement validity map. */
 	bool CheckIfBlockIsBuildable(int tileC, int sizeX, int sizeY, bool isModuloHalfPi);
 
-	bool CheckIfBlockIsBuildable(int tileC, int sizeX, int sizeY, bool isModuloHalfPi, TArray<int>& OutZoneTileIDs);
+	/* Same as above, also returns the rectangle of tiles the block would own (empty if it isn't buildable). */
+	bool CheckIfBlockIsBuildable(int tileC, int sizeX, int sizeY, bool isModuloHalfPi, FTT_TileRect& OutBlockRect);
 
-	/* Returns the nearest tileID with the space to accomodate a block of the specified size. */
+	/**
+	* Returns the map of the tiles a block of that size and rotation can be placed around.
+	* Maps are built on first use and updated whenever blocks are spawned or deleted.
+	*/
+	const FTT_PlacementValidityMap& GetPlacementValidityMap(int sizeX, int sizeY, bool isModuloHalfPi);
+
+	/* Returns a tileID with the space to accomodate a block of the specified size among the 8 neighbours of tileID, then the 16 tiles of the ring around them (Chebyshev distance of 2). */
 	bool GetNearestBuildableTileID(int& OutTileID, int tileID, int sizeX, int sizeY, bool isModuloHalfPi);
+
+	/**
+	* Returns the nearest tileID with the space to accomodate a block of the specified size (see FTT_PlacementValidityMap::FindNearestValidTile).
+	* @param maxRadius Furthest distance in tiles from tileID the block can be placed at.
+	* @param cursorCoordinate Continuous grid coordinate the equally near tiles are chosen toward, e.g. the mouse cursor's.
+	*/
+	bool GetNearestBuildableTileID(int& OutTileID, int tileID, int sizeX, int sizeY, bool isModuloHalfPi, int maxRadius, const FVector2D& cursorCoordinate);
 		
 	/**
-	* Returns pointer to data of block from its BlockID (see TT_Struct_Block).
+	* Returns pointer to data of block from its BlockID (see TT_Struct_Block), nullptr if the blockID isn't in the data table.
 	* @param blockID Data table index of the row corresponding to the block to spawn.
 	*/
 	FTT_Struct_Block* GetBlockStatsFromBlockID(int blockID);
 
+	/**
+	* Returns the compact record of a block (size, type, colour, class), nullptr if the blockID isn't in the data table.
+	* Prefer this over GetBlockStatsFromBlockID when only these values are needed.
+	* @param blockID Data table index of the row corresponding to the block.
+	*/
+	const FTT_BlockRecord* GetBlockRecordFromBlockID(int blockID) const;
+
 	/** 
 	* Returns data of block from its BlockID (see TT_Struct_Block). Added to expose GetBlockStatsFromBlockID() to blueprints.
 	* @param blockID Data table index of the row corresponding to the block to spawn.
@@ -203,10 +375,13 @@ public:
 	UFUNCTION(BlueprintPure, Category = "BlockManager")
 	const FTT_Struct_Block GetBlockStatsInDataTable(int blockID);
 
+	/** Returns the compiled block data table, see FTT_BlockCatalog. */
+	const FTT_BlockCatalog& GetBlockCatalog() const { return blockCatalog; }
+
 	/**
-	* Returns a random blockID corresponding to parameters in the data table.
+	* Returns a random blockID corresponding to parameters in the data table, 0 if none matches.
 	* @param buildingType Type of building to look for (see EBuildingType).
-	* @param efficiency Level of the building to look for (1-3)
+	* @param efficiency Level of the building to look for (1-3). Not in the data table yet, ignored.
 	* @param sizeX X size of block's zone (how big is the block in tiles)
 	* @param sizeY Y size of block's zone (how big is the block in tiles)
 	*/
@@ -215,36 +390,112 @@ public:
 	/**
 	* Returns an array of all the blockID corresponding to parameters in the data table.
 	* @param buildingType Type of building to look for (see EBuildingType).
-	* @param efficiency Level of the building to look for (1-3)
+	* @param efficiency Level of the building to look for (1-3). Not in the data table yet, ignored.
 	* @param sizeX X size of block's zone (how big is the block in tiles)
 	* @param sizeY Y size of block's zone (how big is the block in tiles)
 	*/
 	TArray<int> GetAllBlockIDsFromParameter(FString buildingType, int efficiency, int sizeX, int sizeY);
 
-	/* Accessor - Returns the array of spawned zones where index = index of the tile, and element = BlockID. */
+	/* Accessor - Returns the array of spawned zones where index = index of the tile, and element = BlockID. 
+	* This copies the whole grid, use GetSpawnedZoneIDOnTile when possible.
+	*/
 	UFUNCTION(BlueprintPure, Category = "BlockManager")
 	TArray<int> GetSpawnedZoneTileIDs();
 
-	/* Accessor - Returns the array of spawned blocks where index = index of the tile, and element = BlockID. */
+	/* Accessor - Returns the array of spawned blocks where index = index of the tile, and element = BlockID. 
+	* This copies the whole grid, use GetSpawnedBlockIDOnTile when possible.
+	*/
 	UFUNCTION(BlueprintPure, Category = "BlockManager")
 	TArray<int> GetSpawnedBlockIDs();
 
-	/* Accessor - Returns the array of spawned blocks where index = index of the tile, and element = reference to the ATT_Block object. */
+	/* Accessor - Returns the array of spawned blocks where index = index of the tile, and element = reference to the ATT_Block object. 
+	* This copies the whole grid, use GetSpawnedBlockOnTile when possible.
+	*/
 	UFUNCTION(BlueprintPure, Category = "BlockManager")
 	TArray<ATT_Block*> GetSpawnedBlocks();
 
+	/* Accessor - Returns the zone ID of a tile, 0 if the tile isn't part of a zone. */
+	UFUNCTION(BlueprintPure, Category = "BlockManager")
+	int GetSpawnedZoneIDOnTile(int tileID);
+
+	/* Accessor - Returns the block ID of the block owning a tile, 0 if the tile is free. */
+	UFUNCTION(BlueprintPure, Category = "BlockManager")
+	int GetSpawnedBlockIDOnTile(int tileID);
+
+	/* Accessor - Returns the block owning a tile, nullptr if the tile is free or if the block is drawn as an instance. */
+	UFUNCTION(BlueprintPure, Category = "BlockManager")
+	ATT_Block* GetSpawnedBlockOnTile(int tileID);
+
+	/**
+	* Returns the actor of the block owning a tile, nullptr if the tile is free.
+	* If the block is drawn as an instance, its actor is spawned & replaces the instance until ReturnBlockToInstance is called.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "BlockManager")
+	ATT_Block* GetOrSpawnBlockActorOnTile(int tileID);
+
+	/** Pools (or destroys) the actor of a block that doesn't need it anymore (e.g. deselected) and draws the block as an instance again. 
+	* Does nothing if instanced rendering is off or if the block requires its actor. */
+	UFUNCTION(BlueprintCallable, Category = "BlockManager")
+	void ReturnBlockToInstance(ATT_Block* block);
+
+	/** Displays every queued block now, regardless of the budget. */
+	UFUNCTION(BlueprintCallable, Category = "BlockManager")
+	void FlushSpawnQueue();
+
+	/** Returns the number of blocks owning their tiles but still waiting in the spawn queue to be displayed. */
+	UFUNCTION(BlueprintPure, Category = "BlockManager")
+	int GetNumberOfQueuedBlocks() const;
+
+	/** Called each frame the spawn queue displays blocks. */
+	UPROPERTY(BlueprintAssignable, Category = "BlockManager")
+	FTT_OnSpawnQueueProgress OnSpawnQueueProgress;
+
+	/** Called when the spawn queue has displayed all its blocks. */
+	UPROPERTY(BlueprintAssignable, Category = "BlockManager")
+	FTT_OnSpawnQueueEmptied OnSpawnQueueEmptied;
+
+	/**
+	* Spawns deactivated blocks into the pool of a block's class until it holds count blocks, so that bulk road & zone edits reuse them
+	* instead of spawning new actors. Limited by maxPooledBlocksPerClass.
+	* @param blockID Data table index of the row corresponding to the block.
+	* @param count Number of blocks the pool should hold.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "BlockManager")
+	void PrewarmBlockActorPool(int blockID, int count);
+
+	/**
+	* Deactivates a block that was removed from the grid and keeps it for the next block of its class.
+	* Returns false if the block wasn't pooled (pool disabled or full), it is then up to the caller to destroy it.
+	*/
+	bool ReleaseBlockActor(ATT_Block* block);
+
+	/* Accessor - Returns the handle of the block owning a tile, unset if the tile is free. */
+	FTT_BlockHandle GetBlockHandleOnTile(int tileID) const;
+
+	/* Accessor - Returns every block spawned on the grid (see FTT_BlockStore). */
+	const FTT_BlockStore& GetBlockStore() const { return blockStore; }
+
 	
 
 	/*---------- Variables -----------*/
 	
-		/** Tile Array - Array of spawned block IDs where index = index of the tile, and element = BlockID.*/
-	TArray<int> spawnedBlockID;
+	/** Every block spawned on the grid, referred to by handles. */
+	FTT_BlockStore blockStore;
+
+	/** Tile Array - Spawned blocks where index = index of the tile, and element = handle of the block in blockStore.*/
+	TTT_ChunkedTileLayer<FTT_BlockHandle> spawnedBlockHandles;
+
+	/** Tile Array - Spawned zone IDs where index = index of the tile, and element = BlockID. */
+	TTT_ChunkedTileLayer<int> spawnedZoneID;
+
+	/** Tile Array - One bit per tile, set if a block owns the tile. Mirrors spawnedBlockHandles for rectangle checks. */
+	FTT_OccupancyBitboard blockOccupancy;
 
-	/** Tile Array - Array of spawned zone IDs where index = index of the tile, and element = BlockID. */
-	TArray<int> spawnedZoneID;
+	/** Placement validity maps of the footprints checked lately, kept up to date with blockOccupancy. */
+	TArray<FTT_PlacementValidityMap> placementValidityMaps;
 
-	/** Tile Array - Array of spawned blocks where index = index of the tile, and element = TT_Block instance.*/
-	TArray<ATT_Block*> spawnedBlocks;
+	/** Called when tiles are given to or taken from blocks, lets the pathfinders update what they precomputed. */
+	FTT_OnBlockOccupancyChanged OnBlockOccupancyChanged;
 
 	/** Reference to the GridManager who created this block manager.*/
 	ATT_GridManager* GridManager;
@@ -0,0 +1,136 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Every block spawned on the grid, stored as a structure of arrays.
+	A block is referred to by a handle (slot index + generation). Removing a block bumps its slot's generation, so handles
+	kept elsewhere (tiles, UI, simulation) can never reach the block that reuses the slot. Generations never wrap around: a slot
+	reaching the last one is retired for good (after 254 blocks, out of 16 million slots).
+	The blocks' values are kept packed in dense arrays (removal swaps the last block in), iterating all blocks is a linear scan. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_Global.h"
+
+class ATT_Block;
+
+/** 32 bit reference to a block of the store: 24 bits of slot index, 8 bits of generation. 0 is never a valid handle. */
+struct FTT_BlockHandle
+{
+	uint32 Value;
+
+	FTT_BlockHandle()
+		: Value(0)
+	{
+	}
+
+	FTT_BlockHandle(int32 slotIndex, uint8 generation)
+		: Value((uint32(generation) << 24) | (uint32(slotIndex) & 0x00FFFFFF))
+	{
+	}
+
+	FORCEINLINE bool IsSet() const { return Value != 0; }
+	FORCEINLINE int32 GetSlotIndex() const { return int32(Value & 0x00FFFFFF); }
+	FORCEINLINE uint8 GetGeneration() const { return uint8(Value >> 24); }
+
+	FORCEINLINE bool operator==(const FTT_BlockHandle& other) const { return Value == other.Value; }
+	FORCEINLINE bool operator!=(const FTT_BlockHandle& other) const { return Value != other.Value; }
+
+	friend FORCEINLINE uint32 GetTypeHash(const FTT_BlockHandle& handle) { return handle.Value; }
+};
+
+/** Where a block is in its life on the grid. */
+enum class ETT_BlockState : uint8
+{
+	Reserved,	// Owns its tiles, nothing is displayed yet
+	Spawned,	// Owns its tiles and is displayed by its actor
+	Instanced	// Owns its tiles and is displayed as an instance of the block manager's instanced meshes
+};
+
+class FTT_BlockStore
+{
+public:
+
+	/** Largest number of slots a store can use (24 bits of slot index). */
+	static int32 GetMaxBlocks() { return 0x00FFFFFF; }
+
+	/** Generation of the retired slots, no handle is ever made with it. */
+	static FORCEINLINE uint8 GetRetiredGeneration() { return MAX_uint8; }
+
+	/** Removes every block, all the handles handed out so far become stale. */
+	void Reset();
+
+	/**
+	* Adds a block to the store.
+	* @return The block's handle, unset if the store is full.
+	*/
+	FTT_BlockHandle Add(int32 blockID, int32 centralTileID, float yaw, const FTT_TileRect& tileRect);
+
+	/** Removes a block, returns false if the handle was already stale. */
+	bool Remove(FTT_BlockHandle handle);
+
+	/** Returns the block's index in the dense arrays, INDEX_NONE if the handle is stale. */
+	FORCEINLINE int32 GetIndex(FTT_BlockHandle handle) const
+	{
+		const int32 slotIndex = handle.GetSlotIndex();
+		if (!handle.IsSet() || !SlotGenerations.IsValidIndex(slotIndex) || SlotGenerations[slotIndex] != handle.GetGeneration())
+		{
+			return INDEX_NONE;
+		}
+		return SlotDenseIndices[slotIndex];
+	}
+
+	FORCEINLINE bool IsValid(FTT_BlockHandle handle) const { return GetIndex(handle) != INDEX_NONE; }
+
+	/** Number of blocks in the store, the dense arrays below all have that many elements. */
+	FORCEINLINE int32 Num() const { return Handles.Num(); }
+
+	/** Dense arrays, all indexed the same way (see GetIndex). Their order changes when blocks are removed. */
+	const TArray<FTT_BlockHandle>& GetHandles() const { return Handles; }
+	const TArray<int32>& GetBlockIDs() const { return BlockIDs; }
+	const TArray<int32>& GetCentralTileIDs() const { return CentralTileIDs; }
+	const TArray<float>& GetYaws() const { return Yaws; }
+	const TArray<FTT_TileRect>& GetTileRects() const { return TileRects; }
+	const TArray<ETT_BlockState>& GetStates() const { return States; }
+	const TArray<ATT_Block*>& GetActors() const { return Actors; }
+	const TArray<int32>& GetInstanceIndices() const { return InstanceIndices; }
+
+	/** Per block accessors, default values for stale handles. */
+	int32 GetBlockID(FTT_BlockHandle handle) const;
+	int32 GetCentralTileID(FTT_BlockHandle handle) const;
+	float GetYaw(FTT_BlockHandle handle) const;
+	FTT_TileRect GetTileRect(FTT_BlockHandle handle) const;
+	ATT_Block* GetActor(FTT_BlockHandle handle) const;
+	ETT_BlockState GetState(FTT_BlockHandle handle) const;
+	int32 GetInstanceIndex(FTT_BlockHandle handle) const;
+
+	void SetState(FTT_BlockHandle handle, ETT_BlockState state);
+	void SetActor(FTT_BlockHandle handle, ATT_Block* actor);
+	void SetInstanceIndex(FTT_BlockHandle handle, int32 instanceIndex);
+
+private:
+
+	/** Per slot, generation of the block using it (or of the next one once free). */
+	TArray<uint8> SlotGenerations;
+
+	/** Per slot, index of its block in the dense arrays. */
+	TArray<int32> SlotDenseIndices;
+
+	/** Slots of removed blocks, reused first. Retired slots are never in it. */
+	TArray<int32> FreeSlots;
+
+	/** Bumps the generation of a slot whose block was removed, then frees or retires it. */
+	void ReleaseSlot(int32 slotIndex);
+
+	TArray<FTT_BlockHandle> Handles;
+	TArray<int32> BlockIDs;
+	TArray<int32> CentralTileIDs;
+	TArray<float> Yaws;
+	TArray<FTT_TileRect> TileRects;
+	TArray<ETT_BlockState> States;
+
+	/** Actor displaying the block, nullptr until it is spawned. The actors are kept alive by the level. */
+	TArray<ATT_Block*> Actors;
+
+	/** Instance drawing the block in its mesh's instanced component, INDEX_NONE unless the block is Instanced. */
+	TArray<int32> InstanceIndices;
+};
@@ -0,0 +1,145 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Per tile storage split into the grid's chunks (see FTT_GridTopology).
+	A chunk's array is only allocated once one of its tiles holds something other than the default value,
+	and is freed again once all of its tiles are back to the default value. An empty chunk costs an empty TArray. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_GridTopology.h"
+
+template<typename ElementType>
+class TTT_ChunkedTileLayer
+{
+public:
+
+	TTT_ChunkedTileLayer()
+		: DefaultValue()
+	{
+	}
+
+	/**
+	* Sizes the layer for a grid and resets every tile to defaultValue.
+	* @param topology Grid the layer stores values for.
+	* @param defaultValue Value of the tiles that have never been set, this value is never allocated.
+	*/
+	void Init(const FTT_GridTopology& topology, const ElementType& defaultValue)
+	{
+		Topology = topology;
+		DefaultValue = defaultValue;
+
+		Chunks.Empty(Topology.GetNumChunks());
+		Chunks.SetNum(Topology.GetNumChunks());
+		ChunkUsage.Init(0, Topology.GetNumChunks());
+	}
+
+	/** Checks if a tileID exists on the layer's grid. */
+	FORCEINLINE bool IsTileValid(int32 tileID) const
+	{
+		return Topology.IsTileValid(tileID);
+	}
+
+	/** Returns the value of a tile, the default value if its chunk was never allocated. */
+	FORCEINLINE const ElementType& Get(int32 tileID) const
+	{
+		const TArray<ElementType>& chunk = Chunks[Topology.GetChunkIndex(tileID)];
+		return chunk.Num() > 0 ? chunk[Topology.GetChunkLocalIndex(tileID)] : DefaultValue;
+	}
+
+	FORCEINLINE const ElementType& operator[](int32 tileID) const
+	{
+		return Get(tileID);
+	}
+
+	/** Sets the value of a tile, allocating or freeing its chunk when needed. */
+	void Set(int32 tileID, const ElementType& value)
+	{
+		const int32 chunkIndex = Topology.GetChunkIndex(tileID);
+		TArray<ElementType>& chunk = Chunks[chunkIndex];
+		const bool isDefaultValue = value == DefaultValue;
+
+		if (chunk.Num() == 0)
+		{
+			if (isDefaultValue)
+			{
+				return;
+			}
+			chunk.Init(DefaultValue, Topology.GetChunkNumTiles(chunkIndex));
+		}
+
+		ElementType& element = chunk[Topology.GetChunkLocalIndex(tileID)];
+		const bool wasDefaultValue = element == DefaultValue;
+		element = value;
+
+		ChunkUsage[chunkIndex] += int32(wasDefaultValue) - int32(isDefaultValue);
+
+		if (ChunkUsage[chunkIndex] == 0)
+		{
+			chunk.Empty();
+		}
+	}
+
+	/** Sets a tile back to the default value. */
+	FORCEINLINE void Reset(int32 tileID)
+	{
+		Set(tileID, DefaultValue);
+	}
+
+	/** Returns true if at least one tile of the chunk holds a value. */
+	FORCEINLINE bool IsChunkAllocated(int32 chunkIndex) const
+	{
+		return Chunks[chunkIndex].Num() > 0;
+	}
+
+	/** Returns the number of tiles holding something other than the default value. */
+	int32 GetNumUsedTiles() const
+	{
+		int32 numUsedTiles = 0;
+		for (int32 usage : ChunkUsage)
+		{
+			numUsedTiles += usage;
+		}
+		return numUsedTiles;
+	}
+
+	/** Returns the memory used by the layer in bytes. */
+	SIZE_T GetAllocatedSize() const
+	{
+		SIZE_T allocatedSize = Chunks.GetAllocatedSize() + ChunkUsage.GetAllocatedSize();
+		for (const TArray<ElementType>& chunk : Chunks)
+		{
+			allocatedSize += chunk.GetAllocatedSize();
+		}
+		return allocatedSize;
+	}
+
+	/** Copies the layer into a flat array where index = tileID. Expensive on large grids, only meant for blueprints. */
+	TArray<ElementType> ToArray() const
+	{
+		TArray<ElementType> result;
+		result.Init(DefaultValue, Topology.GetNumTiles());
+
+		for (int32 chunkIndex = 0; chunkIndex < Chunks.Num(); chunkIndex++)
+		{
+			const TArray<ElementType>& chunk = Chunks[chunkIndex];
+			for (int32 localIndex = 0; localIndex < chunk.Num(); localIndex++)
+			{
+				result[Topology.GetChunkTileID(chunkIndex, localIndex)] = chunk[localIndex];
+			}
+		}
+		return result;
+	}
+
+private:
+
+	FTT_GridTopology Topology;
+
+	ElementType DefaultValue;
+
+	/** One array per chunk, empty while the chunk only holds the default value. */
+	TArray<TArray<ElementType>> Chunks;
+
+	/** Number of tiles holding something other than the default value in each chunk. */
+	TArray<int32> ChunkUsage;
+};
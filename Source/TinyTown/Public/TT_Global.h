@@ -18,6 +18,36 @@ enum class EBlockType : uint8
 	BT_Nothing			UMETA(DisplayName = "Nothing", ToolTip = "Will do nothing.")
 };
 
+/** Tile overlay layers, a layer overrides the visual of the layers above it in this list (see FTT_TileOverlayCompositor). */
+UENUM(BlueprintType)
+enum class ETileOverlay : uint8
+{
+	TO_ViewMode 		UMETA(DisplayName = "View Mode", ToolTip = "Colours applied by view modes, stays under everything else."),
+	TO_Selection		UMETA(DisplayName = "Selection", ToolTip = "Tiles selected by the player (zone being built, tiles being removed)."),
+	TO_Preview 			UMETA(DisplayName = "Preview", ToolTip = "Build & remove tools previews."),
+	TO_Error			UMETA(DisplayName = "Error", ToolTip = "Tiles the player can't use."),
+	TO_Click			UMETA(DisplayName = "Click", ToolTip = "Tile being clicked."),
+	TO_Hover			UMETA(DisplayName = "Hover", ToolTip = "Tile under the mouse cursor."),
+	TO_Count			UMETA(Hidden)
+};
+
+/** Which zone building sizes are placed first when a zone is filled (see FTT_ZonePacker). */
+UENUM(BlueprintType)
+enum class EZonePackingPreference : uint8
+{
+	ZP_LargestFirst 	UMETA(DisplayName = "Largest First", ToolTip = "Fills the zone with as few buildings as possible."),
+	ZP_SmallestFirst	UMETA(DisplayName = "Smallest First", ToolTip = "Fills the zone with as many buildings as possible.")
+};
+
+/** Search used by UTT_Pathfinder::FindShortestPath. A* & Jump Point Search give paths of the same cost. */
+UENUM(BlueprintType)
+enum class EGridPathfinding : uint8
+{
+	GP_AStar 			UMETA(DisplayName = "A*", ToolTip = "Opens every tile on the way, see FTT_AStarSearch."),
+	GP_JumpPointSearch	UMETA(DisplayName = "Jump Point Search", ToolTip = "Jumps over runs of free tiles with precomputed jumps, see FTT_JumpPointSearch. Much faster on open land."),
+	GP_Hierarchical		UMETA(DisplayName = "Hierarchical", ToolTip = "Plans over the grid's chunks then refines, see FTT_HierarchicalPathSearch. For long distances, paths are slightly longer than the shortest.")
+};
+
 /** This struct is used to store all the relevant data to identify a block. */
 USTRUCT(BlueprintType)
 struct FTT_Struct_Block : public FTableRowBase
@@ -57,6 +87,10 @@ struct FTT_Struct_Block : public FTableRowBase
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FStruct_Block")
 		TSubclassOf<ATT_Block> BlockClass;
 
+	/** If true, this block always gets its own actor (e.g. its class has Blueprint behaviour). Otherwise the block manager may draw it as an instance of its mesh. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FStruct_Block")
+		bool Requires_Actor = false;
+
 	/** Not properly implemented yet. So far, only used for viewmode filters. */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "FStruct_Block")
 		FLinearColor Grid_Colour;
@@ -117,3 +151,73 @@ struct FTT_Struct_Inventory : public FTableRowBase
 		int32 Production;
 
 };
+
+/** A rectangle of tiles (zones, block footprints, tool selections). Min is the column (X) and row (Y) of its first tile, Size its number of columns and rows. */
+USTRUCT(BlueprintType)
+struct FTT_TileRect
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** Column (X) and row (Y) of the rectangle's first tile. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tile Rect")
+		FIntPoint Min;
+
+	/** Number of columns (X) and rows (Y) of the rectangle. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Tile Rect")
+		FIntPoint Size;
+
+	FTT_TileRect()
+		: Min(0, 0)
+		, Size(0, 0)
+	{
+	}
+
+	FTT_TileRect(FIntPoint min, FIntPoint size)
+		: Min(min)
+		, Size(size)
+	{
+	}
+
+	/** Makes the rectangle delimited by two opposite corner coordinates (inclusive, any order). */
+	static FTT_TileRect FromCorners(FIntPoint cornerA, FIntPoint cornerB)
+	{
+		const FIntPoint min(FMath::Min(cornerA.X, cornerB.X), FMath::Min(cornerA.Y, cornerB.Y));
+		const FIntPoint max(FMath::Max(cornerA.X, cornerB.X), FMath::Max(cornerA.Y, cornerB.Y));
+		return FTT_TileRect(min, max - min + FIntPoint(1, 1));
+	}
+
+	bool IsEmpty() const { return Size.X <= 0 || Size.Y <= 0; }
+
+	/** Number of tiles in the rectangle. */
+	int32 GetArea() const { return IsEmpty() ? 0 : Size.X * Size.Y; }
+
+	/** Column (X) and row (Y) of the rectangle's last tile. */
+	FIntPoint GetMax() const { return Min + Size - FIntPoint(1, 1); }
+
+	bool Contains(FIntPoint coordinate) const
+	{
+		return coordinate.X >= Min.X && coordinate.X < Min.X + Size.X && coordinate.Y >= Min.Y && coordinate.Y < Min.Y + Size.Y;
+	}
+
+	/** Returns true if other is entirely inside this rectangle. */
+	bool Contains(const FTT_TileRect& other) const
+	{
+		return !other.IsEmpty() && Contains(other.Min) && Contains(other.GetMax());
+	}
+
+	bool Intersects(const FTT_TileRect& other) const
+	{
+		return !GetIntersection(other).IsEmpty();
+	}
+
+	/** Returns the tiles shared by both rectangles, empty if there are none. */
+	FTT_TileRect GetIntersection(const FTT_TileRect& other) const
+	{
+		const FIntPoint min(FMath::Max(Min.X, other.Min.X), FMath::Max(Min.Y, other.Min.Y));
+		const FIntPoint max(FMath::Min(Min.X + Size.X, other.Min.X + other.Size.X), FMath::Min(Min.Y + Size.Y, other.Min.Y + other.Size.Y));
+		return FTT_TileRect(min, FIntPoint(FMath::Max(max.X - min.X, 0), FMath::Max(max.Y - min.Y, 0)));
+	}
+
+	bool operator==(const FTT_TileRect& other) const { return Min == other.Min && Size == other.Size; }
+	bool operator!=(const FTT_TileRect& other) const { return !(*this == other); }
+};
@@ -4,6 +4,10 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "TT_GridTopology.h"
+#include "TT_GridQuery.h"
+#include "TT_TileVisualBuffer.h"
+#include "TT_TileOverlay.h"
 #include "TT_GridManager.generated.h"
 
 class UPaperGroupedSpriteComponent;
@@ -25,6 +29,8 @@ public:
 
 	virtual void OnConstruction(const FTransform& Transform) override;
 
+	virtual void Tick(float DeltaTime) override;
+
 
 protected:
 
@@ -36,21 +42,55 @@ protected:
 	/*---------- Functions -----------*/
 	virtual void BeginPlay() override;
 
-	/*Spawns a grid of tile instances separated by distance in a x by y grid, centered around Center.
-	* Calculates all tiles locations & stores them in tileLocations, then spawns the instances using tileSpriteNormal.
-	* The tiles will be spawned around a center point.
-	* @param x Size X in tiles of the grid.
-	* @param y Size Y in tiles of the grid.
-	* @param Center Center point world location.
-	* @param Distance between each tiles in UE units.
+	/*Spawns a grid of gridSizeX by gridSizeY tile instances separated by distanceBetweenTiles, centered around the GridManager.
+	* Creates one sprite component per grid chunk, calculates the chunk's tiles locations in one go, then spawns the instances using tileSpriteNormal.
 	*/
-	void SpawnTiles(int x, int y, FVector center, float distance);
+	void SpawnTiles();
+
+	/* Spawns a single tile instance in its chunk's component (and its TextRender if displayTileID is enabled). */
+	void SpawnTileInstance(UPaperGroupedSpriteComponent* chunkComp, int tileID, const FVector& newLocation, const FQuat& tileRotation);
+
+	/* Destroys all the chunk components and the tile ID TextRenders. */
+	void ClearTiles();
+
+	/* Returns the chunk component displaying a tile, and the tile's instance index in that component. */
+	UPaperGroupedSpriteComponent* GetTileChunkComponent(int tileID, int& OutInstanceIndex) const;
+
+	/* Returns the world transform of a tile's instance for a given scale, calculated from the tile's location. */
+	FTransform GetTileInstanceTransform(int tileID, float scale) const;
+
+	/* Tile instance accessors, they only mark the tile's chunk as dirty (see FlushDirtyTileChunks). */
+	void UpdateTileInstanceTransform(int tileID, const FTransform& newTransform, bool WorldSpace);
+	void UpdateTileInstanceColour(int tileID, const FLinearColor& colour);
+
+	/* Queues a chunk's render state to be rebuilt at the end of the frame. */
+	void MarkTileChunkDirty(int chunkIndex);
+
+	/* Makes sure FlushTileVisuals() runs at the end of the frame (immediately outside of the game). */
+	void QueueTileVisualFlush();
+
+	/* Pushes the tile visuals recorded during the frame to their instances, then rebuilds the dirty chunks. */
+	void FlushTileVisuals();
+
+	/* Rebuilds the render state of every chunk modified since the last flush, once per chunk. */
+	void FlushDirtyTileChunks();
 
 	/*
 	 * Spawns a BlockManager object (there can only be one at all times).
 	 */
 	void SpawnBlockManager();
 
+	/* Updates gridTopology from gridSizeX and gridSizeY. */
+	void RefreshGridTopology();
+
+	/* Returns the location of a tile relative to the GridManager, calculated from its row and column. */
+	FVector GetTileRelativeLocation(int tileID) const;
+
+	/* Returns the matrix transforming a tile coordinate (column, row, 0, 1) into its location.
+	* @param WorldSpace Whether or not the matrix should include the GridManager's transform.
+	*/
+	FMatrix GetTileCoordinateMatrix(bool WorldSpace) const;
+
 
 	/*---------- Variables -----------*/
 
@@ -75,29 +115,32 @@ protected:
 		bool displayTileID;
 
 
-	/* Array of all Tile IDs in order. */
-	TArray<int> tileIDs;
-	
-	/* Array of all spawned tile instances locations. */
-	TArray<FVector> tileLocations; 
+	/* Integer layout of the grid, answers neighbour queries without touching the sprite component. */
+	FTT_GridTopology gridTopology;
+
+	/* One grouped sprite component per grid chunk, index = chunk index and instance index = tile index inside the chunk. 
+	* Altering a tile only rebuilds its own chunk.
+	*/
+	UPROPERTY()
+	TArray<UPaperGroupedSpriteComponent*> tileChunkComps;
+
+	/* Chunks altered since the last FlushDirtyTileChunks(). */
+	TArray<int32> dirtyTileChunks;
+
+	/* Colour & scale changes recorded during the frame, coalesced per tile and flushed once in FlushTileVisuals(). */
+	FTT_TileVisualBuffer tileVisualBuffer;
 
 
 	/* TileID of the currently clicked tile. */
 	int32 lastClickedTile; 	
 
-	/* Array of all tiles that have been altered. */
-	TArray<int32> modifiedTiles; 
+	/* Hover, click, selection, previews and view modes. Each layer knows its tiles, changing a layer only composites the tiles it affects. */
+	FTT_TileOverlayCompositor tileOverlays;
 
 
 	/* Timer responsible of the view mode tile refreshing. */
 	FTimerHandle TimerHandler_ViewMode;
 
-
-	/** Array of all the tiles affected by view modes. */
-	TArray<int> viewModeTiles;
-
-	TArray<int> playerTileSelection;
-
 	/* These are the object responsible for displaying the tiles IDs on the grid. */
 	TArray<ATextRenderActor*> tileIDActors;
 	  
@@ -105,6 +148,8 @@ protected:
 public:	
 
 	/*---------- Components ----------*/
+
+	/* Holds no instances, its settings (materials, collision etc ...) are used as a template for the chunk components. */
 	UPROPERTY(VisibleDefaultsOnly)
 		UPaperGroupedSpriteComponent* instanceGroupedSpriteComp;
 
@@ -157,6 +202,9 @@ public:
 	/* Returns the size of the grid in a 2D Vector (set via the grid's instanced object). */
 	FVector2D GetGridSize();
 
+	/* Returns the integer layout of the grid (neighbours, rows and columns). */
+	const FTT_GridTopology& GetGridTopology() const;
+
 	/* Returns this tiles location if valid.
 	*	@param tileID TileID (instance index) of the tile.
 	*	@param WorldSpace Whether or not this should return the world location or relative to the GridManager.
@@ -165,6 +213,39 @@ public:
 	UFUNCTION(BlueprintPure, Category = "GridManager")
 	FVector GetTileLocation(int tileID, bool WorldSpace);
 
+	/* Batch version of GetTileLocation, converts every tile with SIMD maths. Invalid tiles get a zero vector.
+	*	@param tileIDsToConvert TileIDs to get the locations of.
+	*	@param OutLocations Location of each tile, in the same order.
+	*	@param WorldSpace Whether or not this should return world locations or relative to the GridManager.
+	*/
+	void GetTileLocations(const TArray<int>& tileIDsToConvert, TArray<FVector>& OutLocations, bool WorldSpace) const;
+
+	/* Returns the tile under a location, -1 if the location is off the grid.
+	*	@param location Location to convert, only its X and Y matter once relative to the GridManager.
+	*	@param WorldSpace Whether or not location is in world space or relative to the GridManager.
+	*/
+	UFUNCTION(BlueprintPure, Category = "GridManager")
+	int GetTileIDFromLocation(FVector location, bool WorldSpace) const;
+
+	/* Returns the tile where a ray crosses the grid's plane, -1 if it doesn't cross it or crosses it off the grid. No physics involved.
+	*	@param rayOrigin World location the ray starts from (e.g. the deprojected mouse cursor).
+	*	@param rayDirection World direction of the ray.
+	*/
+	UFUNCTION(BlueprintPure, Category = "GridManager")
+	int GetTileIDFromRay(FVector rayOrigin, FVector rayDirection) const;
+
+	/* Returns where a ray crosses the grid's plane (in world space), false if it doesn't cross it.
+	*	@param rayOrigin World location the ray starts from.
+	*	@param rayDirection World direction of the ray.
+	*/
+	bool GetRayGridIntersection(FVector rayOrigin, FVector rayDirection, FVector& OutLocation) const;
+
+	/* Returns the continuous grid coordinate (X = column, Y = row) of a location, a tile covering [column, column + 1[.
+	*	@param location Location to convert, only its X and Y matter once relative to the GridManager.
+	*	@param WorldSpace Whether or not location is in world space or relative to the GridManager.
+	*/
+	FVector2D GetGridCoordinateFromLocation(FVector location, bool WorldSpace) const;
+
 	/* Returns the tile's neighbours in a clockwise order. If one direction doesn't have a neighbour, nothing will be returned.
 	* AllNeighboursTileID returns -1 when a tile doesn't exist, this allows you to use array index to get a specific direction.
 	* Direction index: Right 0 - Bottom 1 - Left 2 - Top 3.
@@ -182,17 +263,61 @@ public:
 	*/
 	TArray<int> GetTileNeighbours(int tileID, bool allowDiagonalPaths);
 
+	/* Area queries, allocation free (see TT_GridQuery.h). The visitor takes a tileID and returns false to stop the query.
+	* They return false if the visitor stopped the query.
+	*/
+
+	/* Visits the tiles of the rectangle delimited by two opposite corner tiles. */
+	template<typename VisitorType>
+	bool ForEachTileInRect(int tileA, int tileB, VisitorType&& visitor) const
+	{
+		if (!gridTopology.IsTileValid(tileA) || !gridTopology.IsTileValid(tileB))
+		{
+			return true;
+		}
+		return FTT_GridQuery::ForEachTileInRect(gridTopology, gridTopology.GetTileCoordinate(tileA), gridTopology.GetTileCoordinate(tileB), Forward<VisitorType>(visitor));
+	}
+
+	/* Visits the tiles within radius of a tile (included). */
+	template<typename VisitorType>
+	bool ForEachTileInRadius(int tileID, int radius, ETT_TileDistance distance, VisitorType&& visitor) const
+	{
+		return FTT_GridQuery::ForEachTileInRadius(gridTopology, tileID, radius, distance, Forward<VisitorType>(visitor));
+	}
+
+	/* Visits the tiles exactly radius away from a tile. */
+	template<typename VisitorType>
+	bool ForEachTileInRing(int tileID, int radius, ETT_TileDistance distance, VisitorType&& visitor) const
+	{
+		return FTT_GridQuery::ForEachTileInRing(gridTopology, tileID, radius, distance, Forward<VisitorType>(visitor));
+	}
+
+	/* Range view over the rectangle delimited by two opposite corner tiles, usable in a range based for loop. */
+	FTT_TileRectView GetTileRectView(int tileA, int tileB) const;
+
+	/* Allocation free version of GetTileNeighbours, to be used in loops (pathfinding, buildable tile search etc ...).
+	* @param tileID Specified tileID.
+	* @param allowDiagonalPaths Include the diagonal neighbours.
+	*/
+	FTT_TileNeighbours GetTileNeighboursFast(int tileID, bool allowDiagonalPaths) const;
+
 	/* Checks if a tileID exists on the grid. */
 	UFUNCTION(BlueprintPure, Category = "GridManager")
 	bool IsTileValid(int tileID);
 
-	/** Returns an array of all tile IDs in order. */
+	/* Returns the tile displayed by an instance of one of the grid's components (e.g. from a hit result), -1 if it isn't a tile.
+	* @param component Component that was hit.
+	* @param instanceIndex Instance index in that component (FHitResult::Item).
+	*/
+	int GetTileIDFromInstance(const UPrimitiveComponent* component, int instanceIndex) const;
+
+	/** Returns an array of all tile IDs in order. Built on every call, prefer GetGridTopology().GetNumTiles() in C++. */
 	UFUNCTION(BlueprintPure, Category = "GridManager")
 	TArray<int> GetAllTileIDs();
 
 
 
-	/* Reset this tile to its original state (colour and transform). */
+	/* Reset this tile to its original state (colour and transform), removing it from every overlay but the view mode one. */
 	UFUNCTION(BlueprintCallable, Category = "Grid Customisation")
 	void TileReset(int tileID);
 
@@ -201,9 +326,16 @@ public:
 	* @param blockID Block ID of the desired colour.
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Grid Customisation")
-	void SetTileColorToBlockID(TArray<int> tileIDs, int blockID);
+	void SetTileColorToBlockID(const TArray<int>& tileIDs, int blockID);
+
+	/* Same as SetTileColorToBlockID, for a rectangle of tiles. */
+	UFUNCTION(BlueprintCallable, Category = "Grid Customisation")
+	void SetTileRectColorToBlockID(FTT_TileRect tileRect, int blockID);
 
-	/* Set the tile a certain color.
+	/* Returns the grid colour of a block (set in data table), dark grey for blockID -1. */
+	FLinearColor GetBlockGridColour(int blockID);
+
+	/* Set the tile a certain color (preview overlay, cleared by TileClearState()).
 	* @param tileID Tile ID to change color.
 	* @param colour Colour to change the tile to.
 	*/
@@ -216,14 +348,27 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Grid Customisation")
 		void SetTileScale(int tileID, float scale);
 
-	/* Reset all altered tiles to their original state. */
+	/* Replaces the tiles of an overlay layer, all of them taking the specified colour.
+	* @param layer Overlay layer to set (view mode, error etc ...).
+	* @param tileIDs Tiles the layer will hold, the tiles previously in the layer and not in this array are removed from it.
+	* @param colour Colour of the tiles, unless a layer with a higher priority overrides it.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Grid Customisation")
+		void SetTileOverlayColour(ETileOverlay layer, const TArray<int>& tileIDs, FLinearColor colour);
+
+	/* Removes all tiles from an overlay layer. */
+	UFUNCTION(BlueprintCallable, Category = "Grid Customisation")
+		void ClearTileOverlay(ETileOverlay layer);
+
+	/* Reset all altered tiles to their original state (hover, click, previews and errors). View modes and the player's selection are kept. */
 	void TileClearState();
 
 
 	/*---------- TODO: REFACTOR -----------*/
 
-	/* Save an array of tiles in order to call ClearPlayerSelection() to reset their color/transform. */
-	void SetPlayerSelection(TArray<int> selectedTileIDs);
+	/* Save an array of tiles (selection overlay) in order to call ClearPlayerSelection() to reset their color/transform. */
+	void SetPlayerSelection(const TArray<int>& selectedTileIDs);
+	void SetPlayerSelection(const FTT_TileRect& selectedTiles);
 
 	/* Clears the TArray of tiles, and reset their colour. */
 	void ClearPlayerSelection();
@@ -0,0 +1,277 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Area queries over tile IDs (rectangles, radii, rings) that never build an array.
+	Every query is clipped to the grid's edges and walks its area row by row, calling a visitor for each tile:
+
+		FTT_GridQuery::ForEachTileInRadius(topology, tileID, 5, ETT_TileDistance::Euclidean, [&](int32 tileID)
+		{
+			...
+			return true; // Return false to stop the query.
+		});
+
+	Rectangles can also be iterated with a range based for loop through FTT_TileRectView. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_GridTopology.h"
+#include "TT_Global.h"
+
+/** How the distance between two tiles is measured by radius & ring queries. */
+enum class ETT_TileDistance : uint8
+{
+	Chebyshev,	// max(columns, rows), a radius is a square
+	Manhattan,	// columns + rows, a radius is a diamond
+	Euclidean	// sqrt(columns^2 + rows^2), a radius is a disc
+};
+
+/** Range view over the tiles of a rectangle (clipped to the grid), in increasing tileID order. */
+struct FTT_TileRectView
+{
+	struct FIterator
+	{
+		int32 TileID;
+		int32 Column;
+		int32 MinColumn;
+		int32 MaxColumn;
+		int32 SizeX;
+
+		FORCEINLINE int32 operator*() const { return TileID; }
+		FORCEINLINE bool operator!=(const FIterator& other) const { return TileID != other.TileID; }
+
+		FORCEINLINE FIterator& operator++()
+		{
+			if (Column < MaxColumn)
+			{
+				Column++;
+				TileID++;
+			}
+			else
+			{
+				// Jump to the first column of the next row
+				TileID += SizeX - (MaxColumn - MinColumn);
+				Column = MinColumn;
+			}
+			return *this;
+		}
+	};
+
+	/** Lowest column (X) and row (Y) of the rectangle, inclusive. */
+	FIntPoint Min;
+
+	/** Highest column (X) and row (Y) of the rectangle, inclusive. */
+	FIntPoint Max;
+
+	int32 SizeX;
+
+	FTT_TileRectView()
+		: Min(0, 0)
+		, Max(-1, -1)
+		, SizeX(0)
+	{
+	}
+
+	/** Takes two opposite corners in any order, the rectangle is clipped to the grid. */
+	FTT_TileRectView(const FTT_GridTopology& topology, const FIntPoint& cornerA, const FIntPoint& cornerB)
+		: SizeX(topology.SizeX)
+	{
+		Min.X = FMath::Max(FMath::Min(cornerA.X, cornerB.X), 0);
+		Min.Y = FMath::Max(FMath::Min(cornerA.Y, cornerB.Y), 0);
+		Max.X = FMath::Min(FMath::Max(cornerA.X, cornerB.X), topology.SizeX - 1);
+		Max.Y = FMath::Min(FMath::Max(cornerA.Y, cornerB.Y), topology.SizeY - 1);
+	}
+
+	/** Iterates over a tile rectangle, clipped to the grid. */
+	FTT_TileRectView(const FTT_GridTopology& topology, const FTT_TileRect& rect)
+		: FTT_TileRectView(rect.IsEmpty() ? FTT_TileRectView() : FTT_TileRectView(topology, rect.Min, rect.GetMax()))
+	{
+	}
+
+	FORCEINLINE bool IsEmpty() const { return Min.X > Max.X || Min.Y > Max.Y; }
+
+	FORCEINLINE int32 Num() const { return IsEmpty() ? 0 : (Max.X - Min.X + 1) * (Max.Y - Min.Y + 1); }
+
+	FORCEINLINE bool Contains(const FIntPoint& coordinate) const
+	{
+		return coordinate.X >= Min.X && coordinate.X <= Max.X && coordinate.Y >= Min.Y && coordinate.Y <= Max.Y;
+	}
+
+	FIterator begin() const
+	{
+		if (IsEmpty())
+		{
+			return end();
+		}
+		return FIterator{ Min.Y * SizeX + Min.X, Min.X, Min.X, Max.X, SizeX };
+	}
+
+	FIterator end() const
+	{
+		if (IsEmpty())
+		{
+			return FIterator{ 0, 0, 0, 0, SizeX };
+		}
+		return FIterator{ (Max.Y + 1) * SizeX + Min.X, Min.X, Min.X, Max.X, SizeX };
+	}
+};
+
+struct FTT_GridQuery
+{
+	/**
+	* Returns how many columns away from the centre a tile can be while staying within radius, on a row rowOffset rows away from the centre.
+	* -1 if no tile of that row is within radius.
+	*/
+	static int32 GetRowHalfWidth(ETT_TileDistance distance, int32 radius, int32 rowOffset)
+	{
+		rowOffset = FMath::Abs(rowOffset);
+		if (radius < 0 || rowOffset > radius)
+		{
+			return -1;
+		}
+
+		switch (distance)
+		{
+		case ETT_TileDistance::Manhattan:
+			return radius - rowOffset;
+
+		case ETT_TileDistance::Euclidean:
+		{
+			// Integer square root, exact even where the float one rounds the wrong way
+			const int32 squaredHalfWidth = radius * radius - rowOffset * rowOffset;
+			int32 halfWidth = FMath::FloorToInt(FMath::Sqrt(float(squaredHalfWidth)));
+
+			while ((halfWidth + 1) * (halfWidth + 1) <= squaredHalfWidth)
+			{
+				halfWidth++;
+			}
+			while (halfWidth * halfWidth > squaredHalfWidth)
+			{
+				halfWidth--;
+			}
+			return halfWidth;
+		}
+
+		default:
+			return radius;
+		}
+	}
+
+	/**
+	* Visits every tile of the rectangle delimited by two opposite corners (inclusive, any order), clipped to the grid.
+	* @return False if the visitor stopped the query.
+	*/
+	template<typename VisitorType>
+	static bool ForEachTileInRect(const FTT_GridTopology& topology, const FIntPoint& cornerA, const FIntPoint& cornerB, VisitorType&& visitor)
+	{
+		for (int32 tileID : FTT_TileRectView(topology, cornerA, cornerB))
+		{
+			if (!visitor(tileID))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/** Same as above, for a tile rectangle. */
+	template<typename VisitorType>
+	static bool ForEachTileInRect(const FTT_GridTopology& topology, const FTT_TileRect& rect, VisitorType&& visitor)
+	{
+		for (int32 tileID : FTT_TileRectView(topology, rect))
+		{
+			if (!visitor(tileID))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	* Visits every tile within radius of a tile (the centre included), clipped to the grid.
+	* @return False if the visitor stopped the query.
+	*/
+	template<typename VisitorType>
+	static bool ForEachTileInRadius(const FTT_GridTopology& topology, int32 centreTileID, int32 radius, ETT_TileDistance distance, VisitorType&& visitor)
+	{
+		if (!topology.IsTileValid(centreTileID))
+		{
+			return true;
+		}
+
+		const FIntPoint centre = topology.GetTileCoordinate(centreTileID);
+		const int32 firstRow = FMath::Max(centre.Y - radius, 0);
+		const int32 lastRow = FMath::Min(centre.Y + radius, topology.SizeY - 1);
+
+		for (int32 row = firstRow; row <= lastRow; row++)
+		{
+			const int32 halfWidth = GetRowHalfWidth(distance, radius, row - centre.Y);
+			if (!VisitRowSpan(topology, row, centre.X - halfWidth, centre.X + halfWidth, visitor))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+	/**
+	* Visits every tile exactly radius away from a tile, clipped to the grid.
+	* For Euclidean distances, the ring holds the tiles further than radius - 1 and within radius.
+	* @return False if the visitor stopped the query.
+	*/
+	template<typename VisitorType>
+	static bool ForEachTileInRing(const FTT_GridTopology& topology, int32 centreTileID, int32 radius, ETT_TileDistance distance, VisitorType&& visitor)
+	{
+		if (!topology.IsTileValid(centreTileID))
+		{
+			return true;
+		}
+
+		const FIntPoint centre = topology.GetTileCoordinate(centreTileID);
+		const int32 firstRow = FMath::Max(centre.Y - radius, 0);
+		const int32 lastRow = FMath::Min(centre.Y + radius, topology.SizeY - 1);
+
+		for (int32 row = firstRow; row <= lastRow; row++)
+		{
+			const int32 outerHalfWidth = GetRowHalfWidth(distance, radius, row - centre.Y);
+			const int32 innerHalfWidth = GetRowHalfWidth(distance, radius - 1, row - centre.Y);
+
+			// Rows outside of the inner area are visited entirely, the others only on both sides of it
+			if (innerHalfWidth < 0)
+			{
+				if (!VisitRowSpan(topology, row, centre.X - outerHalfWidth, centre.X + outerHalfWidth, visitor))
+				{
+					return false;
+				}
+				continue;
+			}
+
+			if (!VisitRowSpan(topology, row, centre.X - outerHalfWidth, centre.X - innerHalfWidth - 1, visitor)
+				|| !VisitRowSpan(topology, row, centre.X + innerHalfWidth + 1, centre.X + outerHalfWidth, visitor))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+
+private:
+
+	/** Visits the tiles of a row between two columns (inclusive), clipped to the grid. */
+	template<typename VisitorType>
+	static FORCEINLINE bool VisitRowSpan(const FTT_GridTopology& topology, int32 row, int32 firstColumn, int32 lastColumn, VisitorType& visitor)
+	{
+		firstColumn = FMath::Max(firstColumn, 0);
+		lastColumn = FMath::Min(lastColumn, topology.SizeX - 1);
+
+		const int32 rowStart = row * topology.SizeX;
+		for (int32 column = firstColumn; column <= lastColumn; column++)
+		{
+			if (!visitor(rowStart + column))
+			{
+				return false;
+			}
+		}
+		return true;
+	}
+};
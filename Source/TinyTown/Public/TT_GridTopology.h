@@ -0,0 +1,283 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Integer description of the grid's layout. Tiles are stored row by row, a tile's ID being row * SizeX + column.
+			_____________
+			|_2_|_5_|_8_|	Column = tileID % SizeX (tileID + 1 moves "Top").
+			|_1_|_4_|_7_|	Row = tileID / SizeX (tileID + SizeX moves "Right").
+			|_0_|_3_|_6_|
+
+	This never touches the sprite component, it only needs the size of the grid. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/** Neighbour directions in the clockwise order used by ATT_GridManager::GetTileNeighbours(). */
+enum class ETT_TileDirection : uint8
+{
+	Right,
+	BottomRight,
+	Bottom,
+	BottomLeft,
+	Left,
+	TopLeft,
+	Top,
+	TopRight,
+	Count
+};
+
+/** Fixed capacity list of tile neighbours. Lives on the stack, can be iterated with a range based for loop. */
+struct FTT_TileNeighbours
+{
+	static const int32 MaxNeighbours = 8;
+
+	int32 TileIDs[MaxNeighbours];
+	int32 Num;
+
+	FTT_TileNeighbours()
+		: Num(0)
+	{
+	}
+
+	FORCEINLINE void Add(int32 tileID) { TileIDs[Num++] = tileID; }
+	FORCEINLINE int32 operator[](int32 index) const { return TileIDs[index]; }
+
+	FORCEINLINE const int32* begin() const { return TileIDs; }
+	FORCEINLINE const int32* end() const { return TileIDs + Num; }
+
+	/** Copies the neighbours into an array (for blueprint exposed functions). */
+	TArray<int> ToArray() const
+	{
+		return TArray<int>(TileIDs, Num);
+	}
+};
+
+/** Describes how tiles relate to each other on a SizeX by SizeY grid. */
+struct FTT_GridTopology
+{
+	/** Chunks are square groups of ChunkSize by ChunkSize tiles (smaller on the last row/column of chunks). */
+	static FORCEINLINE int32 GetChunkSize() { return 64; }
+	static FORCEINLINE int32 GetChunkShift() { return 6; }
+
+	/** Number of columns (tiles on the X axis). */
+	int32 SizeX;
+
+	/** Number of rows (tiles on the Y axis). */
+	int32 SizeY;
+
+	/** Column offset of an ETT_TileDirection. */
+	static FORCEINLINE int32 GetDirectionColumn(int32 direction)
+	{
+		static const int32 columns[8] = { 0, -1, -1, -1, 0, 1, 1, 1 };
+		return columns[direction];
+	}
+
+	/** Row offset of an ETT_TileDirection. */
+	static FORCEINLINE int32 GetDirectionRow(int32 direction)
+	{
+		static const int32 rows[8] = { 1, 1, 0, -1, -1, -1, 0, 1 };
+		return rows[direction];
+	}
+
+	FTT_GridTopology()
+		: SizeX(0)
+		, SizeY(0)
+	{
+		FMemory::Memzero(NeighbourOffsets);
+	}
+
+	FTT_GridTopology(int32 sizeX, int32 sizeY)
+	{
+		SetSize(sizeX, sizeY);
+	}
+
+	void SetSize(int32 sizeX, int32 sizeY)
+	{
+		SizeX = FMath::Max(sizeX, 0);
+		SizeY = FMath::Max(sizeY, 0);
+
+		for (int32 i = 0; i < 8; i++)
+		{
+			NeighbourOffsets[i] = GetDirectionRow(i) * SizeX + GetDirectionColumn(i);
+		}
+	}
+
+	/** Total number of tiles on the grid. */
+	FORCEINLINE int32 GetNumTiles() const { return SizeX * SizeY; }
+
+	/** Checks if a tileID exists on the grid. */
+	FORCEINLINE bool IsTileValid(int32 tileID) const { return tileID >= 0 && tileID < SizeX * SizeY; }
+
+	FORCEINLINE int32 GetColumn(int32 tileID) const { return tileID % SizeX; }
+	FORCEINLINE int32 GetRow(int32 tileID) const { return tileID / SizeX; }
+
+	/** Checks if a coordinate (X = column, Y = row) is on the grid. */
+	FORCEINLINE bool IsCoordinateValid(const FIntPoint& coordinate) const
+	{
+		return coordinate.X >= 0 && coordinate.X < SizeX && coordinate.Y >= 0 && coordinate.Y < SizeY;
+	}
+
+	/** Returns the coordinate of a tile, X being its column and Y its row. */
+	FORCEINLINE FIntPoint GetTileCoordinate(int32 tileID) const
+	{
+		const int32 row = tileID / SizeX;
+		return FIntPoint(tileID - row * SizeX, row);
+	}
+
+	/** Returns the tileID at a coordinate (X = column, Y = row), -1 if the coordinate is off the grid. */
+	FORCEINLINE int32 GetTileID(const FIntPoint& coordinate) const
+	{
+		return IsCoordinateValid(coordinate) ? coordinate.Y * SizeX + coordinate.X : -1;
+	}
+
+	/** Returns the signed column (X) and row (Y) difference going from tileA to tileB. */
+	FORCEINLINE FIntPoint GetTileDelta(int32 tileA, int32 tileB) const
+	{
+		return GetTileCoordinate(tileB) - GetTileCoordinate(tileA);
+	}
+
+	/** Returns the neighbour of a tile in the specified direction, -1 if it would be off the grid or the tile isn't valid. */
+	int32 GetNeighbour(int32 tileID, ETT_TileDirection direction) const
+	{
+		// Also keeps an empty grid (SizeX = 0) from dividing by zero
+		if (!IsTileValid(tileID))
+		{
+			return -1;
+		}
+
+		const int32 dir = int32(direction);
+		const int32 column = GetColumn(tileID) + GetDirectionColumn(dir);
+		const int32 row = GetRow(tileID) + GetDirectionRow(dir);
+
+		if (column < 0 || column >= SizeX || row < 0 || row >= SizeY)
+		{
+			return -1;
+		}
+		return tileID + NeighbourOffsets[dir];
+	}
+
+	/** Number of chunks on the X axis. */
+	FORCEINLINE int32 GetNumChunksX() const { return (SizeX + GetChunkSize() - 1) >> GetChunkShift(); }
+
+	/** Number of chunks on the Y axis. */
+	FORCEINLINE int32 GetNumChunksY() const { return (SizeY + GetChunkSize() - 1) >> GetChunkShift(); }
+
+	FORCEINLINE int32 GetNumChunks() const { return GetNumChunksX() * GetNumChunksY(); }
+
+	/** Returns the chunk a tile belongs to. */
+	FORCEINLINE int32 GetChunkIndex(int32 tileID) const
+	{
+		const FIntPoint coordinate = GetTileCoordinate(tileID);
+		return (coordinate.Y >> GetChunkShift()) * GetNumChunksX() + (coordinate.X >> GetChunkShift());
+	}
+
+	/** Returns the coordinate of the first tile (lowest column and row) of a chunk. */
+	FORCEINLINE FIntPoint GetChunkOrigin(int32 chunkIndex) const
+	{
+		const int32 numChunksX = GetNumChunksX();
+		return FIntPoint(chunkIndex % numChunksX, chunkIndex / numChunksX) * GetChunkSize();
+	}
+
+	/** Returns how many columns (X) and rows (Y) a chunk has. */
+	FORCEINLINE FIntPoint GetChunkDimensions(int32 chunkIndex) const
+	{
+		const FIntPoint origin = GetChunkOrigin(chunkIndex);
+		return FIntPoint(FMath::Min(GetChunkSize(), SizeX - origin.X), FMath::Min(GetChunkSize(), SizeY - origin.Y));
+	}
+
+	FORCEINLINE int32 GetChunkNumTiles(int32 chunkIndex) const
+	{
+		const FIntPoint dimensions = GetChunkDimensions(chunkIndex);
+		return dimensions.X * dimensions.Y;
+	}
+
+	/** Returns the index of a tile inside its chunk, chunk tiles being stored row by row like the grid. */
+	FORCEINLINE int32 GetChunkLocalIndex(int32 tileID) const
+	{
+		const FIntPoint coordinate = GetTileCoordinate(tileID);
+		const int32 chunkOriginX = coordinate.X & ~(GetChunkSize() - 1);
+		const int32 chunkWidth = FMath::Min(GetChunkSize(), SizeX - chunkOriginX);
+
+		return (coordinate.Y & (GetChunkSize() - 1)) * chunkWidth + (coordinate.X - chunkOriginX);
+	}
+
+	/** Returns the tileID of the tile at localIndex in a chunk (inverse of GetChunkIndex & GetChunkLocalIndex). */
+	FORCEINLINE int32 GetChunkTileID(int32 chunkIndex, int32 localIndex) const
+	{
+		const FIntPoint origin = GetChunkOrigin(chunkIndex);
+		const int32 chunkWidth = FMath::Min(GetChunkSize(), SizeX - origin.X);
+
+		return (origin.Y + localIndex / chunkWidth) * SizeX + origin.X + localIndex % chunkWidth;
+	}
+
+	/**
+	* Returns the tile's neighbours in a clockwise order, directions without a neighbour are skipped.
+	* @param tileID Specified tileID, must be valid.
+	* @param allowDiagonalPaths Include the diagonal neighbours.
+	*/
+	FTT_TileNeighbours GetNeighbours(int32 tileID, bool allowDiagonalPaths) const
+	{
+		return GatherNeighbours(tileID, allowDiagonalPaths, false);
+	}
+
+	/**
+	* Same as GetNeighbours but keeps one slot per direction, -1 standing for a missing neighbour.
+	* Direction index: Right 0 - Bottom 1 - Left 2 - Top 3, or ETT_TileDirection if allowDiagonalPaths is enabled.
+	*/
+	FTT_TileNeighbours GetAllNeighbours(int32 tileID, bool allowDiagonalPaths) const
+	{
+		return GatherNeighbours(tileID, allowDiagonalPaths, true);
+	}
+
+private:
+
+	/** Offset to add to a tileID to move in each ETT_TileDirection. */
+	int32 NeighbourOffsets[8];
+
+	FTT_TileNeighbours GatherNeighbours(int32 tileID, bool allowDiagonalPaths, bool keepMissing) const
+	{
+		FTT_TileNeighbours result;
+		const int32 step = allowDiagonalPaths ? 1 : 2;
+
+		if (!IsTileValid(tileID))
+		{
+			if (keepMissing)
+			{
+				for (int32 dir = 0; dir < 8; dir += step)
+				{
+					result.Add(-1);
+				}
+			}
+			return result;
+		}
+
+		const int32 column = GetColumn(tileID);
+		const int32 row = GetRow(tileID);
+
+		// Fast path, tiles away from the edges have all their neighbours
+		if (column > 0 && column < SizeX - 1 && row > 0 && row < SizeY - 1)
+		{
+			for (int32 dir = 0; dir < 8; dir += step)
+			{
+				result.Add(tileID + NeighbourOffsets[dir]);
+			}
+			return result;
+		}
+
+		for (int32 dir = 0; dir < 8; dir += step)
+		{
+			const int32 neighbourColumn = column + GetDirectionColumn(dir);
+			const int32 neighbourRow = row + GetDirectionRow(dir);
+
+			if (neighbourColumn >= 0 && neighbourColumn < SizeX && neighbourRow >= 0 && neighbourRow < SizeY)
+			{
+				result.Add(tileID + NeighbourOffsets[dir]);
+			}
+			else if (keepMissing)
+			{
+				result.Add(-1);
+			}
+		}
+		return result;
+	}
+};
@@ -0,0 +1,188 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Hierarchical path search (HPA*) over the grid's chunks, for long distance paths.
+	Where two neighbouring chunks share a run of walkable tiles along their border (an entrance), one or two transitions cross it.
+	The tiles on both sides of the transitions are the nodes of an abstract graph: nodes of the same chunk are linked by the cost of
+	the shortest path between them inside the chunk, and each node to the tile across its transitions.
+	A path is planned on that graph first (a few nodes per chunk), then each of its steps is refined inside a single chunk.
+	Paths are close to the shortest (they cross chunk borders on transitions only), not always the shortest: FTT_AStarSearch gives those.
+	A chunk's nodes & costs only depend on its tiles, a change on the grid only rebuilds the chunks it touches and the neighbours
+	whose transitions moved. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_GridTopology.h"
+#include "TT_PathSearch.h"
+
+/** A* & Dijkstra restricted to the tiles of a chunk, its arrays are indexed by the tiles' index in the chunk. */
+class FTT_ChunkPathSearch
+{
+public:
+
+	/**
+	* Sets the chunk the next searches run in.
+	* @param walkableTiles Per tile of the chunk (in chunk order), true if a path can go through it. Must outlive the searches.
+	*/
+	void SetChunk(const FTT_GridTopology& topology, int32 chunkIndex, bool allowDiagonalPaths, const TArray<bool>& walkableTiles);
+
+	/**
+	* Searches the chunk from one of its tiles, until every target tile is popped (or the chunk is exhausted). The start tile doesn't need to be walkable.
+	* With a single target the search is guided toward it (A*), otherwise it spreads evenly (Dijkstra).
+	*/
+	void Search(int32 startTile, const int32* targetTiles, int32 numTargets);
+
+	/** Returns the cost of the shortest path from the start of the last search to a tile of its chunk, MAX_int32 if it wasn't reached. */
+	int32 GetCost(int32 tileID) const;
+
+	/** Appends the tiles of the path from a tile of the last search back to its start, start excluded. Returns false if the tile wasn't reached. */
+	bool AppendPath(int32 tileID, TArray<int32>& OutPath) const;
+
+private:
+
+	FTT_PathSearchNodes Nodes;
+
+	/** Chunk & grid of the searches. */
+	FTT_GridTopology Topology;
+	int32 ChunkIndex = 0;
+	FIntPoint ChunkOrigin;
+	FIntPoint ChunkDimensions;
+	bool AllowDiagonalPaths = false;
+
+	/** Per tile of the chunk, true if it is walkable. */
+	const TArray<bool>* WalkableTiles = nullptr;
+
+	/** Chunk indices of the targets of the current search. */
+	TArray<int32> LocalTargets;
+};
+
+/** Abstract graph of the grid's chunks, for one set of walkable tiles and one neighbourhood (4 or 8 neighbours). */
+class FTT_HierarchicalPathMap
+{
+public:
+
+	/** Most nodes a chunk can have: 4 borders of at most 32 entrances (walkable & unwalkable tiles alternating), one transition each. */
+	static FORCEINLINE int32 GetMaxNodesPerChunk() { return 128; }
+
+	/** Entrances at least that long are crossed by two transitions, one at each end, shorter ones by a single transition in their middle. */
+	static FORCEINLINE int32 GetWideEntranceLength() { return 6; }
+
+	/** Tile of an abstract node, with the tiles it is linked to in the neighbouring chunks. */
+	struct FNode
+	{
+		int32 TileID;
+		TArray<int32, TInlineAllocator<2>> LinkedTileIDs;
+	};
+
+	/** Nodes of a chunk and the cost of the shortest path inside the chunk between each pair of them. */
+	struct FChunk
+	{
+		TArray<FNode> Nodes;
+
+		/** Per tile of the chunk (in chunk order), true if it is walkable. Paths are refined from it, without looking up the tiles again. */
+		TArray<bool> WalkableTiles;
+
+		/** Nodes.Num() by Nodes.Num() costs, MAX_int32 if the path leaves the chunk or there is none. */
+		TArray<int32> Costs;
+
+		FORCEINLINE int32 GetCost(int32 fromNode, int32 toNode) const { return Costs[fromNode * Nodes.Num() + toNode]; }
+
+		/** Returns the index of the node on a tile, INDEX_NONE if the tile isn't a node. */
+		int32 FindNode(int32 tileID) const
+		{
+			return Nodes.IndexOfByPredicate([tileID](const FNode& node) { return node.TileID == tileID; });
+		}
+	};
+
+	/** Sets the grid & neighbourhood of the map, every chunk needs to be built. */
+	void Init(const FTT_GridTopology& topology, bool allowDiagonalPaths);
+
+	/** Flags the chunks containing tiles whose walkability changed. */
+	void Invalidate(const FTT_TileRect& changedRect);
+
+	/** Rebuilds the flagged chunks, and the neighbouring chunks whose transitions changed. Must be called before searching the map. */
+	void Update(TFunctionRef<bool(int32)> isTileWalkable);
+
+	FORCEINLINE const FTT_GridTopology& GetTopology() const { return Topology; }
+	FORCEINLINE bool IsDiagonal() const { return AllowDiagonalPaths; }
+	FORCEINLINE bool IsUpToDate() const { return NumDirtyChunks == 0; }
+
+	FORCEINLINE const FChunk& GetChunk(int32 chunkIndex) const { return Chunks[chunkIndex]; }
+
+	/** Returns true if a tile was walkable when its chunk was built. */
+	FORCEINLINE bool IsTileWalkable(int32 tileID) const { return Chunks[Topology.GetChunkIndex(tileID)].WalkableTiles[Topology.GetChunkLocalIndex(tileID)]; }
+
+private:
+
+	/** Crossing of a border, from a tile of the chunk with the lowest index to the tile next to it in the other chunk. */
+	struct FTransition
+	{
+		int32 LowTileID;
+		int32 HighTileID;
+
+		FORCEINLINE bool operator==(const FTransition& other) const { return LowTileID == other.LowTileID && HighTileID == other.HighTileID; }
+	};
+
+	/** Index of the border between a chunk and its neighbour on the X (axis 0) or Y (axis 1) axis. */
+	static FORCEINLINE int32 GetBorderIndex(int32 chunkIndex, int32 axis) { return chunkIndex * 2 + axis; }
+
+	/** Finds the entrances along a border & the transitions crossing them. Borders on the edge of the grid have none. */
+	void ScanBorder(int32 chunkIndex, int32 axis, TFunctionRef<bool(int32)> isTileWalkable, TArray<FTransition>& OutTransitions) const;
+
+	/** Gathers the walkability & nodes of a chunk from its 4 borders and computes the costs between them. */
+	void BuildChunk(int32 chunkIndex, TFunctionRef<bool(int32)> isTileWalkable);
+
+	FTT_GridTopology Topology;
+	bool AllowDiagonalPaths = false;
+
+	TArray<FChunk> Chunks;
+
+	/** Per border (see GetBorderIndex), transitions crossing it. */
+	TArray<TArray<FTransition>> BorderTransitions;
+
+	/** One bit per chunk, set if its tiles changed since it was built. */
+	TBitArray<> DirtyChunks;
+	int32 NumDirtyChunks = 0;
+
+	/** Search computing the costs between the nodes, kept from one chunk to the next. */
+	FTT_ChunkPathSearch ChunkSearch;
+	TArray<int32> ScratchTileIDs;
+	TArray<FTransition> ScratchTransitions;
+};
+
+/** Finds paths on a FTT_HierarchicalPathMap: start & goal are connected to their chunk's nodes, the abstract path is found with A* then refined chunk by chunk. */
+class FTT_HierarchicalPathSearch
+{
+public:
+
+	/**
+	* Finds a short path between two tiles.
+	* @param hierarchicalMap Up to date graph of the grid to search, its neighbourhood is the one of the path. The path only uses the tiles it holds as walkable,
+	*						 except for the start tile which doesn't need to be walkable.
+	* @param OutPath Every tile of the path from goalTile to startTile (both included), empty if there is none.
+	* @return True if a path was found.
+	*/
+	bool FindPath(const FTT_HierarchicalPathMap& hierarchicalMap, int32 startTile, int32 goalTile, TArray<int32>& OutPath);
+
+	/** Number of abstract nodes the last search popped from its open list. */
+	int32 GetNumExpandedNodes() const { return NumExpandedNodes; }
+
+private:
+
+	/** Abstract nodes are numbered chunkIndex * GetMaxNodesPerChunk() + node index, the start & goal come after all the chunks' nodes. */
+	FTT_PathSearchNodes AbstractNodes;
+
+	/** Tile of each abstract node reached by the current search. */
+	TArray<int32> AbstractTileIDs;
+
+	FTT_ChunkPathSearch ChunkSearch;
+
+	/** Costs from the start to its chunk's nodes, and from its chunk's nodes to the goal. */
+	TArray<int32> StartCosts;
+	TArray<int32> GoalCosts;
+
+	TArray<int32> ScratchTileIDs;
+	TArray<int32> AbstractPath;
+
+	int32 NumExpandedNodes = 0;
+};
@@ -0,0 +1,142 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Jump Point Search over the grid's tiles (JPS+: the jumps are precomputed).
+	On uniform cost tiles most of the tiles A* opens are equivalent: a straight run of free tiles only needs to be expanded where an
+	obstacle ends (a forced neighbour). FTT_JumpPointMap stores, per tile & direction, how far the search can jump before reaching
+	such a tile, FTT_JumpPointSearch walks from jump to jump with the same costs & heuristic as FTT_AStarSearch.
+	Jumps never go further than the first tile of the next chunk, where the search picks the move up again: a jump reaching it isn't a jump
+	point. Whether a straight move finds a jump point further on (in this chunk or any other) is kept apart, once per tile & direction,
+	so diagonal moves only stop where a straight move really finds one. A change on the grid rebuilds the chunks touching it and the
+	chunks where those bits changed (along the rows & columns of the change).
+	Each chunk is built one direction at a time, walking its tiles from the side the move goes toward: a tile's jump is made from the
+	jump of the tile after it.
+
+	With diagonals, diagonal moves can't cut corners (like FTT_AStarSearch) and have no forced neighbours.
+	Without diagonals, moves along a row (Top & Bottom) are jumped like straight moves, and moves across rows (Right & Left) like
+	diagonals: they stop on the tiles from which a move along the row finds a jump point. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_GridTopology.h"
+#include "TT_PathSearch.h"
+
+/** Precomputed jumps of every tile, for one set of walkable tiles and one neighbourhood (4 or 8 neighbours). */
+class FTT_JumpPointMap
+{
+public:
+
+	/** Sets the grid & neighbourhood of the map, every chunk needs to be built. */
+	void Init(const FTT_GridTopology& topology, bool allowDiagonalPaths);
+
+	/** Flags the tiles of a rectangle whose walkability changed, and the chunks & lines whose jumps depend on them. */
+	void Invalidate(const FTT_TileRect& changedRect);
+
+	/** Reads the flagged tiles again and rebuilds the jumps depending on them. Must be called before searching the map. */
+	void Update(TFunctionRef<bool(int32)> isTileWalkable);
+
+	/**
+	* Returns the jump of a tile in an ETT_TileDirection (only the straight ones without diagonals).
+	* Positive: number of moves to the next jump point, or to the first tile of the next chunk. Zero or negative: minus the number of moves that can be made before reaching an unwalkable tile.
+	*/
+	FORCEINLINE int32 GetJumpDistance(int32 tileID, int32 direction) const
+	{
+		return JumpDistances[tileID * NumDirections + (AllowDiagonalPaths ? direction : direction >> 1)];
+	}
+
+	FORCEINLINE const FTT_GridTopology& GetTopology() const { return Topology; }
+	FORCEINLINE bool IsDiagonal() const { return AllowDiagonalPaths; }
+	FORCEINLINE bool IsUpToDate() const { return NumDirtyChunks == 0; }
+
+private:
+
+	/** Returns true if a coordinate (on the grid or right around it) is on the grid and its tile was walkable when the map was last updated. */
+	FORCEINLINE bool IsWalkable(const FIntPoint& coordinate) const
+	{
+		return WalkableTiles[(coordinate.Y + 1) * (Topology.SizeX + 2) + coordinate.X + 1];
+	}
+
+	FORCEINLINE void SetJumpDistance(int32 tileID, int32 direction, int32 distance)
+	{
+		JumpDistances[tileID * NumDirections + (AllowDiagonalPaths ? direction : direction >> 1)] = int8(distance);
+	}
+
+	/** Bit of a straight ETT_TileDirection in JumpPointAheadMasks. */
+	static FORCEINLINE uint8 GetJumpPointAheadBit(int32 direction) { return uint8(1 << (direction >> 1)); }
+
+	/** Returns true if a straight move from a tile finds a jump point before reaching an unwalkable tile, whatever the chunk it is in. */
+	FORCEINLINE bool IsJumpPointAhead(int32 tileID, int32 direction) const { return (JumpPointAheadMasks[tileID] & GetJumpPointAheadBit(direction)) != 0; }
+
+	void FlagChunk(int32 chunkIndex);
+
+	/** Sets the jump point ahead bits of a row (moves along it) or column (moves along it) in one straight direction, flagging the chunks whose bits changed. */
+	void UpdateJumpPointsAhead(int32 lineIndex, int32 direction);
+
+	/** Fills the jumps of a chunk in one direction. */
+	void BuildChunkJumps(int32 chunkIndex, int32 direction);
+
+	/** Returns true if a tile entered with a straight move has a neighbour that can only be reached optimally through it. */
+	bool HasForcedNeighbour(const FIntPoint& coordinate, int32 direction) const;
+
+	/** Returns true if a move entering a tile in a direction stops there for a jump point (not a wall nor a chunk edge). */
+	bool IsJumpPoint(const FIntPoint& coordinate, int32 direction) const;
+
+	FTT_GridTopology Topology;
+	bool AllowDiagonalPaths = false;
+
+	/** 8 directions per tile with diagonals, 4 without. */
+	int32 NumDirections = 4;
+
+	/** Per tile, true if it was walkable when the map was last updated. The grid is surrounded by a border of unwalkable tiles, so moves never need to check they stay on it. */
+	TArray<bool> WalkableTiles;
+
+	/** Rectangles of tiles to read again on the next update. */
+	TArray<FTT_TileRect> ChangedRects;
+
+	/** Per tile & direction, see GetJumpDistance. Jumps are at most a chunk long, they fit in a byte. */
+	TArray<int8> JumpDistances;
+
+	/** Per tile, one bit per straight direction (see GetJumpPointAheadBit), set if IsJumpPointAhead. */
+	TArray<uint8> JumpPointAheadMasks;
+
+	/** One bit per row & column, set if its jump point ahead bits need to be set again. Columns are only used with diagonals. */
+	TBitArray<> DirtyRows;
+	TBitArray<> DirtyColumns;
+
+	/** One bit per chunk, set if its jumps need to be rebuilt. */
+	TBitArray<> DirtyChunks;
+	int32 NumDirtyChunks = 0;
+};
+
+/** Finds paths costing the same as FTT_AStarSearch's, opening only the jump points of a FTT_JumpPointMap. */
+class FTT_JumpPointSearch
+{
+public:
+
+	/**
+	* Finds the shortest path between two tiles.
+	* @param jumpPointMap Up to date jumps of the grid to search, its neighbourhood is the one of the path.
+	* @param isTileWalkable Returns true if the path can go through a tile, same as the jump point map was built with. The start tile doesn't need to be walkable, the goal tile does.
+	* @param OutPath Every tile of the path from goalTile to startTile (both included), empty if there is none.
+	* @return True if a path was found.
+	*/
+	bool FindPath(const FTT_JumpPointMap& jumpPointMap, int32 startTile, int32 goalTile, TFunctionRef<bool(int32)> isTileWalkable, TArray<int32>& OutPath);
+
+	/** Number of jump points the last search popped from its open list. */
+	int32 GetNumExpandedTiles() const { return NumExpandedTiles; }
+
+private:
+
+	/** Direction of the start tile, whose successors are in every direction. */
+	static FORCEINLINE uint8 GetNoDirection() { return 0xFF; }
+
+	FTT_PathSearchNodes Nodes;
+
+	/** Per tile, ETT_TileDirection of the jump that reached it. Only read for the tiles of the current search. */
+	TArray<uint8> Directions;
+
+	/** Jump points of the path, filled in between once found. */
+	TArray<int32> JumpPoints;
+
+	int32 NumExpandedTiles = 0;
+};
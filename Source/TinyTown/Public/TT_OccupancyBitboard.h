@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* One bit per tile telling if a block owns it, stored row by row (column = X, row = Y).
+	Each row starts on a new 64 bit word, so a rectangle of tiles is free when a few masked words of each of its rows are 0. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_GridTopology.h"
+#include "TT_Global.h"
+
+class FTT_OccupancyBitboard
+{
+public:
+
+	/** Sizes the bitboard for a grid, every tile starts free. */
+	void Init(const FTT_GridTopology& topology);
+
+	/** tileID has to be on the grid. */
+	FORCEINLINE bool IsTileOccupied(int32 tileID) const
+	{
+		const FIntPoint coordinate = Topology.GetTileCoordinate(tileID);
+		return (GetRow(coordinate.Y)[coordinate.X >> 6] >> (coordinate.X & 63)) & 1;
+	}
+
+	void SetTile(int32 tileID, bool isOccupied);
+
+	/** Sets every tile of a rectangle, clipped to the grid. */
+	void SetRect(const FTT_TileRect& rect, bool isOccupied);
+
+	/** Returns true if no tile of the rectangle is occupied. Tiles off the grid count as occupied. */
+	bool IsRectFree(const FTT_TileRect& rect) const;
+
+	/** Returns true if no tile of a row between two columns (inclusive, on the grid) is occupied. */
+	bool IsRowSpanFree(int32 row, int32 firstColumn, int32 lastColumn) const;
+
+	const FTT_GridTopology& GetTopology() const { return Topology; }
+
+	int32 GetWordsPerRow() const { return WordsPerRow; }
+
+	/** Returns the words of a row, bit (column & 63) of word (column >> 6) is the tile's. Bits past the last column are always 0. */
+	FORCEINLINE const uint64* GetRow(int32 row) const { return Words.GetData() + row * WordsPerRow; }
+
+	/** Returns a mask with the bits firstBit to lastBit (inclusive, 0-63) set. */
+	static FORCEINLINE uint64 GetBitMask(int32 firstBit, int32 lastBit)
+	{
+		return (~uint64(0) << firstBit) & (~uint64(0) >> (63 - lastBit));
+	}
+
+private:
+
+	FORCEINLINE uint64* GetMutableRow(int32 row) { return Words.GetData() + row * WordsPerRow; }
+
+	FTT_GridTopology Topology;
+
+	int32 WordsPerRow = 0;
+
+	TArray<uint64> Words;
+};
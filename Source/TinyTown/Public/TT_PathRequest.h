@@ -0,0 +1,151 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Path searches running on the task graph's worker threads.
+	A request never reads the blocks: it searches a FTT_WalkabilitySnapshot, an immutable copy of the tiles' walkability taken on the
+	game thread. Snapshots are split in chunks shared between them: a change only reads the chunks it touches again (a few per frame
+	at most, see UTT_Pathfinder::snapshotBudgetMs) and the next snapshot shares every other chunk with the previous one. The requests
+	already running keep the chunks they started with.
+	A cancelled request stops as soon as its search notices it (every tile then reads as unwalkable) and is never delivered.
+	UTT_Pathfinder::RequestPathAsync makes the requests and delivers their path on the game thread. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "TT_GridTopology.h"
+#include "TT_PathSearch.h"
+#include "TT_Global.h"
+
+/** Called on the game thread with the path of a request, from its goal tile to its start tile. Empty if there is none. */
+DECLARE_DELEGATE_OneParam(FTT_OnPathFound, const TArray<int32>&);
+
+/** Walkability of every tile of the grid for one set of blocks to ignore. Copying a snapshot only copies one pointer per chunk. */
+class FTT_WalkabilitySnapshot
+{
+public:
+
+	/** Sets the grid of the snapshot, every chunk needs to be read. */
+	void Init(const FTT_GridTopology& topology);
+
+	/** Flags the chunks of a rectangle of tiles whose walkability changed. */
+	void Invalidate(const FTT_TileRect& changedRect);
+
+	/**
+	* Reads the flagged chunks again until the budget is spent, at least one chunk per call. The snapshots sharing their previous tiles keep them.
+	* @return True once every chunk is read.
+	*/
+	bool Update(TFunctionRef<bool(int32)> isTileWalkable, float budgetMs);
+
+	FORCEINLINE bool IsUpToDate() const { return NumDirtyChunks == 0; }
+
+	/** The snapshot must be up to date. */
+	FORCEINLINE bool IsTileWalkable(int32 tileID) const { return (*Chunks[Topology.GetChunkIndex(tileID)])[Topology.GetChunkLocalIndex(tileID)]; }
+
+	FORCEINLINE const FTT_GridTopology& GetTopology() const { return Topology; }
+
+private:
+
+	FTT_GridTopology Topology;
+
+	/** Per chunk, one bit per tile (in chunk order) set if a path can go through it. Never modified once read, a chunk read again gets new bits. */
+	TArray<TSharedPtr<const TBitArray<>, ESPMode::ThreadSafe>> Chunks;
+
+	/** One bit per chunk, set if it needs to be read again. */
+	TBitArray<> DirtyChunks;
+	int32 NumDirtyChunks = 0;
+};
+
+/** What a request searches for. */
+struct FTT_PathQuery
+{
+	int32 StartTile;
+	int32 GoalTile;
+	bool AllowDiagonalPaths;
+
+	/** If not empty, the path is first looked for in this rectangle with FTT_ZoneDijkstraSearch (the build tool's road preview), then on the whole grid with FTT_AStarSearch. */
+	FTT_TileRect Zone;
+
+	/** Paths found in the zone with less tiles than this are looked for on the whole grid instead. */
+	int32 MinZonePathLength;
+
+	FTT_PathQuery()
+		: StartTile(-1)
+		, GoalTile(-1)
+		, AllowDiagonalPaths(false)
+		, MinZonePathLength(0)
+	{
+	}
+};
+
+/** Identifies a request made by UTT_Pathfinder::RequestPathAsync. */
+struct FTT_PathRequestHandle
+{
+	/** 0 if the handle doesn't refer to any request. */
+	uint32 RequestID;
+
+	FTT_PathRequestHandle()
+		: RequestID(0)
+	{
+	}
+
+	FORCEINLINE bool IsValid() const { return RequestID != 0; }
+	FORCEINLINE void Invalidate() { RequestID = 0; }
+};
+
+/** Searches used by a worker thread, kept from one request to the next so their per tile arrays are only allocated once. */
+struct FTT_PathWorkerSearches
+{
+	FTT_ZoneDijkstraSearch ZoneDijkstraSearch;
+	FTT_AStarSearch AStarSearch;
+};
+
+/** Searches of the requests not running, shared by all the worker threads. */
+class FTT_PathWorkerSearchPool
+{
+public:
+
+	/** Returns free searches, new ones if they are all in use. */
+	TUniquePtr<FTT_PathWorkerSearches> Acquire();
+
+	void Release(TUniquePtr<FTT_PathWorkerSearches> searches);
+
+private:
+
+	FCriticalSection Lock;
+	TArray<TUniquePtr<FTT_PathWorkerSearches>> FreeSearches;
+};
+
+/** State of a request, shared by the game thread and the worker running it. */
+struct FTT_PathRequest
+{
+	FTT_PathQuery Query;
+
+	/** Blocks whose tiles are walkable, only read by the game thread to pick the request's snapshot. */
+	TArray<int> BlockIDsToIgnore;
+
+	/** Longest path the zone search can find, UTT_Pathfinder's pathfindingMaxDistance when the request was made. */
+	int32 MaxZoneDistance;
+
+	/** Set once the request's snapshot is up to date, right before it is dispatched to a worker. */
+	TSharedPtr<const FTT_WalkabilitySnapshot, ESPMode::ThreadSafe> Snapshot;
+
+	FTT_OnPathFound OnPathFound;
+
+	/** Set by the game thread, read by the worker. */
+	FThreadSafeBool IsCancelled;
+
+	/** Written by the worker, only read by the game thread once CompletionEvent is complete. */
+	TArray<int32> Path;
+
+	/** Completes when the worker is done with the request. Null while the request waits for its snapshot. */
+	FGraphEventRef CompletionEvent;
+
+	FTT_PathRequest()
+		: MaxZoneDistance(0)
+	{
+	}
+
+	/** Runs the query on the snapshot, on the calling thread. */
+	void Execute(FTT_PathWorkerSearchPool& searchPool);
+};
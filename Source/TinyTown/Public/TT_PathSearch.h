@@ -0,0 +1,167 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Grid path searches working on flat per-tile arrays.
+	FTT_PathSearchNodes holds the cost, estimate and parent of every tile along with a binary heap of the open tiles.
+	Its arrays are only allocated once per grid size: each search bumps a stamp, tiles whose stamp is older count as unreached,
+	so starting a search never clears anything.
+	Costs are integers, a straight move costs 10 and a diagonal one 14 (octile distance).
+	FTT_ZoneDijkstraSearch is the unit cost search restricted to a zone, used by the build tool's road preview. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_GridTopology.h"
+#include "TT_Global.h"
+
+/** Per tile values of a search and its open list, reused from one search to the next. */
+class FTT_PathSearchNodes
+{
+public:
+
+	/** Starts a new search over numTiles tiles, the values of the previous search are dropped. */
+	void BeginSearch(int32 numTiles);
+
+	/** Returns true if the current search has reached the tile (it is either open or closed). */
+	FORCEINLINE bool IsReached(int32 tileID) const { return Stamps[tileID] == CurrentStamp; }
+
+	/** Returns true if the tile was popped, its cost is final. */
+	FORCEINLINE bool IsClosed(int32 tileID) const { return IsReached(tileID) && HeapIndices[tileID] == GetClosedIndex(); }
+
+	/** Returns the cost of the best path found so far from the start to the tile, MAX_int32 if it isn't reached. */
+	FORCEINLINE int32 GetCost(int32 tileID) const { return IsReached(tileID) ? Costs[tileID] : MAX_int32; }
+
+	/** Returns the tile the best path to this tile comes from, the start tile being its own parent. -1 if the tile isn't reached. */
+	FORCEINLINE int32 GetParent(int32 tileID) const { return IsReached(tileID) ? Parents[tileID] : -1; }
+
+	/**
+	* Opens a tile, or lowers its cost if it is already open with a higher one. Closed tiles are left untouched.
+	* @param cost Cost of the path from the start to the tile.
+	* @param estimate Cost plus the heuristic, the open tile with the lowest estimate is popped first.
+	* @return True if the tile was opened or its cost lowered.
+	*/
+	bool Open(int32 tileID, int32 cost, int32 estimate, int32 parentTileID);
+
+	FORCEINLINE bool HasOpenTiles() const { return Heap.Num() > 0; }
+
+	/** Closes & returns the open tile with the lowest estimate. Ties go to the highest cost, which is closest to the goal. */
+	int32 PopBest();
+
+	/** Fills OutPath with the tiles from tileID back to the start, following the parents. */
+	void BuildPath(int32 tileID, TArray<int32>& OutPath) const;
+
+private:
+
+	/** Heap index of the tiles that were popped. */
+	static FORCEINLINE int32 GetClosedIndex() { return -2; }
+
+	FORCEINLINE bool IsBefore(int32 tileA, int32 tileB) const
+	{
+		return Estimates[tileA] < Estimates[tileB] || (Estimates[tileA] == Estimates[tileB] && Costs[tileA] > Costs[tileB]);
+	}
+
+	void SiftUp(int32 heapIndex);
+	void SiftDown(int32 heapIndex);
+
+	/** Search the tile's values belong to, the values of other searches are stale. */
+	TArray<uint32> Stamps;
+	uint32 CurrentStamp = 0;
+
+	TArray<int32> Costs;
+	TArray<int32> Estimates;
+	TArray<int32> Parents;
+
+	/** Position of the tile in Heap, GetClosedIndex() once popped. */
+	TArray<int32> HeapIndices;
+
+	/** Open tiles, as a binary heap ordered by IsBefore. */
+	TArray<int32> Heap;
+};
+
+/** A* over the grid's tiles, with 4 or 8 neighbours. Diagonal moves can't cut the corner of an unwalkable tile. */
+class FTT_AStarSearch
+{
+public:
+
+	static FORCEINLINE int32 GetStraightCost() { return 10; }
+	static FORCEINLINE int32 GetDiagonalCost() { return 14; }
+
+	/** Returns the cost of the shortest path between two tiles on an empty grid: octile distance with diagonals, Manhattan distance without. */
+	static FORCEINLINE int32 GetHeuristic(const FIntPoint& delta, bool allowDiagonalPaths)
+	{
+		const int32 columns = FMath::Abs(delta.X);
+		const int32 rows = FMath::Abs(delta.Y);
+
+		return allowDiagonalPaths
+			? GetStraightCost() * FMath::Max(columns, rows) + (GetDiagonalCost() - GetStraightCost()) * FMath::Min(columns, rows)
+			: GetStraightCost() * (columns + rows);
+	}
+
+	/**
+	* Finds the shortest path between two tiles.
+	* @param topology Grid to search.
+	* @param isTileWalkable Returns true if the path can go through a tile. The start tile doesn't need to be walkable, the goal tile does.
+	* @param OutPath Tiles of the path from goalTile to startTile (both included), empty if there is none.
+	* @return True if a path was found.
+	*/
+	bool FindPath(const FTT_GridTopology& topology, int32 startTile, int32 goalTile, bool allowDiagonalPaths, TFunctionRef<bool(int32)> isTileWalkable, TArray<int32>& OutPath);
+
+	/** Number of tiles the last search popped from its open list. */
+	int32 GetNumExpandedTiles() const { return NumExpandedTiles; }
+
+private:
+
+	FTT_PathSearchNodes Nodes;
+
+	int32 NumExpandedTiles = 0;
+};
+
+/**
+* Dijkstra restricted to a zone, every move costing 1 (diagonal ones included, corners can be cut).
+* Moves all cost the same so the open list is a bucket queue: one bucket per distance, each bucket being drained in the order of
+* the zone's tiles. The zone is walked row by row from one of its corners (its origin), like ATT_BlockManager::GetZoneTileIDsFromZoneParameters
+* lays it out, which makes the paths the same as a plain Dijkstra scanning the zone's tiles in that order.
+*/
+class FTT_ZoneDijkstraSearch
+{
+public:
+
+	/**
+	* Finds the shortest path between two tiles of a zone. The search stops as soon as the goal is popped.
+	* @param topology Grid to search.
+	* @param zone Rectangle of tiles the path can use.
+	* @param origin Corner of the zone its tiles are ordered from, see GetZoneOrigin.
+	* @param zoneMask Optional, one bit per tile of the zone (in the zone's order), only the tiles whose bit is set can be used.
+	* @param maxDistance Tiles maxDistance moves or more away from the start are never reached.
+	* @param isTileWalkable Returns true if the path can go through a tile. The start tile doesn't need to be walkable.
+	* @param OutPath Tiles of the path from goalTile to startTile (both included), empty if there is none.
+	* @return True if a path was found.
+	*/
+	bool FindPath(const FTT_GridTopology& topology, const FTT_TileRect& zone, const FIntPoint& origin, const TBitArray<>* zoneMask, int32 startTile, int32 goalTile,
+		bool allowDiagonalPaths, int32 maxDistance, TFunctionRef<bool(int32)> isTileWalkable, TArray<int32>& OutPath);
+
+	/** Returns the corner of the zone closest to a coordinate, e.g. the start of a path drawn from one corner of the zone to the other. */
+	static FIntPoint GetZoneOrigin(const FTT_TileRect& zone, const FIntPoint& coordinate);
+
+	/** Returns the index of a coordinate in the zone's order, -1 if the coordinate isn't in the zone. */
+	static int32 GetZoneIndex(const FTT_TileRect& zone, const FIntPoint& origin, const FIntPoint& coordinate);
+
+	/** Number of tiles the last search popped. */
+	int32 GetNumExpandedTiles() const { return NumExpandedTiles; }
+
+private:
+
+	FORCEINLINE bool IsReached(int32 zoneIndex) const { return Stamps[zoneIndex] == CurrentStamp; }
+
+	/** Per zone index, search the values belong to. */
+	TArray<uint32> Stamps;
+	uint32 CurrentStamp = 0;
+
+	/** Per zone index, zone index of the tile the path comes from. */
+	TArray<int32> Parents;
+
+	/** Zone indices of the tiles at the distance being drained, and at the next one. */
+	TArray<int32> CurrentBucket;
+	TArray<int32> NextBucket;
+
+	int32 NumExpandedTiles = 0;
+};
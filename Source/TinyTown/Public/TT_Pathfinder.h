@@ -4,10 +4,37 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "TT_PathSearch.h"
+#include "TT_JumpPointSearch.h"
+#include "TT_HierarchicalPathSearch.h"
+#include "TT_PathRequest.h"
 #include "TT_Pathfinder.generated.h"
 
 class ATT_GridManager;
 
+/** Precomputed search data kept by a pathfinder for one set of blocks to ignore, with or without diagonals. Each map is built the first time it is used. */
+struct FTT_PathfinderMaps
+{
+	/** Sorted block IDs of the blocks whose tiles are walkable. */
+	TArray<int> BlockIDsToIgnore;
+
+	bool AllowDiagonalPaths;
+
+	FTT_JumpPointMap JumpPointMap;
+	FTT_HierarchicalPathMap HierarchicalMap;
+
+	/** Walkability searched by the async requests, its chunks are read again when blocks change. */
+	FTT_WalkabilitySnapshot WalkabilitySnapshot;
+
+	/** Copy of WalkabilitySnapshot shared with the requests, null while it has chunks to read. */
+	TSharedPtr<const FTT_WalkabilitySnapshot, ESPMode::ThreadSafe> SharedWalkabilitySnapshot;
+
+	FTT_PathfinderMaps()
+		: AllowDiagonalPaths(false)
+	{
+	}
+};
+
 UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
 class TINYTOWN_API UTT_Pathfinder : public UActorComponent
 {
@@ -20,6 +47,10 @@ protected:
 
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
+
 	/**
 	* Looks for spawned GridManager and return the first one found. Make sure you only have one GridManager in your scene. 
 	*/
@@ -38,6 +69,12 @@ protected:
 	*/
 	int GetTileMoveCost(int tileID, TArray<int> blockIDsToIgnore);
 
+	/* Returns true if a path can go through the tile: it is free or used by one of the blocks to ignore.
+	* @param tileID			Tile to check, must be valid.
+	* @param blockIDsToIgnore	Block IDs of the blocks to ignore.
+	*/
+	bool IsTileWalkable(int tileID, const TArray<int>& blockIDsToIgnore) const;
+
 	/**
 	* Returns whether or not a tile is being occupied by a block.
 	* @param tileID	Tile to check.
@@ -56,16 +93,85 @@ protected:
 	/** Reference to the GridManager. */
 	ATT_GridManager* GridManager;
 
-	/** Array of all the tile on the grid, is used for classic Dijkstra. */
-	TArray<int> tileArray;
-
 	/** Refers to the longest path possible the algorithm can find (in tiles). */
 	int pathfindingMaxDistance;
 
+	/** A* search, its per tile arrays are kept from one path to the next. */
+	FTT_AStarSearch aStarSearch;
+
+	/** Zone restricted Dijkstra search, its arrays are kept from one path to the next. */
+	FTT_ZoneDijkstraSearch zoneDijkstraSearch;
+
+	/** Jump point search, its per tile arrays are kept from one path to the next. */
+	FTT_JumpPointSearch jumpPointSearch;
+
+	/** Hierarchical search, its arrays are kept from one path to the next. */
+	FTT_HierarchicalPathSearch hierarchicalSearch;
+
+	/** Maps of the blocks to ignore used lately. Their chunks are flagged when blocks change and rebuilt on the next search. */
+	TArray<FTT_PathfinderMaps> pathfinderMaps;
+
+	/** Handle of OnBlockOccupancyChanged's binding to the block manager, set once the first map is made. */
+	FDelegateHandle blockOccupancyChangedHandle;
+
+	/** Returns the maps of a set of blocks to ignore, made first if needed. The maps themselves are only brought up to date by their searches. */
+	FTT_PathfinderMaps& GetPathfinderMaps(bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore);
+
+	/** Returns the up to date jump point map of a set of blocks to ignore. */
+	const FTT_JumpPointMap& GetJumpPointMap(bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore);
+
+	/** Returns the up to date hierarchical map of a set of blocks to ignore. */
+	const FTT_HierarchicalPathMap& GetHierarchicalMap(bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore);
+
+	/** Flags the chunks of the maps whose data depend on tiles blocks were spawned on or removed from. */
+	void OnBlockOccupancyChanged(const FTT_TileRect& changedRect);
+
+	/** Searches of the async requests, shared with the worker threads (they can outlive the pathfinder). */
+	TSharedPtr<FTT_PathWorkerSearchPool, ESPMode::ThreadSafe> pathWorkerSearchPool;
+
+	/** Async requests not delivered nor cancelled yet, by request ID. */
+	TMap<uint32, TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe>> pendingPathRequests;
+
+	/** ID of the next async request, 0 is never used. */
+	uint32 nextPathRequestID;
+
+	/** IDs of the async requests waiting for their snapshot, in the order they were made. */
+	TArray<uint32> waitingPathRequestIDs;
+
+	/**
+	* Returns the walkability snapshot of a set of blocks to ignore, after reading the chunks that changed since the last one for budgetMs at most.
+	* @return Null if chunks are left to read.
+	*/
+	TSharedPtr<const FTT_WalkabilitySnapshot, ESPMode::ThreadSafe> GetWalkabilitySnapshot(bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore, float budgetMs);
+
+	/** Gives the waiting requests their snapshot and starts their worker, in order, until the budget is spent. Ticks while requests are left waiting. */
+	void DispatchWaitingPathRequests(float budgetMs);
+
+	/** Starts the worker of a request whose snapshot is set. */
+	void DispatchPathRequest(uint32 requestID, const TSharedRef<FTT_PathRequest, ESPMode::ThreadSafe>& request);
+
+	/** Calls the delegate of a request whose worker is done, unless it was cancelled in the meantime. */
+	void DeliverPathRequest(uint32 requestID);
+
+	/**
+	* Runs the zone restricted Dijkstra search. Like the former implementation, a goal that can't be reached gives the path goalTile -> startTile.
+	* @param zoneMask Optional, see FTT_ZoneDijkstraSearch::FindPath.
+	*/
+	TArray<int> FindShortestPathInZone(int startTile, int goalTile, const FTT_TileRect& zone, const FIntPoint& zoneOrigin, const TBitArray<>* zoneMask, bool allowDiagonalPaths, const TArray<int>& blockIDsToIgnore);
+
 
 public:	
+
+	/** Search used by FindShortestPath. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	EGridPathfinding gridPathfinding = EGridPathfinding::GP_JumpPointSearch;
+
+	/** Time in milliseconds the async requests can take each frame to read the tiles whose walkability changed (see RequestPathAsync). */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Pathfinder")
+	float snapshotBudgetMs = 2.f;
+
 	/** Return an array of tile IDs representing the shortest path between startTile and goalTile using all of the grid's tiles.
-	* /!\ Very demanding on resources, WILL kill your FPS. Only use on tiny grids. /!\
+	* Every tile closer to the start than the goal is explored, prefer FindShortestPathAStar on big grids.
 	* @param startTile			 TileID of the tile to start from.
 	* @param goalTile			 TileID of the tile to end at.
 	* @param allowDiagonalPaths  Allow the algorithm to use diagonal paths.
@@ -74,6 +180,7 @@ public:
 	TArray<int> FindShortestPathDijkstra(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockIDsToIgnore);
 
 	/** Return an array of tile IDs representing the shortest path between startTile and goalTile guaranteed to be in the zone.
+	* The zone's tiles are turned into their bounding rectangle and a mask, prefer FindShortestPathInRectDijkstra for rectangular zones.
 	* @param							startTile TileID of the tile to start from.
 	* @param							goalTile TileID of the tile to end at.
 	* @param zone Array of TileIDs.		The return path is guaranteed to be using only the tiles in the zone.
@@ -82,9 +189,21 @@ public:
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Pathfinder")
 	TArray<int> FindShortestPathInZoneDijkstra(int startTile, int goalTile, TArray<int> zone, bool allowDiagonalPaths, TArray<int> blockIDsToIgnore);
+
+	/** Return an array of tile IDs representing the shortest path between startTile and goalTile guaranteed to be in a rectangle of tiles (see FTT_ZoneDijkstraSearch).
+	* Gives the same path as FindShortestPathInZoneDijkstra with the zone from ATT_BlockManager::GetZoneTileIDsFromZoneParameters when startTile is a corner of the rectangle.
+	* @param							startTile TileID of the tile to start from.
+	* @param							goalTile TileID of the tile to end at.
+	* @param zone						The return path is guaranteed to be using only the tiles in the rectangle.
+	* @param allowDiagonalPaths			Allow the algorithm to use diagonal paths.
+	* @param blockToIgnore				Allow the algorithm to ignore certain blocks.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Pathfinder")
+	TArray<int> FindShortestPathInRectDijkstra(int startTile, int goalTile, const FTT_TileRect& zone, bool allowDiagonalPaths, TArray<int> blockIDsToIgnore);
 	
 	/**
-	* Return an array of tile IDs representing the shortest path between startTile and goalTile using A* pathfinding.
+	* Return an array of tile IDs representing the shortest path between startTile and goalTile using A* pathfinding (see FTT_AStarSearch).
+	* The path goes from goalTile to startTile and only uses walkable tiles, it is empty if there is none or if startTile = goalTile.
 	* @param						startTile TileID of the tile to start from.
 	* @param						goalTile TileID of the tile to end at.
 	* @param allowDiagonalPaths		Allow the algorithm to use diagonal paths.
@@ -92,4 +211,62 @@ public:
 	*/
 	UFUNCTION(BlueprintCallable, Category = "Pathfinder")
 	TArray<int> FindShortestPathAStar(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockIDsToIgnore);
+
+	/**
+	* Return an array of tile IDs representing the shortest path between startTile and goalTile using Jump Point Search (see FTT_JumpPointSearch).
+	* The path costs the same as FindShortestPathAStar's (it can take other tiles), it goes from goalTile to startTile and is empty if there is none or if startTile = goalTile.
+	* The jumps are precomputed per set of blocks to ignore, the first path with a new set builds them for the whole grid.
+	* @param						startTile TileID of the tile to start from.
+	* @param						goalTile TileID of the tile to end at.
+	* @param allowDiagonalPaths		Allow the algorithm to use diagonal paths.
+	* @param blockToIgnore			Allow the algorithm to ignore certain blocks.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Pathfinder")
+	TArray<int> FindShortestPathJPS(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockIDsToIgnore);
+
+	/**
+	* Return an array of tile IDs representing a short path between startTile and goalTile, planned over the grid's chunks first (see FTT_HierarchicalPathSearch).
+	* Meant for long distance paths, it is usually a few percent longer than the shortest one. The path goes from goalTile to startTile and is empty if there is none or if startTile = goalTile.
+	* The chunks' graph is kept per set of blocks to ignore, only the chunks blocks were spawned on or removed from are rebuilt.
+	* @param						startTile TileID of the tile to start from.
+	* @param						goalTile TileID of the tile to end at.
+	* @param allowDiagonalPaths		Allow the algorithm to use diagonal paths.
+	* @param blockToIgnore			Allow the algorithm to ignore certain blocks.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Pathfinder")
+	TArray<int> FindPathHierarchical(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockIDsToIgnore);
+
+	/**
+	* Return an array of tile IDs representing the shortest path between startTile and goalTile, using the search selected by gridPathfinding.
+	* @param						startTile TileID of the tile to start from.
+	* @param						goalTile TileID of the tile to end at.
+	* @param allowDiagonalPaths		Allow the algorithm to use diagonal paths.
+	* @param blockToIgnore			Allow the algorithm to ignore certain blocks.
+	*/
+	UFUNCTION(BlueprintCallable, Category = "Pathfinder")
+	TArray<int> FindShortestPath(int startTile, int goalTile, bool allowDiagonalPaths, TArray<int> blockIDsToIgnore);
+
+	/**
+	* Looks for a path on a worker thread, against the tiles' walkability once the chunks that changed since the last request are read (see FTT_PathRequest).
+	* Reading them takes snapshotBudgetMs per frame at most, then the path (from goalTile to startTile, empty if there is none) is given to onPathFound on the game thread.
+	* Workers always run A*, gridPathfinding isn't used: the jump point & hierarchical maps are rebuilt in place on the game thread and can't be shared with them.
+	* Zone-less paths cost the same as FindShortestPath's with GP_AStar or GP_JumpPointSearch, and at most as much as GP_Hierarchical's.
+	* @param query					Tiles to link, see FTT_PathQuery.
+	* @param blockIDsToIgnore		Allow the algorithm to ignore certain blocks.
+	* @param onPathFound			Called once with the path, unless the request is cancelled first.
+	* @return Handle of the request, invalid if it couldn't be made.
+	*/
+	FTT_PathRequestHandle RequestPathAsync(const FTT_PathQuery& query, const TArray<int>& blockIDsToIgnore, FTT_OnPathFound onPathFound);
+
+	/** Cancels a request that wasn't delivered yet, its delegate will never be called. Invalidates the handle. */
+	void CancelPathRequest(FTT_PathRequestHandle& handle);
+
+	/**
+	* Waits for the worker of a request that wasn't delivered yet and delivers it right away, its snapshot is finished first if needed. Invalidates the handle.
+	* @return True if the request was delivered, false if it was already delivered or cancelled.
+	*/
+	bool CompletePathRequest(FTT_PathRequestHandle& handle);
+
+	/** Returns true if the request wasn't delivered nor cancelled yet. */
+	bool IsPathRequestPending(const FTT_PathRequestHandle& handle) const;
 };
@@ -0,0 +1,118 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Tells, for one footprint, on which tiles a block can be placed: one bit per tile, set if the block placed around
+	that tile (its hovered tile) is on the grid and only covers free tiles.
+	The map is the occupancy bitboard eroded by the footprint. Each row is first eroded horizontally (a tile is kept if
+	the footprint's width of free tiles starts there), then the rows are combined vertically over the footprint's height,
+	and finally shifted by the footprint's anchor. When blocks are spawned or deleted only the rows they touch are eroded again. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_OccupancyBitboard.h"
+
+/** Size of a block on the grid once rotated, and where its hovered tile is within it. */
+struct FTT_PlacementFootprint
+{
+	/** Columns (X) and rows (Y) covered by the block. */
+	FIntPoint Size;
+
+	/** Offset from the block's lowest tile to its hovered tile. */
+	FIntPoint AnchorOffset;
+
+	FTT_PlacementFootprint()
+		: Size(1, 1)
+		, AnchorOffset(0, 0)
+	{
+	}
+
+	FTT_PlacementFootprint(const FIntPoint& size, const FIntPoint& anchorOffset)
+		: Size(size)
+		, AnchorOffset(anchorOffset)
+	{
+	}
+
+	bool operator==(const FTT_PlacementFootprint& other) const
+	{
+		return Size == other.Size && AnchorOffset == other.AnchorOffset;
+	}
+};
+
+class FTT_PlacementValidityMap
+{
+public:
+
+	/** Erodes the whole occupancy bitboard by the footprint. */
+	void Build(const FTT_OccupancyBitboard& occupancy, const FTT_PlacementFootprint& footprint);
+
+	/** Erodes again the tiles whose validity depends on a rectangle whose occupancy changed. */
+	void Update(const FTT_OccupancyBitboard& occupancy, const FTT_TileRect& changedRect);
+
+	const FTT_PlacementFootprint& GetFootprint() const { return Footprint; }
+
+	/** Returns true if the block can be placed around the tile. False for tiles off the grid. */
+	FORCEINLINE bool IsTileValid(int32 tileID) const
+	{
+		if (!Topology.IsTileValid(tileID))
+		{
+			return false;
+		}
+
+		const FIntPoint coordinate = Topology.GetTileCoordinate(tileID);
+		return (ValidTiles[coordinate.Y * WordsPerRow + (coordinate.X >> 6)] >> (coordinate.X & 63)) & 1;
+	}
+
+	/**
+	* Returns the valid tile closest to a tile (Euclidean distance, the tile itself included), -1 if none is within maxRadius.
+	* Rows are searched outward from the tile, each one with a couple of word scans on both sides of the tile's column.
+	* @param tileID Tile to search around.
+	* @param maxRadius Furthest distance in tiles a valid tile can be at.
+	* @param tieBreakCoordinate Continuous grid coordinate (column, row, a tile's centre being at +0.5) the closest tile wins ties toward, e.g. the cursor.
+	*/
+	int32 FindNearestValidTile(int32 tileID, int32 maxRadius, const FVector2D& tieBreakCoordinate) const;
+
+	const FTT_GridTopology& GetTopology() const { return Topology; }
+
+	int32 GetWordsPerRow() const { return WordsPerRow; }
+
+	/** Returns the words of a row, laid out like FTT_OccupancyBitboard::GetRow. */
+	FORCEINLINE const uint64* GetRow(int32 row) const { return ValidTiles.GetData() + row * WordsPerRow; }
+
+private:
+
+	/** Recomputes which tiles of a row start a free run as wide as the footprint. */
+	void ErodeRow(const FTT_OccupancyBitboard& occupancy, int32 row);
+
+	/** Recomputes the valid tiles of a row from the eroded rows covered by the footprint. */
+	void UpdateValidRow(int32 row);
+
+	/** Returns the first valid column of a row between two columns (inclusive), -1 if there is none. */
+	int32 FindFirstValidColumn(int32 row, int32 firstColumn, int32 lastColumn) const;
+
+	/** Returns the last valid column of a row between two columns (inclusive), -1 if there is none. */
+	int32 FindLastValidColumn(int32 row, int32 firstColumn, int32 lastColumn) const;
+
+	/** dest bit x = source bit (x + shift). */
+	void ShiftRowRight(const uint64* source, uint64* dest, int32 shift) const;
+
+	/** dest bit x = source bit (x - shift). */
+	void ShiftRowLeft(const uint64* source, uint64* dest, int32 shift) const;
+
+	FTT_GridTopology Topology;
+
+	FTT_PlacementFootprint Footprint;
+
+	int32 WordsPerRow = 0;
+
+	/** Bits of the last word of each row that are on the grid. */
+	uint64 LastWordMask = 0;
+
+	/** Bit set if the footprint's width of free tiles starts at the tile. */
+	TArray<uint64> ErodedRows;
+
+	/** Bit set if the block can be placed around the tile. */
+	TArray<uint64> ValidTiles;
+
+	/** One row of words, used while eroding. */
+	TArray<uint64> ScratchRow;
+};
@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Pawn.h"
+#include "TT_Global.h"
+#include "TT_PathRequest.h"
 #include "TT_PlayerGridCamera.generated.h"
 
 class UCapsuleComponent;
@@ -96,6 +98,19 @@ protected:
 	/** Line trace from the camera to the grid and updates tile if they are hovered. */
 	void MouseTrace(); 
 
+	/** Finds the tile under the mouse cursor by intersecting the cursor's ray with the grid's plane (see useAnalyticPicking).
+	* @param OutTileID Tile under the cursor, or the central tile of the block standing on it.
+	* @param OutHitBlock True if a block stands on the tile under the cursor (only checked if pickBlocksFromOccupancy is enabled).
+	* @return False if the cursor isn't over the grid.
+	*/
+	bool PickTileUnderCursor(int& OutTileID, bool& OutHitBlock);
+
+	/** Returns the continuous grid coordinate under the mouse cursor (see ATT_GridManager::GetGridCoordinateFromLocation), false if the cursor isn't over the grid's plane. */
+	bool GetCursorGridCoordinate(FVector2D& OutCoordinate);
+
+	/** Same as PickTileUnderCursor, but with a physics trace relying on the tiles & blocks collisions. */
+	bool TraceTileUnderCursor(int& OutTileID, bool& OutHitBlock, bool& OutHitAnything);
+
 	/** Moves the camera in XY direction multiplied by Sensitivity. XY are axis values (-1 < value < 1).
 	* @param x Direction X to move in (-1 < X < 1).
 	* @param y Direction Y to move in (-1 < x < 1).
@@ -137,6 +152,15 @@ protected:
 	 */
 	void TickBuildTool(float deltaTime);
 
+	/** Shows the path of the last road preview request, see TickBuildTool. */
+	void OnPathPreviewFound(const TArray<int32>& path);
+
+	/** Shows a zone (or the remove tool's selection) on the grid. The overlays are only updated when the rect differs from the one already shown.
+	 * @param zoneRect Tiles to select and colour.
+	 * @param blockID Block ID whose colour the tiles take, -1 for the remove tool's dark grey.
+	 */
+	void ShowZonePreview(const FTT_TileRect& zoneRect, int blockID);
+
 	/** If placing a Zone or Path, use this to confirm the first tile of the zone or path. 
 	 * This allows the user  to hold click and drag to place down this type of block.
 	 */
@@ -230,6 +254,18 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Block Building")
 	float blockRotationMouseThreshold = 0.1f;
 
+	/** Finds the hovered tile by intersecting the mouse cursor with the grid's plane instead of tracing against the tiles & blocks collisions. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Settings")
+	bool useAnalyticPicking = true;
+
+	/** With analytic picking, hovering a tile used by a block hovers the block (its central tile), like tracing against the block would. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Settings")
+	bool pickBlocksFromOccupancy = true;
+
+	/** When the hovered tile can't hold the block being placed, how far in tiles the build tool looks for the nearest tile that can. */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Input Settings")
+	int buildToolSnapRadius = 8;
+
 
 	FTimerHandle TimerHandle_MouseMovements;
 	FTimerHandle TimerHandle_MouseRotation;
@@ -248,7 +284,8 @@ protected:
 	int placingBlockTileID; // Tile on which the block has been spawned (used as StartTile for zone spawning)
 	int placingBlocklastEndTileID; // Value of EndTileID last time zone was calculated
 	bool isPlacingDownAResizableBlock; // Indicates whether the ghostBlock that was spawn is resizable OR can be rotated
-	TArray<int> placingLastZoneBuilt; // The tile array of the last zone to be placed down
+	TArray<int> placingLastZoneBuilt; // The tile array of the last path to be placed down
+	FTT_TileRect placingLastZoneRect; // The tile rectangle of the last zone to be placed down
 	FVector placingBlockTargetLocation; // Target location to lerp to (when placing a building and hovering tiles)
 	FRotator placingBlockTargetRotation = FRotator(0,0,0); // Target rotation to lerp to (when rotating the ghostBlock)
 	float placingBlockMouseX; // X Mouse position at beginning of ghostBlock rotation
@@ -256,7 +293,7 @@ protected:
 	int lastBuildableTileID;
 
 	// Remove tool
-	TArray<int> tilesToBeRemoved;
+	FTT_TileRect tilesToBeRemoved;
 	FTimerHandle TimerHandle_RemoveTool;
 
 	/** Reference to the current GridManager, set by GetGridManager(). */
@@ -297,7 +334,10 @@ protected:
 	bool isRemoveToolSelecting; // Indicates whether the RemoveTool currently has selected tiles to remove or not.
 	int32 currentLinetracedTile; // Tile ID of the current line traced tile, if none returns -1
 	int32 lastLinetracedTile; // Tile ID of the last line traced tile
-	int lastPathGoalTile; // Goal tile ID of the last path that was found
+	int lastPathGoalTile; // Goal tile ID of the last path that was requested
+	FTT_PathRequestHandle pathPreviewRequest; // Road preview request still running, a new goal tile cancels it
+	bool isZonePreviewShown; // Indicates whether the grid already shows the current path, zone or remove selection (cleared with the tile overlays)
+	FTT_TileRect shownZonePreviewRect; // Zone or remove selection shown on the grid while isZonePreviewShown
 
 
 public:	
@@ -0,0 +1,225 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Tile overlays (hover, click, selection, previews, view modes ...) are kept in separate layers instead of being written straight to the tiles.
+	Each layer knows which tiles it touches (chunked membership, only allocated where the layer has tiles) and what it does to them.
+	A tile's final visual is composited from its layers, following the ETileOverlay order, and only for the tiles whose layers changed
+	since the last flush. Nothing is sized after the whole grid: changing or clearing a layer costs the tiles it touches. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_Global.h"
+#include "TT_TileVisualBuffer.h"
+#include "TT_ChunkedTileLayer.h"
+
+/** What a layer does to one of its tiles, each part of the visual can be left to the layers below. */
+struct FTT_TileOverlayValue
+{
+	FLinearColor Colour;
+	float Scale;
+	bool bOverridesColour;
+	bool bOverridesScale;
+
+	FTT_TileOverlayValue()
+		: Colour(FLinearColor::White)
+		, Scale(1.0f)
+		, bOverridesColour(false)
+		, bOverridesScale(false)
+	{
+	}
+
+	static FTT_TileOverlayValue MakeColour(const FLinearColor& colour)
+	{
+		FTT_TileOverlayValue value;
+		value.Colour = colour;
+		value.bOverridesColour = true;
+		return value;
+	}
+
+	static FTT_TileOverlayValue MakeScale(float scale)
+	{
+		FTT_TileOverlayValue value;
+		value.Scale = scale;
+		value.bOverridesScale = true;
+		return value;
+	}
+
+	bool operator==(const FTT_TileOverlayValue& other) const
+	{
+		return bOverridesColour == other.bOverridesColour && bOverridesScale == other.bOverridesScale
+			&& (!bOverridesColour || Colour == other.Colour) && (!bOverridesScale || Scale == other.Scale);
+	}
+
+	bool operator!=(const FTT_TileOverlayValue& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+/** Tiles touched by one overlay layer. */
+class FTT_TileOverlayLayer
+{
+public:
+
+	void Init(const FTT_GridTopology& topology);
+
+	FORCEINLINE bool Contains(int32 tileID) const { return Members[tileID]; }
+
+	/** Returns what the layer does to a tile, nullptr if the tile isn't part of the layer. */
+	FORCEINLINE const FTT_TileOverlayValue* Find(int32 tileID) const { return Members[tileID] ? Values.Find(tileID) : nullptr; }
+
+	/** Adds or updates a tile, returns true if the layer changed. */
+	bool Set(int32 tileID, const FTT_TileOverlayValue& value);
+
+	/** Removes a tile, returns true if it was part of the layer. */
+	bool Remove(int32 tileID);
+
+	/** Removes every tile, only visiting the tiles of the layer. */
+	void Clear();
+
+	const TMap<int32, FTT_TileOverlayValue>& GetValues() const { return Values; }
+
+	int32 Num() const { return Values.Num(); }
+
+	/** Returns true if the layer holds exactly the tiles of GetRect(), all with GetRectValue(). Any change made to a tile since MarkRect() forgets the rectangle. */
+	bool IsRect() const { return bIsRect; }
+
+	const FTT_TileRect& GetRect() const { return Rect; }
+
+	const FTT_TileOverlayValue& GetRectValue() const { return RectValue; }
+
+	/** Records that the layer now holds exactly this rectangle (clipped to the grid), every tile with this value. */
+	void MarkRect(const FTT_TileRect& rect, const FTT_TileOverlayValue& value);
+
+private:
+
+	/** True for the tiles part of the layer, tells most tiles apart without hashing. */
+	TTT_ChunkedTileLayer<bool> Members;
+
+	TMap<int32, FTT_TileOverlayValue> Values;
+
+	/** Rectangle the layer was last filled with, only meaningful while bIsRect is set. */
+	FTT_TileRect Rect;
+
+	FTT_TileOverlayValue RectValue;
+
+	bool bIsRect = false;
+};
+
+class FTT_TileOverlayCompositor
+{
+public:
+
+	/** Sizes every layer for a grid and empties them. */
+	void Init(const FTT_GridTopology& topology);
+
+	bool IsInitialised() const { return NumTiles > 0; }
+
+	/** Adds or updates a tile in a layer. Invalid tiles are ignored. */
+	void SetTile(ETileOverlay layer, int32 tileID, const FTT_TileOverlayValue& value);
+
+	/** Removes a tile from a layer. */
+	void RemoveTile(ETileOverlay layer, int32 tileID);
+
+	/** Removes a tile from every layer but the view mode one. */
+	void ResetTile(int32 tileID);
+
+	/**
+	* Replaces the content of a layer, only the tiles entering, leaving or changing are composited again.
+	* @param layer Layer to replace.
+	* @param tileIDs Tiles the layer will hold (any range of tileIDs, e.g. TArray<int> or FTT_TileRectView).
+	* @param value What the layer does to all of these tiles.
+	*/
+	template<typename TileRangeType>
+	void SetLayerTiles(ETileOverlay layer, const TileRangeType& tileIDs, const FTT_TileOverlayValue& value)
+	{
+		FTT_TileOverlayLayer& overlayLayer = Layers[int32(layer)];
+
+		// Gather the new tiles, then remove the old ones that aren't among them
+		ScratchTiles.Reset();
+		for (int32 tileID : tileIDs)
+		{
+			if (IsTileValid(tileID))
+			{
+				ScratchTiles.Add(tileID);
+			}
+		}
+
+		ScratchTilesLeaving.Reset();
+		for (const TPair<int32, FTT_TileOverlayValue>& tile : overlayLayer.GetValues())
+		{
+			if (!ScratchTiles.Contains(tile.Key))
+			{
+				ScratchTilesLeaving.Add(tile.Key);
+			}
+		}
+
+		for (int32 tileID : ScratchTilesLeaving)
+		{
+			overlayLayer.Remove(tileID);
+			MarkTileDirty(tileID);
+		}
+
+		for (int32 tileID : ScratchTiles)
+		{
+			if (overlayLayer.Set(tileID, value))
+			{
+				MarkTileDirty(tileID);
+			}
+		}
+		ScratchTiles.Reset();
+		ScratchTilesLeaving.Reset();
+	}
+
+	/**
+	* Replaces the content of a layer with a rectangle (clipped to the grid). When the layer was last set with a rectangle,
+	* only the tiles of one rectangle and not the other are visited: an unchanged rectangle costs nothing, a moved corner costs the strips it adds or removes.
+	* @param layer Layer to replace.
+	* @param tileRect Tiles the layer will hold.
+	* @param value What the layer does to all of these tiles.
+	*/
+	void SetLayerTiles(ETileOverlay layer, const FTT_TileRect& tileRect, const FTT_TileOverlayValue& value);
+
+	/** Removes every tile of a layer, costs the number of tiles it had. */
+	void ClearLayer(ETileOverlay layer);
+
+	/** Returns true if the tile is part of the layer. */
+	bool IsTileInLayer(ETileOverlay layer, int32 tileID) const;
+
+	/** Returns what a layer does to a tile, nullptr if the tile isn't part of the layer. */
+	const FTT_TileOverlayValue* FindTile(ETileOverlay layer, int32 tileID) const;
+
+	/** Returns all the tiles of a layer. */
+	TArray<int> GetLayerTiles(ETileOverlay layer) const;
+
+	bool HasDirtyTiles() const { return DirtyTiles.Num() > 0; }
+
+	/** Composites the tiles whose layers changed and records their new visual in the buffer. */
+	void Flush(FTT_TileVisualBuffer& visualBuffer);
+
+private:
+
+	FTT_TileVisual CompositeTile(int32 tileID) const;
+
+	FORCEINLINE void MarkTileDirty(int32 tileID) { DirtyTiles.Add(tileID); }
+
+	FORCEINLINE bool IsTileValid(int32 tileID) const { return tileID >= 0 && tileID < NumTiles; }
+
+	/** Calls visitor on every tile of rect that isn't part of excludedRect, both clipped to the grid. Visits the strips around their intersection, never the intersection itself. */
+	void ForEachTileOutside(const FTT_TileRect& rect, const FTT_TileRect& excludedRect, TFunctionRef<void(int32)> visitor) const;
+
+	FTT_TileOverlayLayer Layers[int32(ETileOverlay::TO_Count)];
+
+	FTT_GridTopology Topology;
+
+	int32 NumTiles = 0;
+
+	/** Tiles to composite on the next flush. */
+	TSet<int32> DirtyTiles;
+
+	/** Tiles given to SetLayerTiles, always emptied after use (its allocation is kept). */
+	TSet<int32> ScratchTiles;
+
+	/** Tiles SetLayerTiles removes from the layer, always emptied after use (its allocation is kept). */
+	TArray<int32> ScratchTilesLeaving;
+};
@@ -0,0 +1,119 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Records the tile visual changes (colour & scale) requested during a frame so they can be pushed to the sprite components once.
+	Writes to the same tile are coalesced, and a tile ending the frame as it is already displayed isn't pushed at all. */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_ChunkedTileLayer.h"
+
+/** What a tile looks like, everything else (location, rotation, sprite) never changes. */
+struct FTT_TileVisual
+{
+	FLinearColor Colour;
+	float Scale;
+
+	FTT_TileVisual()
+		: Colour(FLinearColor::White)
+		, Scale(1.0f)
+	{
+	}
+
+	FTT_TileVisual(const FLinearColor& colour, float scale)
+		: Colour(colour)
+		, Scale(scale)
+	{
+	}
+
+	FORCEINLINE bool operator==(const FTT_TileVisual& other) const
+	{
+		return Colour == other.Colour && Scale == other.Scale;
+	}
+
+	FORCEINLINE bool operator!=(const FTT_TileVisual& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+class FTT_TileVisualBuffer
+{
+public:
+
+	/** Sizes the buffer for a grid, every tile being considered displayed with the default visual. */
+	void Init(const FTT_GridTopology& topology)
+	{
+		AppliedVisuals.Init(topology, FTT_TileVisual());
+		PendingVisuals.Reset();
+	}
+
+	/** Returns what the tile will look like after the next flush. */
+	FTT_TileVisual GetVisual(int32 tileID) const
+	{
+		if (!AppliedVisuals.IsTileValid(tileID))
+		{
+			return FTT_TileVisual();
+		}
+
+		const FTT_TileVisual* pendingVisual = PendingVisuals.Find(tileID);
+		return pendingVisual ? *pendingVisual : AppliedVisuals.Get(tileID);
+	}
+
+	/** Records the tile's new visual, tiles off the grid are ignored. */
+	void SetVisual(int32 tileID, const FTT_TileVisual& visual)
+	{
+		if (AppliedVisuals.IsTileValid(tileID))
+		{
+			PendingVisuals.Add(tileID, visual);
+		}
+	}
+
+	void SetColour(int32 tileID, const FLinearColor& colour)
+	{
+		SetVisual(tileID, FTT_TileVisual(colour, GetVisual(tileID).Scale));
+	}
+
+	void SetScale(int32 tileID, float scale)
+	{
+		SetVisual(tileID, FTT_TileVisual(GetVisual(tileID).Colour, scale));
+	}
+
+	/** Sets the tile back to the default visual (white, scale 1). */
+	void ResetVisual(int32 tileID)
+	{
+		SetVisual(tileID, FTT_TileVisual());
+	}
+
+	bool HasPendingVisuals() const
+	{
+		return PendingVisuals.Num() > 0;
+	}
+
+	/**
+	* Calls applyVisual for every tile whose visual differs from the one displayed, then empties the buffer.
+	* @param applyVisual Pushes the visual to the tile's instance, (tileID, newVisual, previousVisual).
+	*/
+	template<typename FunctorType>
+	void Flush(FunctorType&& applyVisual)
+	{
+		for (const TPair<int32, FTT_TileVisual>& pendingVisual : PendingVisuals)
+		{
+			const FTT_TileVisual previousVisual = AppliedVisuals.Get(pendingVisual.Key);
+			if (previousVisual != pendingVisual.Value)
+			{
+				AppliedVisuals.Set(pendingVisual.Key, pendingVisual.Value);
+				applyVisual(pendingVisual.Key, pendingVisual.Value, previousVisual);
+			}
+		}
+		PendingVisuals.Reset();
+	}
+
+private:
+
+	/** Visual currently displayed by each tile. */
+	TTT_ChunkedTileLayer<FTT_TileVisual> AppliedVisuals;
+
+	/** Latest visual requested for each tile since the last flush. */
+	TMap<int32, FTT_TileVisual> PendingVisuals;
+};
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+	/* Fills a zone with rectangles of a set of sizes (zone buildings), without any overlap.
+	The zone is a local occupancy bitmap (column = X, row = Y, like the grid), tiles already used are never packed.
+	Tiles are scanned row by row, the first free tile found gets the first size (in preference order) that fits there.
+	Each row keeps, for every tile, how many free tiles follow it, so checking a size costs one read per row it covers.
+	The output only depends on the inputs, a zone is always packed the same way.
+	This is the bottom-left rule of skyline packers, applied to the bitmap rather than to a skyline: zones are painted over roads and
+	buildings, and a skyline can't represent the free tiles under them (maximal-rectangles would, but tiles already used split the
+	free space into many overlapping rectangles to keep up to date after each placement). As the sizes are only a few tiles wide,
+	the first size fitting at the lowest, leftmost free tile leaves no more gaps than their best-fit heuristics, in O(tiles * sizes). */
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TT_Global.h"
+
+/** A rectangle placed by the packer, relative to the zone's lowest corner. */
+struct FTT_ZonePlacement
+{
+	FIntPoint Min;
+
+	/** Index of the placed size in the array given to Pack. */
+	int32 SizeIndex;
+};
+
+class FTT_ZonePacker
+{
+public:
+
+	/**
+	* Sizes the zone, every tile starts free.
+	* @param zoneSize Size of the zone in tiles (X columns, Y rows).
+	*/
+	void Init(const FIntPoint& zoneSize);
+
+	/** Marks a tile of the zone as unusable, e.g. owned by a block. */
+	void BlockTile(const FIntPoint& tile);
+
+	bool IsTileFree(const FIntPoint& tile) const;
+
+	/**
+	* Packs the free tiles of the zone.
+	* @param sizes Sizes that can be placed, none of them is rotated.
+	* @param preference Order in which the sizes are tried on each tile.
+	* @param OutPlacements Appended with the placed rectangles, in increasing row then column order.
+	*/
+	void Pack(const TArray<FIntPoint>& sizes, EZonePackingPreference preference, TArray<FTT_ZonePlacement>& OutPlacements);
+
+private:
+
+	FORCEINLINE int32 GetIndex(int32 column, int32 row) const { return row * ZoneSize.X + column; }
+
+	/** True if a rectangle of that size, starting at that tile, only covers free tiles. */
+	bool DoesSizeFit(int32 column, int32 row, const FIntPoint& size) const;
+
+	void BlockRect(int32 column, int32 row, const FIntPoint& size);
+
+	/** Recomputes the free runs of a row, from a column down to the start of its run. */
+	void UpdateFreeRuns(int32 row, int32 fromColumn);
+
+	FIntPoint ZoneSize = FIntPoint::ZeroValue;
+
+	/** For each tile, number of free tiles from it (included) to the next used tile of the row. 0 if the tile is used. */
+	TArray<int32> FreeRuns;
+};